@@ -27,6 +27,7 @@
 #define CASADI_CASADI_COMMON_HPP
 
 #include <casadi/core/casadi_export.h>
+#include <casadi/core/casadi_config.h>
 
 #ifdef casadi_EXPORTS
 #define casadi_implementation
@@ -36,5 +37,13 @@
 #define casadi_implementation
 #endif
 
+// Concurrent construction of expressions, set in casadi_config.h
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <atomic>
+#define CASADI_THREAD_LOCAL thread_local
+#else // WITH_THREADSAFE_SYMBOLICS
+#define CASADI_THREAD_LOCAL
+#endif // WITH_THREADSAFE_SYMBOLICS
+
 #endif // CASADI_CASADI_COMMON_HPP
 
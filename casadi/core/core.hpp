@@ -28,6 +28,7 @@
 
 // Scalar expressions (why do I need to put it up here?)
 #include "sx/sx_elem.hpp"
+#include "sx/sx_arena.hpp"
 
 // Generic tools
 #include "polynomial.hpp"
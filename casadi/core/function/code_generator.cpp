@@ -52,6 +52,9 @@ namespace casadi {
     this->codegen_scalars = false;
     this->with_header = false;
     this->with_mem = false;
+    this->split_size = 0;
+    this->split_files = 0;
+    this->unroll_size = 0;
 
     // Read options
     for (auto&& e : opts) {
@@ -71,6 +74,12 @@ namespace casadi {
         this->with_header = e.second;
       } else if (e.first=="with_mem") {
         this->with_mem = e.second;
+      } else if (e.first=="split_size") {
+        this->split_size = e.second;
+      } else if (e.first=="split_files") {
+        this->split_files = e.second;
+      } else if (e.first=="unroll_size") {
+        this->unroll_size = e.second;
       } else {
         casadi_error("Unrecongnized option: " << e.first);
       }
@@ -192,6 +201,38 @@ namespace casadi {
     // Finalize file
     file_close(s);
 
+    // Additional source files, chunks are divided evenly between the files
+    vector<string> chunk_fname = chunk_files(prefix);
+    for (int k=0; k<chunk_fname.size(); ++k) {
+      file_open(s, chunk_fname[k]);
+      generate_prefix(s);
+      s << this->includes.str() << endl;
+      generate_real_t(s);
+      s << "/* Auxiliary functions defined in " << this->name << this->suffix << " */" << endl
+        << "#if __STDC_VERSION__ < 199901L" << endl
+        << "real_t CASADI_PREFIX(fmin)(real_t x, real_t y);" << endl
+        << "#define fmin(x,y) CASADI_PREFIX(fmin)(x,y)" << endl
+        << "real_t CASADI_PREFIX(fmax)(real_t x, real_t y);" << endl
+        << "#define fmax(x,y) CASADI_PREFIX(fmax)(x,y)" << endl
+        << "#endif" << endl
+        << "real_t CASADI_PREFIX(sq)(real_t x);" << endl
+        << "#define sq(x) CASADI_PREFIX(sq)(x)" << endl
+        << "real_t CASADI_PREFIX(sign)(real_t x);" << endl
+        << "#define sign(x) CASADI_PREFIX(sign)(x)" << endl << endl;
+      int nfiles = chunk_fname.size();
+      for (int i=k*chunks_.size()/nfiles; i<(k+1)*chunks_.size()/nfiles; ++i) {
+        s << chunks_[i] << endl;
+      }
+      file_close(s);
+    }
+
+    // Makefile for parallel compilation of the source files
+    if (!chunk_fname.empty()) {
+      s.open(prefix + this->name + ".mk");
+      generate_makefile(s, prefix);
+      s.close();
+    }
+
     // Generate header
     if (this->with_header) {
       // Create a header file
@@ -209,6 +250,36 @@ namespace casadi {
     return fullname;
   }
 
+  std::vector<std::string> CodeGenerator::chunk_files(const std::string& prefix) const {
+    int nfiles = this->split_files==0 ? chunks_.size() : min<int>(this->split_files,
+                                                                    chunks_.size());
+    vector<string> ret(nfiles);
+    for (int k=0; k<nfiles; ++k) {
+      ret[k] = prefix + this->name + "_" + to_string(k) + this->suffix;
+    }
+    return ret;
+  }
+
+  void CodeGenerator::generate_makefile(std::ostream &s, const std::string& prefix) const {
+    // File names relative to the location of the Makefile
+    string dir = prefix.substr(0, prefix.rfind('/')+1);
+    string obj = this->name + ".o";
+    for (auto&& f : chunk_files(prefix)) {
+      obj += " " + f.substr(dir.size(), f.size()-dir.size()-this->suffix.size()) + ".o";
+    }
+    string cc = this->cpp ? "CXX" : "CC", cflags = this->cpp ? "CXXFLAGS" : "CFLAGS";
+    s << "# Shared library from the generated code, use 'make -f " << this->name
+      << ".mk -j<N>' to compile the files in parallel" << endl
+      << cflags << " ?= -O2" << endl
+      << "OBJ = " << obj << endl << endl
+      << this->name << ".so: $(OBJ)" << endl
+      << "\t$(" << cc << ") -shared $(LDFLAGS) -o $@ $(OBJ) -lm" << endl << endl
+      << "%.o: %" << this->suffix << endl
+      << "\t$(" << cc << ") -fPIC $(" << cflags << ") -c $< -o $@" << endl << endl
+      << "clean:" << endl
+      << "\trm -f " << this->name << ".so $(OBJ)" << endl;
+  }
+
   void CodeGenerator::generate_mex(std::ostream &s) const {
     // Begin conditional compilation
     s << "#ifdef MATLAB_MEX_FILE" << endl;
@@ -273,7 +344,7 @@ namespace casadi {
       << "}" << endl;
   }
 
-  void CodeGenerator::dump(std::ostream& s) const {
+  void CodeGenerator::generate_prefix(std::ostream& s) const {
     // Prefix internal symbols to avoid symbol collisions
     s << "#ifdef CODEGEN_PREFIX" << endl
          << "  #define NAMESPACE_CONCAT(NS, ID) _NAMESPACE_CONCAT(NS, ID)" << endl
@@ -282,6 +353,11 @@ namespace casadi {
          << "#else /* CODEGEN_PREFIX */" << endl
          << "  #define CASADI_PREFIX(ID) " << this->name << "_ ## ID" << endl
          << "#endif /* CODEGEN_PREFIX */" << endl << endl;
+  }
+
+  void CodeGenerator::dump(std::ostream& s) const {
+    // Prefix internal symbols to avoid symbol collisions
+    generate_prefix(s);
 
     s << this->includes.str();
     s << endl;
@@ -333,6 +409,14 @@ namespace casadi {
       s << "#define c" << i << " CASADI_PREFIX(c" << i << ")" << endl;
     }
 
+    // Print static work vectors
+    for (int i=0; i<static_work_.size(); ++i) {
+      name.str(string());
+      name << "CASADI_PREFIX(sw" << i << ")";
+      s << array("static real_t", name.str(), static_work_[i]);
+      s << "#define sw" << i << " CASADI_PREFIX(sw" << i << ")" << endl;
+    }
+
     // Codegen body
     s << this->body.str();
 
@@ -391,6 +475,14 @@ namespace casadi {
     s << array("static const real_t", name, v.size(), initializer(v));
   }
 
+  std::string CodeGenerator::addChunk(const std::string& def) {
+    string fname = "CASADI_PREFIX(chunk" + to_string(chunks_.size()) + ")";
+    string sig = "void " + fname + "(const real_t** arg, real_t** res, real_t* w)";
+    this->auxiliaries << sig << ";" << endl;
+    chunks_.push_back(sig + " {\n" + def + "}\n");
+    return fname;
+  }
+
   void CodeGenerator::addInclude(const std::string& new_include, bool relative_path,
                                  const std::string& use_ifdef) {
     // Register the new element
@@ -532,6 +624,11 @@ namespace casadi {
     }
   }
 
+  std::string CodeGenerator::static_work(int len) {
+    static_work_.push_back(std::max(len, 1));
+    return "sw" + to_string(static_work_.size()-1);
+  }
+
   void CodeGenerator::addAuxiliary(Auxiliary f) {
     // Register the new auxiliary
     bool added = added_auxiliaries_.insert(f).second;
@@ -600,6 +697,11 @@ namespace casadi {
         << codegen_str_norm_inf_define
         << endl;
       break;
+    case AUX_MAX_VIOL:
+      this->auxiliaries << codegen_str_max_viol
+        << codegen_str_max_viol_define
+        << endl;
+      break;
     case AUX_FILL:
       this->auxiliaries
         << codegen_str_fill
@@ -628,6 +730,67 @@ namespace casadi {
         << "#define trans(x, sp_x, y, sp_y, tmp) CASADI_PREFIX(trans)(x, sp_x, y, sp_y, tmp)"
         << endl << endl;
       break;
+    case AUX_MV:
+      this->auxiliaries << codegen_str_mv
+        << codegen_str_mv_define
+        << endl;
+      break;
+    case AUX_LDL:
+      this->auxiliaries
+        << codegen_str_ldl
+        << codegen_str_ldl_define << endl
+        << codegen_str_ldl_solve
+        << codegen_str_ldl_solve_define << endl
+        << endl;
+      break;
+    case AUX_QR:
+      this->auxiliaries
+        << codegen_str_house
+        << codegen_str_house_define << endl
+        << codegen_str_qr
+        << codegen_str_qr_define << endl
+        << codegen_str_qr_solve
+        << codegen_str_qr_solve_define << endl
+        << endl;
+      break;
+    case AUX_LOW:
+      this->auxiliaries
+        << codegen_str_low
+        << codegen_str_low_define << endl
+        << endl;
+      break;
+    case AUX_INTERPN:
+      addAuxiliary(AUX_LOW);
+      this->auxiliaries
+        << codegen_str_flip
+        << codegen_str_flip_define << endl
+        << codegen_str_interpn_weights
+        << codegen_str_interpn_weights_define << endl
+        << codegen_str_interpn_interpolate
+        << codegen_str_interpn_interpolate_define << endl
+        << codegen_str_interpn
+        << codegen_str_interpn_define << endl
+        << endl;
+      break;
+    case AUX_INTERPN_GRAD:
+      addAuxiliary(AUX_FILL);
+      addAuxiliary(AUX_INTERPN);
+      this->auxiliaries
+        << codegen_str_interpn_grad
+        << codegen_str_interpn_grad_define << endl
+        << endl;
+      break;
+    case AUX_BSPLINE:
+      addAuxiliary(AUX_LOW);
+      this->auxiliaries
+        << codegen_str_bspline_basis
+        << codegen_str_bspline_basis_define << endl
+        << codegen_str_bspline_sum
+        << codegen_str_bspline_sum_define << endl
+        << codegen_str_bspline
+        << codegen_str_bspline_define << endl
+        << endl;
+      break;
     case AUX_TO_MEX:
       this->auxiliaries
         << "#ifdef MATLAB_MEX_FILE" << endl
@@ -848,6 +1011,23 @@ namespace casadi {
     // If sparsity match, simple copy
     if (sp_arg==sp_res) return copy(arg, sp_arg.nnz(), res);
 
+    // Straight-line code for small patterns
+    if (sp_res.nnz()<=this->unroll_size) {
+      const int *colind_arg = sp_arg.colind(), *row_arg = sp_arg.row();
+      const int *colind_res = sp_res.colind(), *row_res = sp_res.row();
+      vector<int> ind(sp_arg.size1(), -1);
+      vector<string> stmt;
+      for (int cc=0; cc<sp_res.size2(); ++cc) {
+        for (int k=colind_arg[cc]; k<colind_arg[cc+1]; ++k) ind[row_arg[k]] = k;
+        for (int k=colind_res[cc]; k<colind_res[cc+1]; ++k) {
+          int k_arg = ind[row_res[k]];
+          stmt.push_back(elem(res, k) + " = " + (k_arg<0 ? "0" : elem(arg, k_arg)) + ";");
+        }
+        for (int k=colind_arg[cc]; k<colind_arg[cc+1]; ++k) ind[row_arg[k]] = -1;
+      }
+      return block(stmt);
+    }
+
     // Create call
     addAuxiliary(CodeGenerator::AUX_PROJECT);
     stringstream s;
@@ -925,6 +1105,31 @@ namespace casadi {
                                     const std::string& y, const Sparsity& sp_y,
                                     const std::string& z, const Sparsity& sp_z,
                                     const std::string& w, bool tr) {
+    if (this->unroll_size>0) {
+      // Straight-line code for small patterns
+      string s = mtimes_unrolled(x, sp_x, y, sp_y, z, sp_z, tr);
+      if (!s.empty()) return s;
+
+      // Dense multiplication, one column of z at a time in a local array that
+      // cannot alias x or y, with contiguous, vectorizable inner loops
+      if (!tr && sp_x.is_dense() && sp_y.is_dense() && sp_z.is_dense()) {
+        string nrow = to_string(sp_z.size1()), nk = to_string(sp_x.size2());
+        string z_ij = elem(z, "i+j*" + nrow);
+        return "{\n"
+          "    int i, j, k;\n"
+          "    real_t c[" + nrow + "], t;\n"
+          "    for (j=0; j<" + to_string(sp_z.size2()) + "; ++j) {\n"
+          "      for (i=0; i<" + nrow + "; ++i) c[i] = " + z_ij + ";\n"
+          "      for (k=0; k<" + nk + "; ++k) {\n"
+          "        t = " + elem(y, "k+j*" + nk) + ";\n"
+          "        for (i=0; i<" + nrow + "; ++i) c[i] += " + elem(x, "i+k*" + nrow) + "*t;\n"
+          "      }\n"
+          "      for (i=0; i<" + nrow + "; ++i) " + z_ij + " = c[i];\n"
+          "    }\n"
+          "  }";
+      }
+    }
+
     addAuxiliary(CodeGenerator::AUX_MTIMES);
     stringstream s;
     s << "mtimes(" << x << ", " << sparsity(sp_x) << ", " << y << ", " << sparsity(sp_y) << ", "
@@ -932,4 +1137,113 @@ namespace casadi {
     return s.str();
   }
 
+  std::string CodeGenerator::
+  mtimes_unrolled(const std::string& x, const Sparsity& sp_x,
+                  const std::string& y, const Sparsity& sp_y,
+                  const std::string& z, const Sparsity& sp_z, bool tr) const {
+    const int *colind_x = sp_x.colind(), *row_x = sp_x.row();
+    const int *colind_y = sp_y.colind(), *row_y = sp_y.row();
+    const int *colind_z = sp_z.colind(), *row_z = sp_z.row();
+
+    // Products (nonzero of x, nonzero of y) contributing to each nonzero of z
+    vector<vector<pair<int, int> > > terms(sp_z.nnz());
+    int nterms = 0;
+    if (tr) {
+      // z(r, c) += sum_i x(i, r)*y(i, c)
+      vector<int> ind(sp_y.size1(), -1);
+      for (int cc=0; cc<sp_z.size2(); ++cc) {
+        for (int k=colind_y[cc]; k<colind_y[cc+1]; ++k) ind[row_y[k]] = k;
+        for (int k=colind_z[cc]; k<colind_z[cc+1]; ++k) {
+          int rr = row_z[k];
+          for (int k1=colind_x[rr]; k1<colind_x[rr+1]; ++k1) {
+            int k_y = ind[row_x[k1]];
+            if (k_y>=0) terms[k].push_back(make_pair(k1, k_y));
+          }
+          nterms += terms[k].size();
+          if (nterms>this->unroll_size) return string();
+        }
+        for (int k=colind_y[cc]; k<colind_y[cc+1]; ++k) ind[row_y[k]] = -1;
+      }
+    } else {
+      // z(r, c) += sum_i x(r, i)*y(i, c)
+      vector<int> ind(sp_z.size1(), -1);
+      for (int cc=0; cc<sp_z.size2(); ++cc) {
+        for (int k=colind_z[cc]; k<colind_z[cc+1]; ++k) ind[row_z[k]] = k;
+        for (int k=colind_y[cc]; k<colind_y[cc+1]; ++k) {
+          int ii = row_y[k];
+          for (int k1=colind_x[ii]; k1<colind_x[ii+1]; ++k1) {
+            int k_z = ind[row_x[k1]];
+            if (k_z>=0) {
+              terms[k_z].push_back(make_pair(k1, k));
+              if (++nterms>this->unroll_size) return string();
+            }
+          }
+        }
+        for (int k=colind_z[cc]; k<colind_z[cc+1]; ++k) ind[row_z[k]] = -1;
+      }
+    }
+
+    // One statement for each nonzero of z
+    vector<string> stmt;
+    for (int k=0; k<terms.size(); ++k) {
+      if (terms[k].empty()) continue;
+      stringstream ss;
+      ss << elem(z, k) << " +=";
+      for (int i=0; i<terms[k].size(); ++i) {
+        ss << (i==0 ? " " : "+") << elem(x, terms[k][i].first) << "*"
+           << elem(y, terms[k][i].second);
+      }
+      ss << ";";
+      stmt.push_back(ss.str());
+    }
+    return block(stmt);
+  }
+
+  std::string CodeGenerator::trans(const std::string& x, const Sparsity& sp_x,
+                                   const std::string& y, const Sparsity& sp_y,
+                                   const std::string& iw) {
+    // Straight-line code for small patterns
+    if (sp_x.nnz()<=this->unroll_size) {
+      vector<int> mapping;
+      sp_x.transpose(mapping);
+      vector<string> stmt;
+      for (int k=0; k<mapping.size(); ++k) {
+        stmt.push_back(elem(y, k) + " = " + elem(x, mapping[k]) + ";");
+      }
+      return block(stmt);
+    }
+
+    // Create call
+    addAuxiliary(CodeGenerator::AUX_TRANS);
+    stringstream s;
+    s << "trans(" << x << ", " << sparsity(sp_x) << ", " << y << ", "
+      << sparsity(sp_y) << ", " << iw << ");";
+    return s.str();
+  }
+
+  std::string CodeGenerator::elem(const std::string& x, const std::string& ind) {
+    // Address of a scalar, e.g. "(&w3)"
+    if (x.size()>3 && x.compare(0, 2, "(&")==0 && x[x.size()-1]==')' && ind=="0") {
+      return x.substr(2, x.size()-3);
+    }
+    // Expressions that need parentheses
+    if (x.find_first_of("+-* ")!=string::npos && !(x[0]=='(' && x[x.size()-1]==')')) {
+      return "(" + x + ")[" + ind + "]";
+    }
+    return x + "[" + ind + "]";
+  }
+
+  std::string CodeGenerator::elem(const std::string& x, int ind) {
+    return elem(x, to_string(ind));
+  }
+
+  std::string CodeGenerator::block(const std::vector<std::string>& stmt) {
+    if (stmt.size()==1) return stmt.front();
+    stringstream s;
+    s << "{";
+    for (auto&& e : stmt) s << endl << "    " << e;
+    s << (stmt.empty() ? "" : "\n  ") << "}";
+    return s.str();
+  }
+
 } // namespace casadi
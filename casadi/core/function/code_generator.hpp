@@ -87,12 +87,28 @@ namespace casadi {
     /** \brief Get the index of an existing sparsity pattern */
     int get_sparsity(const Sparsity& sp) const;
 
+    /** \brief Add a function definition to be placed in a separate source file
+        Returns the name of the function, which must have the signature
+        void (const real_t** arg, real_t** res, real_t* w)
+    */
+    std::string addChunk(const std::string& def);
+
+    /** \brief Names of the additional source files written by generate */
+    std::vector<std::string> chunk_files(const std::string& prefix="") const;
+
     /** \brief Get or add a constant */
     int getConstant(const std::vector<double>& v, bool allow_adding=false);
 
     /** \brief Get or add an integer constant */
     int getConstant(const std::vector<int>& v, bool allow_adding=false);
 
+    /** \brief Add a static work vector, returns its name
+     * For work that only the generated code needs, e.g. the factors of a
+     * sparse factorization. The vector is shared by all calls, so a function
+     * using it is not reentrant.
+     */
+    std::string static_work(int len);
+
     /** \brief Use simplified signature */
     static bool simplifiedCall(const Function& f);
 
@@ -143,6 +159,7 @@ namespace casadi {
       AUX_NORM_1,
       AUX_NORM_2,
       AUX_NORM_INF,
+      AUX_MAX_VIOL,
       AUX_IAMAX,
       AUX_FILL,
       AUX_SQ,
@@ -150,6 +167,13 @@ namespace casadi {
       AUX_MTIMES,
       AUX_PROJECT,
       AUX_TRANS,
+      AUX_MV,
+      AUX_LDL,
+      AUX_QR,
+      AUX_LOW,
+      AUX_INTERPN,
+      AUX_INTERPN_GRAD,
+      AUX_BSPLINE,
       AUX_TO_MEX,
       AUX_FROM_MEX
     };
@@ -189,6 +213,10 @@ namespace casadi {
                         const std::string& res, const Sparsity& sp_res,
                         const std::string& w);
 
+    /** \brief Sparse transpose, iw is an integer work vector */
+    std::string trans(const std::string& x, const Sparsity& sp_x,
+                      const std::string& y, const Sparsity& sp_y, const std::string& iw);
+
     /** \brief Create matrix in MATLAB's MEX format */
     std::string to_mex(const Sparsity& sp, const std::string& arg);
 
@@ -218,6 +246,24 @@ namespace casadi {
     // Generate real_t definition
     void generate_real_t(std::ostream &s) const;
 
+    // Generate the definition of CASADI_PREFIX
+    void generate_prefix(std::ostream &s) const;
+
+    // Element of an array expression, e.g. "w3" -> "w3[2]"
+    static std::string elem(const std::string& x, const std::string& ind);
+    static std::string elem(const std::string& x, int ind);
+
+    // Straight-line code from a list of statements
+    static std::string block(const std::vector<std::string>& stmt);
+
+    // Unrolled sparse matrix-matrix multiplication (empty if too large)
+    std::string mtimes_unrolled(const std::string& x, const Sparsity& sp_x,
+                                const std::string& y, const Sparsity& sp_y,
+                                const std::string& z, const Sparsity& sp_z, bool tr) const;
+
+    // Generate a Makefile for the main and the additional source files
+    void generate_makefile(std::ostream &s, const std::string& prefix) const;
+
     // Generate mex entry point
     void generate_mex(std::ostream &s) const;
 
@@ -264,6 +310,28 @@ namespace casadi {
      */
     bool codegen_scalars;
 
+    /** \brief Split large function bodies
+     * Bodies of SX functions with more elementary operations than this
+     * are split into chunks that are placed in separate source files,
+     * allowing parallel compilation. Zero (default) means no splitting.
+     */
+    int split_size;
+
+    /** \brief Number of additional source files for the chunks
+     * Zero (default) means one file per chunk
+     */
+    int split_files;
+
+    /** \brief Specialize sparse kernels to their sparsity patterns
+     * Sparse matrix multiplications, projections and transposes with at most
+     * this many elementary operations are generated as straight-line code
+     * instead of calls to the runtime functions, which interpret the sparsity
+     * patterns at run time. Dense multiplications above this size are generated
+     * as loops with a contiguous, vectorizable inner loop.
+     * Zero (default) means that the runtime functions are always used.
+     */
+    int unroll_size;
+
     // Stringstreams holding the different parts of the file being generated
     std::stringstream includes;
     std::stringstream auxiliaries;
@@ -283,10 +351,16 @@ namespace casadi {
     std::multimap<size_t, size_t> added_double_constants_;
     std::multimap<size_t, size_t> added_integer_constants_;
 
+    // Function definitions for the additional source files
+    std::vector<std::string> chunks_;
+
     // Constants
     std::vector<std::vector<double> > double_constants_;
     std::vector<std::vector<int> > integer_constants_;
 
+    // Lengths of the static work vectors
+    std::vector<int> static_work_;
+
     // Hash a vector
     static size_t hash(const std::vector<double>& v);
     static size_t hash(const std::vector<int>& v);
@@ -37,6 +37,14 @@
 #include <typeinfo>
 #include <fstream>
 #include <cctype>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
 
 using namespace std;
 
@@ -711,6 +719,31 @@ namespace casadi {
     return (*this)->_get_stats(mem);
   }
 
+  Dict Function::profile() const {
+    std::lock_guard<std::mutex> lock((*this)->profile_mtx_);
+    return (*this)->profile_tree_.to_dict();
+  }
+
+  std::string Function::profile_json() const {
+    std::lock_guard<std::mutex> lock((*this)->profile_mtx_);
+    stringstream ss;
+    (*this)->profile_tree_.to_json(ss);
+    return ss.str();
+  }
+
+  void Function::profile_trace(const std::string& fname) const {
+    std::lock_guard<std::mutex> lock((*this)->profile_mtx_);
+    ofstream file(fname.c_str());
+    casadi_assert_message(file.good(), "Function::profile_trace: Cannot open " + fname);
+    casadi::profile_trace(file, (*this)->profile_events_.get());
+  }
+
+  void Function::reset_profile() {
+    std::lock_guard<std::mutex> lock((*this)->profile_mtx_);
+    (*this)->profile_tree_ = ProfileNode();
+    (*this)->profile_events_.clear();
+  }
+
   const Sparsity Function::sparsity_jac(int iind, int oind, bool compact, bool symmetric) {
     return (*this)->sparsity_jac(iind, oind, compact, symmetric);
   }
@@ -1141,6 +1174,75 @@ namespace casadi {
     return (*this)->generate_dependencies(fname, opts);
   }
 
+  // File header of Function::save: magic string, format version and byte order marker
+  static const char FUNCTION_FILE_MAGIC[] = "CASADIFN";
+  static const int FUNCTION_FILE_VERSION = 1;
+  static const int FUNCTION_FILE_BYTE_ORDER = 0x01020304;
+
+  void Function::save(const string& fname) const {
+    Serializer s;
+    s.pack_raw(FUNCTION_FILE_MAGIC, 8);
+    s.pack(FUNCTION_FILE_VERSION);
+    s.pack(FUNCTION_FILE_BYTE_ORDER);
+    s.pack(*this);
+
+    ofstream f(fname, ios::binary);
+    casadi_assert_message(f.good(), "Function::save: Cannot open \"" + fname + "\" for writing");
+    f.write(s.data().data(), s.data().size());
+    casadi_assert_message(f.good(), "Function::save: Failed to write \"" + fname + "\"");
+  }
+
+  /// Deserialize a buffer written by Function::save
+  static Function load_buffer(const char* data, size_t sz, const string& fname) {
+    casadi_assert_message(sz>=8 && memcmp(data, FUNCTION_FILE_MAGIC, 8)==0,
+                          "Function::load: \"" + fname + "\" is not a saved function");
+    Deserializer s(data+8, sz-8);
+    int version, byte_order;
+    s.unpack(version);
+    casadi_assert_message(version==FUNCTION_FILE_VERSION,
+                          "Function::load: \"" + fname + "\" has format version " << version
+                          << ", expected " << FUNCTION_FILE_VERSION);
+    s.unpack(byte_order);
+    casadi_assert_message(byte_order==FUNCTION_FILE_BYTE_ORDER,
+                          "Function::load: \"" + fname + "\" was saved on a platform with "
+                          "a different byte order");
+    Function ret;
+    s.unpack(ret);
+    s.check(s.done(), "trailing data");
+    return ret;
+  }
+
+  Function Function::load(const string& fname) {
+#ifdef _WIN32
+    // Read the whole file
+    ifstream f(fname, ios::binary);
+    casadi_assert_message(f.good(), "Function::load: Cannot open \"" + fname + "\"");
+    string buf((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    return load_buffer(buf.data(), buf.size(), fname);
+#else // _WIN32
+    // Map the file into memory
+    int fd = open(fname.c_str(), O_RDONLY);
+    casadi_assert_message(fd>=0, "Function::load: Cannot open \"" + fname + "\"");
+    struct stat st;
+    if (fstat(fd, &st)!=0 || st.st_size==0) {
+      close(fd);
+      casadi_error("Function::load: \"" + fname + "\" is not a saved function");
+    }
+    size_t sz = st.st_size;
+    void* data = mmap(0, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    casadi_assert_message(data!=MAP_FAILED, "Function::load: Cannot map \"" + fname + "\"");
+    try {
+      Function ret = load_buffer(static_cast<const char*>(data), sz, fname);
+      munmap(data, sz);
+      return ret;
+    } catch (...) {
+      munmap(data, sz);
+      throw;
+    }
+#endif // _WIN32
+  }
+
   void Function::checkInputs() const {
     return (*this)->checkInputs();
   }
@@ -1346,6 +1448,15 @@ namespace casadi {
     (*this)->eval_sx(arg, res, iw, w, mem);
   }
 
+  void Function::eval_batch(const double** arg, double** res, int* iw, double* w, int n,
+                            int mem) const {
+    (*this)->eval_batch((*this)->memory(mem), arg, res, iw, w, n);
+  }
+
+  bool Function::has_eval_batch() const {
+    return (*this)->has_eval_batch();
+  }
+
   const SX Function::sx_in(int ind) const {
     return (*this)->sx_in(ind);
   }
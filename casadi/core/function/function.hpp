@@ -538,6 +538,17 @@ namespace casadi {
     /** \brief  Propagate sparsity forward */
     void operator()(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem=0) const;
 
+    /** \brief Evaluate numerically for a batch of \a n points
+        The nonzeros of input/output i for point k start at offset k*nnz_in(i)
+        and k*nnz_out(i) respectively, i.e. the same layout as for map.
+        The work vector must have room for n*sz_w() elements.
+     */
+    void eval_batch(const double** arg, double** res, int* iw, double* w, int n,
+                    int mem=0) const;
+
+    /** \brief Is batched evaluation supported? */
+    bool has_eval_batch() const;
+
     /** \brief  Propagate sparsity backward */
     void rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem=0);
 
@@ -593,7 +604,7 @@ namespace casadi {
 #endif // WITH_DEPRECATED_FEATURES
 
     /** \brief  Evaluate symbolically in parallel and sum (matrix graph)
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread|simd
     */
     std::vector<MX> mapsum(const std::vector<MX > &arg,
                            const std::string& parallelization="serial");
@@ -658,7 +669,7 @@ namespace casadi {
                 s_(N-1) <- f(a_(N-1), p_(N-1))
         \endverbatim
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread|simd
     */
     Function map(int n, const std::string& parallelization="serial");
 
@@ -789,6 +800,23 @@ namespace casadi {
     /** \brief Export / Generate C code for the dependency function */
     std::string generate_dependencies(const std::string& fname, const Dict& opts=Dict());
 
+    /** \brief Save the function to a file in a compact binary format
+
+        Supported are SX and MX functions and NLP solvers, including the derivative
+        functions the solver has created, as well as functions called by them.
+        Nested functions occurring several times are stored once. The format is
+        versioned and uses the byte order of the current platform.
+    */
+    void save(const std::string& fname) const;
+
+    /** \brief Load a function saved with save
+
+        The file is memory mapped where supported. For SX functions, the
+        evaluation algorithm is restored as is, without sorting the expression
+        graph again.
+    */
+    static Function load(const std::string& fname);
+
 #ifndef SWIG
     /// \cond INTERNAL
     /// Get a const pointer to the node
@@ -813,6 +841,26 @@ namespace casadi {
     /// Get all statistics obtained at the end of the last evaluate call
     Dict stats(int mem=0) const;
 
+    ///@{
+    /** \brief Get profiling results, requires the option "profile"
+     *
+     * Calls of the function and of all functions it calls numerically are
+     * accumulated in a tree with the number of calls, wall and proc time [s]
+     * and work memory [bytes] for each function.
+     */
+    Dict profile() const;
+    std::string profile_json() const;
+    ///@}
+
+    /** \brief Write the profiled calls in Chrome trace event format
+     *
+     * Only the most recent calls are kept, see the option "profile_max_events".
+     */
+    void profile_trace(const std::string& fname) const;
+
+    /** \brief Clear the profiling results */
+    void reset_profile();
+
     ///@{
     /** \brief Get symbolic primitives equivalent to the input expressions
      * There is no guarantee that subsequent calls return unique answers
@@ -36,6 +36,9 @@
 #include <ctime>
 #endif // WITH_DL
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <functional>
 
 using namespace std;
 
@@ -73,6 +76,9 @@ namespace casadi {
     regularity_check_ = false;
     inputs_check_ = true;
     jit_ = false;
+    profile_ = false;
+    profile_max_events_ = 100000;
+    sparsity_stats_ = false;
     compilerplugin_ = "clang";
 
     eval_ = 0;
@@ -172,6 +178,10 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_codegen_options",
+       {OT_DICT,
+        "Options to be passed to the code generator when using the jit compiler, "
+        "e.g. 'split_size' for compiling large functions in parallel."}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -183,7 +193,20 @@ namespace casadi {
         " Overrules the builtin optimized_num_dir."}},
       {"print_time",
        {OT_BOOL,
-        "print information about execution time"}}
+        "print information about execution time"}},
+      {"profile",
+       {OT_BOOL,
+        "Record the number of calls, the execution time and the work memory "
+        "of this function and of all functions it calls numerically"}},
+      {"profile_max_events",
+       {OT_INT,
+        "Maximum number of calls kept for profile_trace [default: 100000]. "
+        "When exceeded, the oldest calls are dropped. The accumulated "
+        "statistics returned by profile are not affected"}},
+      {"sparsity_stats",
+       {OT_BOOL,
+        "Add the number of calls and the time spent in Jacobian sparsity "
+        "propagation and graph coloring to the statistics [default: false]"}}
      }
   };
 
@@ -214,6 +237,8 @@ namespace casadi {
         compilerplugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_codegen_options") {
+        jit_codegen_options_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
@@ -224,9 +249,20 @@ namespace casadi {
         max_num_dir_ = op.second;
       } else if (op.first=="print_time") {
         print_time_ = op.second;
+      } else if (op.first=="profile") {
+        profile_ = op.second;
+      } else if (op.first=="profile_max_events") {
+        profile_max_events_ = op.second;
+      } else if (op.first=="sparsity_stats") {
+        sparsity_stats_ = op.second;
       }
     }
 
+    // Bound the memory used for tracing
+    casadi_assert_message(profile_max_events_>=0,
+                          "Option \"profile_max_events\" must be nonnegative");
+    profile_events_.max_size = profile_max_events_;
+
     // Get the number of inputs and outputs
     isp_.resize(get_n_in());
     osp_.resize(get_n_out());
@@ -285,11 +321,11 @@ namespace casadi {
         if (verbose())
           log("FunctionInternal::finalize", "Codegenerating function '" + name() + "'.");
         // JIT everything
-        CodeGenerator gen(jit_name);
+        CodeGenerator gen(jit_name, jit_codegen_options_);
         gen.add(self());
         if (verbose())
           log("FunctionInternal::finalize", "Compiling function '" + name() + "'..");
-        compiler_ = Importer(gen.generate(), compilerplugin_, jit_options_);
+        compiler_ = jit_compile(gen);
         if (verbose())
           log("FunctionInternal::finalize", "Compiling function '" + name() + "' done.");
         // Try to load with simplified syntax
@@ -305,13 +341,74 @@ namespace casadi {
       }
     }
 
-    // Create memory object
+    // Create memory object, available to the first caller
     int mem = checkout();
     casadi_assert(mem==0);
+    release(mem);
   }
 
+  // Profiling state of the calling thread
+  static thread_local ProfileNode* profile_node = 0;
+  static thread_local ProfileEvents* profile_events = 0;
+
+  // Index of the calling thread, for tracing
+  static std::atomic<int> profile_n_thread(0);
+  static thread_local int profile_tid = profile_n_thread++;
+
   void FunctionInternal::
   _eval(const double** arg, double** res, int* iw, double* w, int mem) {
+    // Record the call if this function or a calling function is profiled
+    if (profile_ || profile_node) return _eval_profiled(arg, res, iw, w, mem);
+    _eval_direct(arg, res, iw, w, mem);
+  }
+
+  void FunctionInternal::
+  _eval_profiled(const double** arg, double** res, int* iw, double* w, int mem) {
+    // A call that is not nested in a profiled call starts a new tree
+    ProfileNode root(name_, type_name());
+    ProfileEvents events(profile_max_events_);
+    bool is_root = profile_node==0;
+    ProfileNode* node = is_root ? &root : &profile_node->child(name_, type_name());
+    if (is_root) profile_events = &events;
+    node->w_bytes = sz_arg()*sizeof(double*) + sz_res()*sizeof(double*)
+      + sz_iw()*sizeof(int) + sz_w()*sizeof(double);
+    node->flops = n_flops();
+
+    // Evaluate with this function as the parent of nested calls
+    ProfileNode* parent = profile_node;
+    profile_node = node;
+    FStats fstats;
+    double ts = profile_clock();
+    fstats.tic();
+    try {
+      _eval_direct(arg, res, iw, w, mem);
+    } catch (...) {
+      profile_node = parent;
+      if (is_root) profile_events = 0;
+      throw;
+    }
+    fstats.toc();
+    profile_node = parent;
+
+    // Accumulate
+    node->n_call += fstats.n_call;
+    node->t_wall += fstats.t_wall;
+    node->t_proc += fstats.t_proc;
+    profile_events->push({name_, ts, profile_clock()-ts, profile_tid});
+
+    // Store the tree
+    if (is_root) {
+      profile_events = 0;
+      std::lock_guard<std::mutex> lock(profile_mtx_);
+      profile_tree_.name = name_;
+      profile_tree_.type = type_name();
+      profile_tree_.merge(root);
+      profile_events_.append(events);
+    }
+  }
+
+  void FunctionInternal::
+  _eval_direct(const double** arg, double** res, int* iw, double* w, int mem) {
     if (simplifiedCall()) {
       // Copy arguments to input buffers
       const double* arg1=w;
@@ -412,9 +509,23 @@ namespace casadi {
     opts["jit"] = jit_;
     opts["compiler"] = compilerplugin_;
     opts["jit_options"] = jit_options_;
+    opts["jit_codegen_options"] = jit_codegen_options_;
     return opts;
   }
 
+  Importer FunctionInternal::jit_compile(const CodeGenerator& gen) const {
+    string fname = gen.generate();
+
+    // Source files with the chunks of split function bodies
+    vector<string> sources = gen.chunk_files();
+    if (sources.empty()) return Importer(fname, compilerplugin_, jit_options_);
+    casadi_assert_message(compilerplugin_=="shell",
+                          "Split code generation requires the 'shell' jit compiler");
+    Dict opts = jit_options_;
+    opts["sources"] = sources;
+    return Importer(fname, compilerplugin_, opts);
+  }
+
   Function FunctionInternal::tangent(int iind, int oind) {
     // Assert scalar
     casadi_assert_message(sparsity_in(iind).is_scalar(),
@@ -533,22 +644,68 @@ namespace casadi {
   }
   /// \endcond
 
-  // Traits
-  template<bool fwd> struct JacSparsityTraits {};
-  template<> struct JacSparsityTraits<true> {
-    typedef const bvec_t* arg_t;
-    static inline void sp(FunctionInternal *f, const bvec_t** arg, bvec_t** res,
-                          int* iw, bvec_t* w, int mem) {
-      f->sp_fwd(arg, res, iw, w, mem);
-    }
-  };
-  template<> struct JacSparsityTraits<false> {
-    typedef bvec_t* arg_t;
-    static inline void sp(FunctionInternal *f, bvec_t** arg, bvec_t** res,
-                          int* iw, bvec_t* w, int mem) {
-      f->sp_rev(arg, res, iw, w, mem);
+  void FunctionInternal::sp_sweeps(bool fwd, int iind, int oind, int n,
+                                   bvec_t* seed, bvec_t* sens) {
+    // Number of seeds and sensitivities per sweep
+    int nz_seed = fwd ? nnz_in(iind) : nnz_out(oind);
+    int nz_sens = fwd ? nnz_out(oind) : nnz_in(iind);
+
+    // Number of threads
+    int n_threads = std::max(1, std::min(n, GlobalOptions::sparsity_num_threads));
+
+    // Evaluation buffers, one set per thread
+    vector<vector<const bvec_t*> > arg_fwd(n_threads, vector<const bvec_t*>(sz_arg(), 0));
+    vector<vector<bvec_t*> > arg_adj(n_threads, vector<bvec_t*>(sz_arg(), 0));
+    vector<vector<bvec_t*> > res(n_threads, vector<bvec_t*>(sz_res(), 0));
+    vector<vector<int> > iw(n_threads, vector<int>(sz_iw()));
+    vector<vector<bvec_t> > w(n_threads, vector<bvec_t>(sz_w()));
+
+    // Propagate the dependencies for sweep k on thread t
+    std::function<void(int, int)> sweep([&](int t, int k) {
+      bvec_t* seed_k = seed + k*nz_seed;
+      bvec_t* sens_k = sens + k*nz_sens;
+      fill_n(sens_k, nz_sens, 0);
+      if (fwd) {
+        arg_fwd[t][iind] = seed_k;
+        res[t][oind] = sens_k;
+        sp_fwd(get_ptr(arg_fwd[t]), get_ptr(res[t]), get_ptr(iw[t]), get_ptr(w[t]), 0);
+      } else {
+        arg_adj[t][iind] = sens_k;
+        res[t][oind] = seed_k;
+        fill(w[t].begin(), w[t].end(), 0);
+        sp_rev(get_ptr(arg_adj[t]), get_ptr(res[t]), get_ptr(iw[t]), get_ptr(w[t]), 0);
+      }
+    });
+
+    // Serial propagation
+    if (n_threads==1) {
+      for (int k=0; k<n; ++k) sweep(0, k);
+      return;
     }
-  };
+
+    // Sweeps are claimed one at a time, exceptions are passed on to the calling thread
+    std::atomic<int> next(0);
+    std::vector<std::exception_ptr> err(n_threads);
+    std::function<void(int)> work([&](int t) {
+      try {
+        for (int k=next++; k<n; k=next++) sweep(t, k);
+      } catch (...) {
+        err[t] = std::current_exception();
+        // Stop the other workers
+        next = n;
+      }
+    });
+
+    // Launch the workers, the calling thread acts as the first one
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads-1);
+    for (int t=1; t<n_threads; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto&& th : workers) th.join();
+
+    // Rethrow the first exception, if any
+    for (auto&& e : err) if (e) std::rethrow_exception(e);
+  }
 
   template<bool fwd>
   Sparsity FunctionInternal::getJacSparsityGen(int iind, int oind,
@@ -557,27 +714,24 @@ namespace casadi {
     int nz_in = nnz_in(iind);
     int nz_out = nnz_out(oind);
 
-    // Evaluation buffers
-    vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), 0);
-    vector<bvec_t*> res(sz_res(), 0);
-    vector<int> iw(sz_iw());
-    vector<bvec_t> w(sz_w(), 0);
-
-    // Seeds and sensitivities
-    vector<bvec_t> seed(nz_in, 0);
-    arg[iind] = get_ptr(seed);
-    vector<bvec_t> sens(nz_out, 0);
-    res[oind] = get_ptr(sens);
-    if (!fwd) std::swap(seed, sens);
+    // Number of seeds and sensitivities
+    int nz_seed = fwd ? nz_in : nz_out;
+    int nz_sens = fwd ? nz_out : nz_in;
 
     // Number of forward sweeps we must make
-    int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    int nsweep = nz_seed / bvec_size;
+    if (nz_seed % bvec_size) nsweep++;
+
+    // Sweeps are made in batches, one per thread
+    int batch = std::max(1, std::min(nsweep, GlobalOptions::sparsity_num_threads));
+
+    // Seeds and sensitivities for each sweep in the batch
+    vector<bvec_t> seed(batch*nz_seed, 0), sens(batch*nz_sens, 0);
 
     // Print
     if (verbose()) {
       userOut() << "FunctionInternal::getJacSparsityGen<" << fwd << ">: "
-                << nsweep << " sweeps needed for " << seed.size() << " directions" << endl;
+                << nsweep << " sweeps needed for " << nz_seed << " directions" << endl;
     }
 
     // Progress
@@ -586,12 +740,12 @@ namespace casadi {
     // Temporary vectors
     std::vector<int> jcol, jrow;
 
-    // Loop over the variables, bvec_size variables at a time
-    for (int s=0; s<nsweep; ++s) {
+    // Loop over the variables, batch*bvec_size variables at a time
+    for (int s0=0; s0<nsweep; s0+=batch) {
 
       // Print progress
       if (verbose()) {
-        int progress_new = (s*100)/nsweep;
+        int progress_new = (s0*100)/nsweep;
         // Print when entering a new decade
         if (progress_new / 10 > progress / 10) {
           progress = progress_new;
@@ -599,51 +753,51 @@ namespace casadi {
         }
       }
 
-      // Nonzero offset
-      int offset = s*bvec_size;
-
-      // Number of local seed directions
-      int ndir_local = seed.size()-offset;
-      ndir_local = std::min(bvec_size, ndir_local);
-
-      for (int i=0; i<ndir_local; ++i) {
-        seed[offset+i] |= bvec_t(1)<<i;
+      // Number of sweeps in this batch
+      int nb = std::min(batch, nsweep-s0);
+
+      // Set the seeds, bvec_size directions per sweep
+      for (int b=0; b<nb; ++b) {
+        bvec_t* seed_b = get_ptr(seed) + b*nz_seed;
+        fill_n(seed_b, nz_seed, 0);
+        int offset = (s0+b)*bvec_size;
+        int ndir_local = std::min(bvec_size, nz_seed-offset);
+        for (int i=0; i<ndir_local; ++i) {
+          seed_b[offset+i] |= bvec_t(1)<<i;
+        }
       }
 
       // Propagate the dependencies
-      JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
+      sp_sweeps(fwd, iind, oind, nb, get_ptr(seed), get_ptr(sens));
 
-      // Loop over the nonzeros of the output
-      for (int el=0; el<sens.size(); ++el) {
+      // Collect the dependencies
+      for (int b=0; b<nb; ++b) {
+        const bvec_t* sens_b = get_ptr(sens) + b*nz_sens;
+        int offset = (s0+b)*bvec_size;
+        int ndir_local = std::min(bvec_size, nz_seed-offset);
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens[el];
+        // Loop over the nonzeros of the output
+        for (int el=0; el<nz_sens; ++el) {
 
-        if (!fwd) {
-          // Clear the sensitivities for the next sweep
-          sens[el] = 0;
-        }
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens_b[el];
 
-        // If there is a dependency in any of the directions
-        if (spsens!=0) {
+          // If there is a dependency in any of the directions
+          if (spsens!=0) {
 
-          // Loop over seed directions
-          for (int i=0; i<ndir_local; ++i) {
+            // Loop over seed directions
+            for (int i=0; i<ndir_local; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol.push_back(el);
+                jrow.push_back(i+offset);
+              }
             }
           }
         }
       }
-
-      // Remove the seeds
-      for (int i=0; i<ndir_local; ++i) {
-        seed[offset+i] = 0;
-      }
     }
 
     // Construct sparsity pattern and return
@@ -662,19 +816,11 @@ namespace casadi {
     int nz = nnz_in(iind);
     casadi_assert(nz==nnz_out(oind));
 
-    // Evaluation buffers
-    vector<const bvec_t*> arg(sz_arg(), 0);
-    vector<bvec_t*> res(sz_res(), 0);
-    vector<int> iw(sz_iw());
-    vector<bvec_t> w(sz_w());
-
-    // Seeds
-    vector<bvec_t> seed(nz, 0);
-    arg[iind] = get_ptr(seed);
+    // Sweeps are collected and propagated in batches, one per thread
+    int batch = std::max(1, GlobalOptions::sparsity_num_threads);
 
-    // Sensitivities
-    vector<bvec_t> sens(nz, 0);
-    res[oind] = get_ptr(sens);
+    // Seeds and sensitivities for each sweep in the batch
+    vector<bvec_t> seed(batch*nz, 0), sens(batch*nz, 0);
 
     // Sparsity triplet accumulator
     std::vector<int> jcol, jrow;
@@ -732,6 +878,55 @@ namespace casadi {
       // Create lookup tables for the fine blocks
       std::vector<int> fine_lookup = lookupvector(fine, nz+1);
 
+      // Lookup tables and seeds of the pending sweeps
+      std::vector<IM> lookups;
+      bvec_t* seed_v = get_ptr(seed);
+
+      // Propagate the pending sweeps and collect the dependencies
+      std::function<void()> flush([&]() {
+        int njob = lookups.size();
+        sp_sweeps(true, iind, oind, njob, get_ptr(seed), get_ptr(sens));
+
+        // Temporary bit work vector
+        bvec_t spsens;
+
+        for (int b=0; b<njob; ++b) {
+          const IM& lookup = lookups[b];
+          bvec_t* sens_b = get_ptr(sens) + b*nz;
+
+          // Loop over the cols of coarse blocks
+          for (int cri=0; cri<coarse.size()-1; ++cri) {
+
+            // Loop over the cols of fine blocks within the current coarse block
+            for (int fri=fine_lookup[coarse[cri]];fri<fine_lookup[coarse[cri+1]];++fri) {
+              // Lump individual sensitivities together into fine block
+              bvec_or(sens_b, spsens, fine[fri], fine[fri+1]);
+
+              // Loop over all bvec_bits
+              for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                if (spsens & (bvec_t(1) << bvec_i)) {
+                  // if dependency is found, add it to the new sparsity pattern
+                  int ind = lookup.sparsity().get_nz(bvec_i, cri);
+                  if (ind==-1) continue;
+                  int lk = lookup->at(ind);
+                  if (lk>-bvec_size) {
+                    jrow.push_back(bvec_i+lk);
+                    jcol.push_back(fri);
+                    jrow.push_back(fri);
+                    jcol.push_back(bvec_i+lk);
+                  }
+                }
+              }
+            }
+          }
+        }
+
+        // Clear the forward seeds, ready for the next batch
+        fill(seed.begin(), seed.end(), 0);
+        lookups.clear();
+        seed_v = get_ptr(seed);
+      });
+
       // Triplet data used as a lookup table
       std::vector<int> lookup_col;
       std::vector<int> lookup_row;
@@ -778,7 +973,7 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(get_ptr(seed), fine[fci+fci_start], fine[fci+fci_start+1],
+              bvec_toggle(seed_v, fine[fci+fci_start], fine[fci+fci_start+1],
                           bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
@@ -807,41 +1002,14 @@ namespace casadi {
             duplicates = sparsify(duplicates);
             lookup(duplicates.sparsity()) = -bvec_size;
 
-            // Propagate the dependencies
-            sp_fwd(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
-
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (int cri=0; cri<coarse.size()-1; ++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (int fri=fine_lookup[coarse[cri]];fri<fine_lookup[coarse[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(get_ptr(sens), spsens, fine[fri], fine[fri+1]);
-
-                // Loop over all bvec_bits
-                for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & (bvec_t(1) << bvec_i)) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    int lk = lookup->at(ind);
-                    if (lk>-bvec_size) {
-                      jrow.push_back(bvec_i+lk);
-                      jcol.push_back(fri);
-                      jrow.push_back(fri);
-                      jcol.push_back(bvec_i+lk);
-                    }
-                  }
-                }
-              }
+            // Propagate with the next batch
+            lookups.push_back(lookup);
+            if (lookups.size()==static_cast<size_t>(batch)) {
+              flush();
+            } else {
+              seed_v = get_ptr(seed) + lookups.size()*nz;
             }
 
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            fill(seed.begin(), seed.end(), 0);
-
             // Clean lookup table
             lookup_col.clear();
             lookup_row.clear();
@@ -858,6 +1026,9 @@ namespace casadi {
         }
       }
 
+      // Propagate the remaining sweeps
+      if (!lookups.empty()) flush();
+
       // Construct fine sparsity pattern
       r = Sparsity::triplet(fine.size()-1, fine.size()-1, jrow, jcol);
 
@@ -885,18 +1056,12 @@ namespace casadi {
     // Number of nonzero outputs
     int nz_out = nnz_out(oind);
 
-    // Seeds and sensitivities
-    vector<bvec_t> s_in(nz_in, 0);
-    vector<bvec_t> s_out(nz_out, 0);
+    // Sweeps are collected and propagated in batches, one per thread
+    int batch = std::max(1, GlobalOptions::sparsity_num_threads);
 
-    // Evaluation buffers
-    vector<const bvec_t*> arg_fwd(sz_arg(), 0);
-    vector<bvec_t*> arg_adj(sz_arg(), 0);
-    arg_fwd[iind] = arg_adj[iind] = get_ptr(s_in);
-    vector<bvec_t*> res(sz_res(), 0);
-    res[oind] = get_ptr(s_out);
-    vector<int> iw(sz_iw());
-    vector<bvec_t> w(sz_w());
+    // Seeds and sensitivities for each sweep in the batch
+    vector<bvec_t> seed(batch*std::max(nz_in, nz_out), 0);
+    vector<bvec_t> sens(batch*std::max(nz_in, nz_out), 0);
 
     // Sparsity triplet accumulator
     std::vector<int> jcol, jrow;
@@ -976,16 +1141,12 @@ namespace casadi {
                    << (1-sp_w)*D2.size2()*adj_cost << ")");
       }
 
-      // Get seeds and sensitivities
-      bvec_t* seed_v = use_fwd ? get_ptr(s_in) : get_ptr(s_out);
-      bvec_t* sens_v = use_fwd ? get_ptr(s_out) : get_ptr(s_in);
-
       // The number of zeros in the seed and sensitivity directions
       int nz_seed = use_fwd ? nz_in  : nz_out;
       int nz_sens = use_fwd ? nz_out : nz_in;
 
       // Clear the seeds
-      for (int i=0; i<nz_seed; ++i) seed_v[i]=0;
+      fill(seed.begin(), seed.end(), 0);
 
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
@@ -1026,6 +1187,54 @@ namespace casadi {
       std::vector<int> fine_col_lookup = lookupvector(fine_col, nz_sens+1);
       std::vector<int> fine_row_lookup = lookupvector(fine_row, nz_seed+1);
 
+      // Lookup tables and seeds of the pending sweeps
+      std::vector<IM> lookups;
+      bvec_t* seed_v = get_ptr(seed);
+
+      // Propagate the pending sweeps and collect the dependencies
+      std::function<void()> flush([&]() {
+        int njob = lookups.size();
+        sp_sweeps(use_fwd, iind, oind, njob, get_ptr(seed), get_ptr(sens));
+
+        // Temporary bit work vector
+        bvec_t spsens;
+
+        for (int b=0; b<njob; ++b) {
+          const IM& lookup = lookups[b];
+          bvec_t* sens_b = get_ptr(sens) + b*nz_sens;
+
+          // Loop over the cols of coarse blocks
+          for (int cri=0;cri<coarse_col.size()-1;++cri) {
+
+            // Loop over the cols of fine blocks within the current coarse block
+            for (int fri=fine_col_lookup[coarse_col[cri]];
+                 fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
+              // Lump individual sensitivities together into fine block
+              bvec_or(sens_b, spsens, fine_col[fri], fine_col[fri+1]);
+
+              // Next iteration if no sparsity
+              if (!spsens) continue;
+
+              // Loop over all bvec_bits
+              for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                if (spsens & bvec_lookup[bvec_i]) {
+                  // if dependency is found, add it to the new sparsity pattern
+                  int ind = lookup.sparsity().get_nz(bvec_i, cri);
+                  if (ind==-1) continue;
+                  jrow.push_back(bvec_i+lookup->at(ind));
+                  jcol.push_back(fri);
+                }
+              }
+            }
+          }
+        }
+
+        // Clear the seeds, ready for the next batch
+        fill(seed.begin(), seed.end(), 0);
+        lookups.clear();
+        seed_v = get_ptr(seed);
+      });
+
       // Triplet data used as a lookup table
       std::vector<int> lookup_col;
       std::vector<int> lookup_row;
@@ -1091,48 +1300,14 @@ namespace casadi {
             IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
                                     coarse_col.size());
 
-            // Propagate the dependencies
-            if (use_fwd) {
-              sp_fwd(get_ptr(arg_fwd), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
+            // Propagate with the next batch
+            lookups.push_back(lookup);
+            if (lookups.size()==static_cast<size_t>(batch)) {
+              flush();
             } else {
-              fill(w.begin(), w.end(), 0);
-              sp_rev(get_ptr(arg_adj), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
+              seed_v = get_ptr(seed) + lookups.size()*nz_seed;
             }
 
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (int cri=0;cri<coarse_col.size()-1;++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (int fri=fine_col_lookup[coarse_col[cri]];
-                   fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
-
-                // Next iteration if no sparsity
-                if (!spsens) continue;
-
-                // Loop over all bvec_bits
-                for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    jrow.push_back(bvec_i+lookup->at(ind));
-                    jcol.push_back(fri);
-                  }
-                }
-              }
-            }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            fill(s_in.begin(), s_in.end(), 0);
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            fill(s_out.begin(), s_out.end(), 0);
-
             // Clean lookup table
             lookup_col.clear();
             lookup_row.clear();
@@ -1151,6 +1326,9 @@ namespace casadi {
 
       }
 
+      // Propagate the remaining sweeps
+      if (!lookups.empty()) flush();
+
       // Swap results if adjoint mode was used
       if (use_fwd) {
         // Construct fine sparsity pattern
@@ -1175,6 +1353,14 @@ namespace casadi {
   Sparsity FunctionInternal::getJacSparsity(int iind, int oind, bool symmetric) {
     // Check if we are able to propagate dependencies through the function
     if (has_spfwd() || has_sprev()) {
+      // Form the Jacobian sparsity patterns of nested functions before propagating in parallel
+      if (GlobalOptions::sparsity_num_threads>1) {
+        vector<bvec_t> seed(max(nnz_in(iind), nnz_out(oind)), 0);
+        vector<bvec_t> sens(max(nnz_in(iind), nnz_out(oind)), 0);
+        if (has_spfwd()) sp_sweeps(true, iind, oind, 1, get_ptr(seed), get_ptr(sens));
+        if (has_sprev()) sp_sweeps(false, iind, oind, 1, get_ptr(seed), get_ptr(sens));
+      }
+
       Sparsity sp;
       if (nnz_in(iind)>3*bvec_size && nnz_out(oind)>3*bvec_size &&
             GlobalOptions::hierarchical_sparsity) {
@@ -1227,6 +1413,11 @@ namespace casadi {
   }
 
   Sparsity& FunctionInternal::sparsity_jac(int iind, int oind, bool compact, bool symmetric) {
+    // Return the block directly if already available, avoids touching the reference counter
+    Sparsity& jsp_cached = compact ? jac_sparsity_compact_.elem(oind, iind)
+        : jac_sparsity_.elem(oind, iind);
+    if (!jsp_cached.is_null()) return jsp_cached;
+
     // Get an owning reference to the block
     Sparsity jsp = compact ? jac_sparsity_compact_.elem(oind, iind)
         : jac_sparsity_.elem(oind, iind);
@@ -1236,7 +1427,9 @@ namespace casadi {
       if (compact) {
 
         // Use internal routine to determine sparsity
+        jac_sparsity_stats_.tic();
         jsp = getJacSparsity(iind, oind, symmetric);
+        jac_sparsity_stats_.toc();
 
       } else {
 
@@ -1291,6 +1484,7 @@ namespace casadi {
     Sparsity A = symmetric ? AT : AT.T();
 
     // Get seed matrices by graph coloring
+    coloring_stats_.tic();
     if (symmetric) {
       casadi_assert(get_n_forward()>0);
 
@@ -1360,14 +1554,36 @@ namespace casadi {
       }
 
     }
+    coloring_stats_.toc();
     log("FunctionInternal::getPartition end");
   }
 
+  Dict FunctionInternal::_get_stats(int mem) const {
+    Dict stats = get_stats(memory(mem));
+
+    // Add timing statistics for sparsity pattern propagation and graph coloring
+    if (sparsity_stats_) {
+      std::map<std::string, const FStats*> fstats = {{"jac_sparsity", &jac_sparsity_stats_},
+                                                     {"coloring", &coloring_stats_}};
+      for (auto&& s : fstats) {
+        stats["n_call_" + s.first] = s.second->n_call;
+        stats["t_wall_" + s.first] = s.second->t_wall;
+        stats["t_proc_" + s.first] = s.second->t_proc;
+      }
+    }
+    return stats;
+  }
+
   void FunctionInternal::eval(void* mem,
                               const double** arg, double** res, int* iw, double* w) const {
     casadi_error("'eval' not defined for " + type_name());
   }
 
+  void FunctionInternal::eval_batch(void* mem, const double** arg, double** res,
+                                    int* iw, double* w, int n) const {
+    casadi_error("'eval_batch' not defined for " + type_name());
+  }
+
   void FunctionInternal::simple(const double* arg, double* res) {
     casadi_error("'simple' not defined for " + type_name());
   }
@@ -2087,6 +2303,10 @@ namespace casadi {
     casadi_error("'generate_dependencies' not defined for " + type_name());
   }
 
+  void FunctionInternal::serialize(Serializer& s) const {
+    casadi_error("'serialize' not defined for " + type_name() + " \"" + name_ + "\"");
+  }
+
   void FunctionInternal::sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
     // Get the number of inputs and outputs
     int n_in = this->n_in();
@@ -2106,7 +2326,7 @@ namespace casadi {
         if (arg[iind]==0 || nnz_in(iind)==0) continue;
 
         // Get the sparsity of the Jacobian block
-        Sparsity sp = sparsity_jac(iind, oind, true, false);
+        const Sparsity& sp = sparsity_jac(iind, oind, true, false);
         if (sp.is_null() || sp.nnz() == 0) continue; // Skip if zero
 
         // Carry out the sparse matrix-vector multiplication
@@ -2137,7 +2357,7 @@ namespace casadi {
         if (arg[iind]==0 || nnz_in(iind)==0) continue;
 
         // Get the sparsity of the Jacobian block
-        Sparsity sp = sparsity_jac(iind, oind, true, false);
+        const Sparsity& sp = sparsity_jac(iind, oind, true, false);
         if (sp.is_null() || sp.nnz() == 0) continue; // Skip if zero
 
         // Carry out the sparse matrix-vector multiplication
@@ -2725,6 +2945,7 @@ namespace casadi {
   }
 
   void FunctionInternal::clear_memory() {
+    std::lock_guard<std::mutex> lock(mem_mtx_);
     for (auto&& i : mem_) {
       if (i!=0) free_memory(i);
     }
@@ -2778,19 +2999,27 @@ namespace casadi {
   }
 
   void* FunctionInternal::memory(int ind) const {
+    // mem_ may be reallocated by a concurrent checkout
+    std::lock_guard<std::mutex> lock(mem_mtx_);
     return mem_.at(ind);
   }
 
   int FunctionInternal::checkout() const {
+    std::unique_lock<std::mutex> lock(mem_mtx_);
     if (unused_.empty()) {
       // Allocate a new memory object
       int n_mem = this->n_mem();
       casadi_assert_message(n_mem==0 || mem_.size()<n_mem,
                             "Too many memory objects");
+      // Reserve the slot, then initialize without holding the lock
+      int ind = mem_.size();
+      mem_.push_back(0);
+      lock.unlock();
       void* m = alloc_memory();
-      mem_.push_back(m);
       if (m) init_memory(m);
-      return mem_.size()-1;
+      lock.lock();
+      mem_[ind] = m;
+      return ind;
     } else {
       // Use an unused memory object
       int m = unused_.top();
@@ -2800,6 +3029,7 @@ namespace casadi {
   }
 
   void FunctionInternal::release(int mem) const {
+    std::lock_guard<std::mutex> lock(mem_mtx_);
     unused_.push(mem);
   }
 
@@ -30,10 +30,13 @@
 #include "../weak_ref.hpp"
 #include <set>
 #include <stack>
+#include <mutex>
 #include "code_generator.hpp"
+#include "serializer.hpp"
 #include "importer.hpp"
 #include "../sparse_storage.hpp"
 #include "../options.hpp"
+#include "../timing.hpp"
 
 // This macro is for documentation purposes
 #define INPUTSCHEME(name)
@@ -148,9 +151,18 @@ namespace casadi {
     ///@{
     /** \brief  Evaluate numerically */
     void _eval(const double** arg, double** res, int* iw, double* w, int mem);
+    void _eval_direct(const double** arg, double** res, int* iw, double* w, int mem);
+    void _eval_profiled(const double** arg, double** res, int* iw, double* w, int mem);
     virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
     ///@}
 
+    /** \brief  Evaluate numerically for a batch of points, work vectors given */
+    virtual void eval_batch(void* mem, const double** arg, double** res, int* iw, double* w,
+                            int n) const;
+
+    /** \brief  Is batched evaluation supported? */
+    virtual bool has_eval_batch() const { return false;}
+
     /** \brief  Evaluate numerically, simplied syntax */
     virtual void simple(const double* arg, double* res);
 
@@ -530,9 +542,15 @@ namespace casadi {
     /** \brief Is codegen supported? */
     virtual bool has_codegen() const { return false;}
 
+    /** \brief Serialize the function, see Function::save */
+    virtual void serialize(Serializer& s) const;
+
     /** \brief Jit dependencies */
     virtual void jit_dependencies(const std::string& fname) {}
 
+    /** \brief Write the generated code to file(s) and compile it with the JIT compiler */
+    Importer jit_compile(const CodeGenerator& gen) const;
+
     /** \brief  Print */
     virtual void print(std::ostream &stream) const;
 
@@ -615,6 +633,11 @@ namespace casadi {
     /// Generate the sparsity of a Jacobian block
     void set_jac_sparsity(const Sparsity& sp, int iind, int oind, bool compact);
 
+    /** \brief Propagate n independent sets of seeds through the function
+     * Seeds and sensitivities are stored consecutively. The sweeps are distributed
+     * over GlobalOptions::sparsity_num_threads threads */
+    void sp_sweeps(bool fwd, int iind, int oind, int n, bvec_t* seed, bvec_t* sens);
+
     /// Get, if necessary generate, the sparsity of a Jacobian block
     Sparsity& sparsity_jac(int iind, int oind, bool compact, bool symmetric);
 
@@ -745,7 +768,7 @@ namespace casadi {
     ///@{
     /// Get all statistics
     virtual Dict get_stats(void* mem) const { return Dict();}
-    virtual Dict _get_stats(int mem) const { return get_stats(memory(mem));}
+    virtual Dict _get_stats(int mem) const;
     ///@}
 
     ///@{
@@ -807,6 +830,12 @@ namespace casadi {
     /** \brief Dict of statistics (resulting from evaluate) */
     Dict stats_;
 
+    /** \brief Timing of Jacobian sparsity detection and graph coloring */
+    FStats jac_sparsity_stats_, coloring_stats_;
+
+    /// Add the timing of sparsity detection and coloring to the statistics
+    bool sparsity_stats_;
+
     /** \brief Reference counting in codegen? */
     bool has_refcount_;
 
@@ -834,7 +863,7 @@ namespace casadi {
     /// Just-in-time compiler
     std::string compilerplugin_;
     Importer compiler_;
-    Dict jit_options_;
+    Dict jit_options_, jit_codegen_options_;
 
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
@@ -854,6 +883,20 @@ namespace casadi {
     // Print timing statistics
     bool print_time_;
 
+    /// Record calls of this function and the functions it calls
+    bool profile_;
+
+    /// Maximum number of calls kept for tracing
+    int profile_max_events_;
+
+    /// Accumulated profiling data
+    ProfileNode profile_tree_;
+    ProfileEvents profile_events_;
+    mutable std::mutex profile_mtx_;
+
+    /// Estimated number of floating point operations per call, -1 if unknown
+    virtual double n_flops() const { return -1;}
+
     /** \brief Get type name */
     virtual std::string type_name() const;
 
@@ -882,6 +925,9 @@ namespace casadi {
     /// Unused memory objects
     mutable std::stack<int> unused_;
 
+    /// Guards mem_ and unused_ for concurrent checkout/release
+    mutable std::mutex mem_mtx_;
+
     /** \brief Memory that is persistent during a call (but not between calls) */
     size_t sz_arg_per_, sz_res_per_, sz_iw_per_, sz_w_per_;
 
@@ -1001,8 +1047,17 @@ namespace casadi {
     std::vector<D*> resp(sz_res());
     for (int i=0; i<n_out; ++i) resp[i]=get_ptr(res[i]);
 
-    // Call memory-less
-    _eval(get_ptr(argp), get_ptr(resp), get_ptr(iw_tmp), get_ptr(w_tmp), 0);
+    // Check out a memory object, so that concurrent calls do not share state
+    int mem = checkout();
+
+    // Evaluate
+    try {
+      _eval(get_ptr(argp), get_ptr(resp), get_ptr(iw_tmp), get_ptr(w_tmp), mem);
+    } catch(...) {
+      release(mem);
+      throw;
+    }
+    release(mem);
   }
 
   template<typename M>
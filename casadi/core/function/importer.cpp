@@ -97,4 +97,8 @@ namespace casadi {
     return (*this)->body(symname);
   }
 
+  Dict Importer::stats() const {
+    return (*this)->get_stats();
+  }
+
 } // namespace casadi
@@ -123,6 +123,9 @@ namespace casadi {
     /// Get the function body, if inlined
     std::string body(const std::string& symname) const;
 
+    /// Get statistics, e.g. for a compilation cache
+    Dict stats() const;
+
 #ifndef SWIG
     /** Convert indexed command */
     static inline std::string indexed(const std::string& cmd, int ind) {
@@ -114,6 +114,9 @@ namespace casadi {
     /// Get the function body, if inlined
     std::string body(const std::string& symname) const;
 
+    /// Get statistics
+    virtual Dict get_stats() const { return Dict();}
+
     /// Can meta information be read?
     virtual bool can_have_meta() const { return true;}
 
@@ -114,6 +114,7 @@ namespace casadi {
     // Default options
     print_stats_ = false;
     output_t0_ = false;
+    sens_num_threads_ = 1;
   }
 
   Integrator::~Integrator() {
@@ -220,7 +221,11 @@ namespace casadi {
         "Options to be passed down to the augmented integrator, if one is constructed."}},
       {"output_t0",
        {OT_BOOL,
-        "Output the state at the initial time"}}
+        "Output the state at the initial time"}},
+      {"sens_num_threads",
+       {OT_INT,
+        "Divide forward and adjoint sensitivity directions between this many threads, "
+        "each integrating the nondifferentiated problem with its share of the directions [1]"}}
      }
   };
 
@@ -241,6 +246,8 @@ namespace casadi {
         grid_ = op.second;
       } else if (op.first=="augmented_options") {
         augmented_options_ = op.second;
+      } else if (op.first=="sens_num_threads") {
+        sens_num_threads_ = op.second;
       } else if (op.first=="t0") {
         t0 = op.second;
       } else if (op.first=="tf") {
@@ -695,15 +702,20 @@ namespace casadi {
       aug_opts[i.first] = i.second;
     }
 
+    // Number of threads and directions per thread
+    int nt = std::max(1, std::min(sens_num_threads_, nfwd));
+    int nd = (nfwd+nt-1)/nt;
+    if (nd>0) nt = (nfwd+nd-1)/nd;
+
     // Create integrator for augmented DAE
     Function aug_dae;
-    string aug_prefix = "fsens" + to_string(nfwd) + "_";
+    string aug_prefix = "fsens" + to_string(nd) + "_";
     string dae_name = aug_prefix + oracle_.name();
     Dict dae_opts = {{"derivative_of", oracle_}};
     if (oracle_.is_a("sxfunction")) {
-      aug_dae = map2oracle(dae_name, aug_fwd<SX>(nfwd));
+      aug_dae = map2oracle(dae_name, aug_fwd<SX>(nd));
     } else {
-      aug_dae = map2oracle(dae_name, aug_fwd<MX>(nfwd));
+      aug_dae = map2oracle(dae_name, aug_fwd<MX>(nd));
     }
     aug_opts["derivative_of"] = self();
     Function aug_int = integrator(aug_prefix + this->name(), plugin_name(),
@@ -746,18 +758,14 @@ namespace casadi {
     }
 
     // Call the integrator
-    vector<MX> integrator_in(INTEGRATOR_NUM_IN);
-    integrator_in[INTEGRATOR_X0] = horzcat(x0_aug);
-    integrator_in[INTEGRATOR_P] = horzcat(p_aug);
-    integrator_in[INTEGRATOR_Z0] = horzcat(z0_aug);
-    integrator_in[INTEGRATOR_RX0] = horzcat(rx0_aug);
-    integrator_in[INTEGRATOR_RP] = horzcat(rp_aug);
-    integrator_in[INTEGRATOR_RZ0] = horzcat(rz0_aug);
-    vector<MX> integrator_out = aug_int(integrator_in);
-    for (auto&& e : integrator_out) {
-      // Workaround
-      if (e.size2()!=1+nfwd) e = reshape(e, -1, 1+nfwd);
-    }
+    vector<vector<MX> > integrator_in(INTEGRATOR_NUM_IN);
+    integrator_in[INTEGRATOR_X0] = x0_aug;
+    integrator_in[INTEGRATOR_P] = p_aug;
+    integrator_in[INTEGRATOR_Z0] = z0_aug;
+    integrator_in[INTEGRATOR_RX0] = rx0_aug;
+    integrator_in[INTEGRATOR_RP] = rp_aug;
+    integrator_in[INTEGRATOR_RZ0] = rz0_aug;
+    vector<MX> integrator_out = aug_call(aug_int, nt, nd, integrator_in, true);
 
     // Augmented results
     vector<int> offset = range(1+nfwd+1);
@@ -820,14 +828,19 @@ namespace casadi {
       aug_opts[i.first] = i.second;
     }
 
+    // Number of threads and directions per thread
+    int nt = std::max(1, std::min(sens_num_threads_, nadj));
+    int nd = (nadj+nt-1)/nt;
+    if (nd>0) nt = (nadj+nd-1)/nd;
+
     // Create integrator for augmented DAE
     Function aug_dae;
-    string aug_prefix = "asens" + to_string(nadj) + "_";
+    string aug_prefix = "asens" + to_string(nd) + "_";
     string dae_name = aug_prefix + oracle_.name();
     if (oracle_.is_a("sxfunction")) {
-      aug_dae = map2oracle(dae_name, aug_adj<SX>(nadj));
+      aug_dae = map2oracle(dae_name, aug_adj<SX>(nd));
     } else {
-      aug_dae = map2oracle(dae_name, aug_adj<MX>(nadj));
+      aug_dae = map2oracle(dae_name, aug_adj<MX>(nd));
     }
     aug_opts["derivative_of"] = self();
     Function aug_int = integrator(aug_prefix + this->name(), plugin_name(),
@@ -880,14 +893,21 @@ namespace casadi {
     }
 
     // Call the integrator
-    vector<MX> integrator_in(INTEGRATOR_NUM_IN);
-    integrator_in[INTEGRATOR_X0] = vertcat(x0_aug);
-    integrator_in[INTEGRATOR_P] = vertcat(p_aug);
-    integrator_in[INTEGRATOR_Z0] = vertcat(z0_aug);
-    integrator_in[INTEGRATOR_RX0] = vertcat(rx0_aug);
-    integrator_in[INTEGRATOR_RP] = vertcat(rp_aug);
-    integrator_in[INTEGRATOR_RZ0] = vertcat(rz0_aug);
-    vector<MX> integrator_out = aug_int(integrator_in);
+    vector<vector<MX> > integrator_in(INTEGRATOR_NUM_IN);
+    integrator_in[INTEGRATOR_X0] = x0_aug;
+    integrator_in[INTEGRATOR_P] = p_aug;
+    integrator_in[INTEGRATOR_Z0] = z0_aug;
+    integrator_in[INTEGRATOR_RX0] = rx0_aug;
+    integrator_in[INTEGRATOR_RP] = rp_aug;
+    integrator_in[INTEGRATOR_RZ0] = rz0_aug;
+    vector<int> n0(INTEGRATOR_NUM_OUT);
+    n0[INTEGRATOR_XF] = x().numel();
+    n0[INTEGRATOR_QF] = q().numel();
+    n0[INTEGRATOR_ZF] = z().numel();
+    n0[INTEGRATOR_RXF] = rx().numel();
+    n0[INTEGRATOR_RQF] = rq().numel();
+    n0[INTEGRATOR_RZF] = rz().numel();
+    vector<MX> integrator_out = aug_call(aug_int, nt, nd, integrator_in, false, n0);
 
     // Get offset in the splitted problem
     vector<int> off_x = {0, x().numel()};
@@ -957,6 +977,67 @@ namespace casadi {
     return Function(name, ret_in, ret_out, i_names, o_names, opts);
   }
 
+  std::vector<MX> Integrator::aug_call(Function& aug_int, int nt, int nd,
+                                       const std::vector<std::vector<MX> >& aug_in,
+                                       bool fwd, const std::vector<int>& n0) {
+    // Number of directions
+    int ndir = aug_in.at(0).size()-1;
+
+    // Arguments, the directions of each thread padded with zeros
+    vector<MX> arg(aug_in.size());
+    for (int i=0; i<arg.size(); ++i) {
+      const vector<MX>& v = aug_in[i];
+      vector<MX> vt;
+      for (int t=0; t<nt; ++t) {
+        vector<MX> vd(1, v[0]);
+        for (int d=t*nd; d<(t+1)*nd; ++d) {
+          vd.push_back(d<ndir ? v[1+d] : MX::zeros(v[1].size()));
+        }
+        vt.push_back(fwd ? horzcat(vd) : vertcat(vd));
+      }
+      arg[i] = horzcat(vt);
+    }
+
+    // Call the integrator, once or for each thread
+    vector<MX> res;
+    if (nt==1) {
+      res = aug_int(arg);
+    } else {
+      Function f = aug_int.map(aug_int.name() + "_thread", "thread", nt,
+                               Dict{{"max_num_threads", nt}});
+      res = f(arg);
+    }
+
+    // Nondifferentiated results from the first thread, directions from all threads
+    for (int i=0; i<res.size(); ++i) {
+      int nc = aug_int.size2_out(i);
+      vector<MX> r, rt;
+      if (nc==0) {
+        rt.resize(nt, MX(aug_int.size1_out(i), 0));
+      } else {
+        rt = horzsplit(res[i], nc);
+      }
+      for (int t=0; t<nt; ++t) {
+        vector<MX> rd;
+        if (fwd) {
+          // Workaround
+          if (rt[t].size2()!=1+nd) rt[t] = reshape(rt[t], -1, 1+nd);
+          rd = horzsplit(rt[t]);
+        } else {
+          // Equal number of rows for each direction
+          int m = nd==0 ? 0 : (rt[t].size1()-n0.at(i))/nd;
+          vector<int> offset = {0, n0[i]};
+          for (int d=0; d<nd; ++d) offset.push_back(offset.back()+m);
+          rd = vertsplit(rt[t], offset);
+        }
+        if (t==0) r.push_back(rd[0]);
+        for (int d=0; d<nd && t*nd+d<ndir; ++d) r.push_back(rd[1+d]);
+      }
+      res[i] = fwd ? horzcat(r) : vertcat(r);
+    }
+    return res;
+  }
+
   Dict Integrator::getDerivativeOptions(bool fwd) {
     // Copy all options
     return opts_;
@@ -1078,6 +1159,17 @@ namespace casadi {
     m->rx_prev.resize(nrx_);
     m->RZ_prev.resize(nRZ_);
     m->rq_prev.resize(nrq_);
+
+    // Memory objects of the discrete time dynamics, not shared with other memory blocks
+    m->mem_F = getExplicit().checkout();
+    m->mem_G = getExplicitB().is_null() ? -1 : getExplicitB().checkout();
+  }
+
+  void FixedStepIntegrator::free_memory(void *mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+    getExplicit().release(m->mem_F);
+    if (m->mem_G>=0) getExplicitB().release(m->mem_G);
+    delete m;
   }
 
   void FixedStepIntegrator::advance(IntegratorMemory* mem, double t,
@@ -1113,7 +1205,7 @@ namespace casadi {
       casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
 
       // Take step
-      F(m->arg, m->res, m->iw, m->w, 0);
+      F(m->arg, m->res, m->iw, m->w, m->mem_F);
       casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
 
       // Tape
@@ -1173,7 +1265,7 @@ namespace casadi {
       // Take step
       m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
       m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
-      G(m->arg, m->res, m->iw, m->w, 0);
+      G(m->arg, m->res, m->iw, m->w, m->mem_G);
       casadi_axpy(nrq_, 1., get_ptr(m->rq_prev), get_ptr(m->rq));
     }
 
@@ -1237,12 +1329,142 @@ namespace casadi {
     casadi_fill(m->RZ.ptr(), m->RZ.nnz(), numeric_limits<double>::quiet_NaN());
   }
 
+  bool FixedStepIntegrator::has_codegen() const {
+    if (!getExplicit()->has_codegen()) return false;
+    return nrx_==0 || getExplicitB()->has_codegen();
+  }
+
+  void FixedStepIntegrator::generateDeclarations(CodeGenerator& g) const {
+    getExplicit()->addDependency(g);
+    if (nrx_>0) getExplicitB()->addDependency(g);
+  }
+
+  void FixedStepIntegrator::generateReset(CodeGenerator& g, const std::string& Z,
+                                          const std::string& x, const std::string& z) const {
+    g.body << "  fill(" << Z << ", " << nZ_ << ", NAN);" << endl;
+  }
+
+  void FixedStepIntegrator::generateResetB(CodeGenerator& g, const std::string& RZ,
+                                           const std::string& rx, const std::string& rz) const {
+    g.body << "  fill(" << RZ << ", " << nRZ_ << ", NAN);" << endl;
+  }
+
+  void FixedStepIntegrator::generateBody(CodeGenerator& g) const {
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    g.addAuxiliary(CodeGenerator::AUX_FILL);
+    g.addAuxiliary(CodeGenerator::AUX_AXPY);
+    const Function& F = getExplicit();
+    string t0 = CodeGenerator::constant(grid_.front()), h = CodeGenerator::constant(h_);
+
+    // Number of steps taken before each output, cf. advance
+    vector<int> k_out;
+    for (int k=output_t0_ ? 0 : 1; k<grid_.size(); ++k) {
+      k_out.push_back(min(static_cast<int>(std::ceil((grid_[k] - grid_.front())/h_)), nk_));
+    }
+    string s_k_out = "s" + to_string(g.getConstant(k_out, true));
+
+    // The iterates, previous iterates and the tape are static work vectors,
+    // the work vector is left to F and G
+    int sz_fwd = 2*(nx_ + nZ_ + nq_);
+    int sz_adj = nrx_>0 ? (nk_+1)*nx_ + nk_*nZ_ + 2*(nrx_ + nRZ_ + nrq_) : 0;
+    string sw = g.static_work(sz_fwd + sz_adj);
+
+    // Local variables
+    g.body << "  int i, j, k;" << endl
+           << "  real_t t;" << endl
+           << "  const real_t** arg1 = arg+" << n_in() << ";" << endl
+           << "  real_t** res1 = res+" << n_out() << ";" << endl
+           << "  real_t *x=" << sw << ", *x_prev=x+" << nx_ << ", *Z=x_prev+" << nx_
+           << ", *Z_prev=Z+" << nZ_ << ", *q=Z_prev+" << nZ_ << ", *dq=q+" << nq_ << ";" << endl;
+    if (nrx_>0) {
+      g.body << "  real_t *x_tape=dq+" << nq_ << ", *Z_tape=x_tape+" << (nk_+1)*nx_
+             << ", *rx=Z_tape+" << nk_*nZ_ << ", *rx_prev=rx+" << nrx_
+             << ", *RZ=rx_prev+" << nrx_ << ", *RZ_prev=RZ+" << nRZ_
+             << ", *rq=RZ_prev+" << nRZ_ << ", *drq=rq+" << nrq_ << ";" << endl;
+    }
+
+    // Reset the forward problem
+    g.body << "  copy(arg[" << INTEGRATOR_X0 << "], " << nx_ << ", x);" << endl
+           << "  fill(q, " << nq_ << ", 0.);" << endl;
+    generateReset(g, "Z", "arg[" + to_string(INTEGRATOR_X0) + "]",
+                  "arg[" + to_string(INTEGRATOR_Z0) + "]");
+    if (nrx_>0) g.body << "  copy(x, " << nx_ << ", x_tape);" << endl;
+
+    // Take steps until each output time has been reached
+    g.body << "  for (j=0, k=0; j<" << k_out.size() << "; ++j) {" << endl
+           << "    for (; k<" << s_k_out << "[j]; ++k) {" << endl
+           << "      t = " << t0 << "+k*" << h << ";" << endl
+           << "      copy(x, " << nx_ << ", x_prev);" << endl
+           << "      copy(Z, " << nZ_ << ", Z_prev);" << endl
+           << "      for (i=0; i<" << F.n_in() << "; ++i) arg1[i]=0;" << endl
+           << "      arg1[" << DAE_T << "] = &t;" << endl
+           << "      arg1[" << DAE_X << "] = x_prev;" << endl
+           << "      arg1[" << DAE_Z << "] = Z_prev;" << endl
+           << "      arg1[" << DAE_P << "] = arg[" << INTEGRATOR_P << "];" << endl
+           << "      for (i=0; i<" << F.n_out() << "; ++i) res1[i]=0;" << endl
+           << "      res1[" << DAE_ODE << "] = x;" << endl
+           << "      res1[" << DAE_ALG << "] = Z;" << endl
+           << "      res1[" << DAE_QUAD << "] = dq;" << endl
+           << "      if (" << g(F, "arg1", "res1", "iw", "w") << ") return 1;" << endl
+           << "      axpy(" << nq_ << ", 1., dq, q);" << endl;
+    if (nrx_>0) {
+      g.body << "      copy(x, " << nx_ << ", x_tape+" << nx_ << "*(k+1));" << endl
+             << "      copy(Z, " << nZ_ << ", Z_tape+" << nZ_ << "*k);" << endl;
+    }
+    g.body << "    }" << endl
+           << "    if (res[" << INTEGRATOR_XF << "]) copy(x, " << nx_ << ", res["
+           << INTEGRATOR_XF << "]+" << nx_ << "*j);" << endl
+           << "    if (res[" << INTEGRATOR_ZF << "]) copy(Z+" << nZ_-nz_ << ", " << nz_
+           << ", res[" << INTEGRATOR_ZF << "]+" << nz_ << "*j);" << endl
+           << "    if (res[" << INTEGRATOR_QF << "]) copy(q, " << nq_ << ", res["
+           << INTEGRATOR_QF << "]+" << nq_ << "*j);" << endl
+           << "  }" << endl;
+
+    // Backward problem
+    if (nrx_>0) {
+      const Function& G = getExplicitB();
+
+      // Reset the backward problem
+      g.body << "  copy(arg[" << INTEGRATOR_RX0 << "], " << nrx_ << ", rx);" << endl
+             << "  fill(rq, " << nrq_ << ", 0.);" << endl;
+      generateResetB(g, "RZ", "arg[" + to_string(INTEGRATOR_RX0) + "]",
+                     "arg[" + to_string(INTEGRATOR_RZ0) + "]");
+
+      // Take steps back to the beginning of the time horizon
+      g.body << "  for (k=" << nk_-1 << "; k>=0; --k) {" << endl
+             << "    t = " << t0 << "+k*" << h << ";" << endl
+             << "    copy(rx, " << nrx_ << ", rx_prev);" << endl
+             << "    copy(RZ, " << nRZ_ << ", RZ_prev);" << endl
+             << "    for (i=0; i<" << G.n_in() << "; ++i) arg1[i]=0;" << endl
+             << "    arg1[" << RDAE_T << "] = &t;" << endl
+             << "    arg1[" << RDAE_X << "] = x_tape+" << nx_ << "*k;" << endl
+             << "    arg1[" << RDAE_Z << "] = Z_tape+" << nZ_ << "*k;" << endl
+             << "    arg1[" << RDAE_P << "] = arg[" << INTEGRATOR_P << "];" << endl
+             << "    arg1[" << RDAE_RX << "] = rx_prev;" << endl
+             << "    arg1[" << RDAE_RZ << "] = RZ_prev;" << endl
+             << "    arg1[" << RDAE_RP << "] = arg[" << INTEGRATOR_RP << "];" << endl
+             << "    for (i=0; i<" << G.n_out() << "; ++i) res1[i]=0;" << endl
+             << "    res1[" << RDAE_ODE << "] = rx;" << endl
+             << "    res1[" << RDAE_ALG << "] = RZ;" << endl
+             << "    res1[" << RDAE_QUAD << "] = drq;" << endl
+             << "    if (" << g(G, "arg1", "res1", "iw", "w") << ") return 1;" << endl
+             << "    axpy(" << nrq_ << ", 1., drq, rq);" << endl
+             << "  }" << endl
+             << "  copy(rx, " << nrx_ << ", res[" << INTEGRATOR_RXF << "]);" << endl
+             << "  copy(RZ+" << nRZ_-nrz_ << ", " << nrz_ << ", res[" << INTEGRATOR_RZF << "]);"
+             << endl
+             << "  copy(rq, " << nrq_ << ", res[" << INTEGRATOR_RQF << "]);" << endl;
+    }
+  }
+
   ImplicitFixedStepIntegrator::
   ImplicitFixedStepIntegrator(const std::string& name, const Function& dae)
     : FixedStepIntegrator(name, dae) {
   }
 
   ImplicitFixedStepIntegrator::~ImplicitFixedStepIntegrator() {
+    // Release the rootfinder memory while the rootfinders are still alive
+    clear_memory();
   }
 
   Options ImplicitFixedStepIntegrator::options_
@@ -147,6 +147,18 @@ namespace casadi {
     /** \brief Generate a augmented DAE system with \a nadj adjoint sensitivities */
     template<typename MatType> std::map<std::string, MatType> aug_adj(int nadj);
 
+    /** \brief Call an augmented integrator for \a nt groups of \a nd directions
+     *
+     * Each entry of \a aug_in holds the nondifferentiated argument followed by one
+     * argument per direction. With \a nt > 1, the groups are evaluated by different threads,
+     * each integrating the nondifferentiated problem along with its own directions.
+     * The directions are concatenated horizontally (forward) or vertically (adjoint),
+     * the latter requiring the number of rows \a n0 of each nondifferentiated output.
+     */
+    std::vector<MX> aug_call(Function& aug_int, int nt, int nd,
+                             const std::vector<std::vector<MX> >& aug_in,
+                             bool fwd, const std::vector<int>& n0=std::vector<int>());
+
     /// Create sparsity pattern of the extended Jacobian (forward problem)
     Sparsity sp_jac_dae();
 
@@ -188,6 +200,9 @@ namespace casadi {
     // Augmented user option
     Dict augmented_options_;
 
+    // Number of threads among which sensitivity directions are divided
+    int sens_num_threads_;
+
     // Copy of the options
     Dict opts_;
 
@@ -237,6 +252,9 @@ namespace casadi {
 
     // Tape
     std::vector<std::vector<double> > x_tape, Z_tape;
+
+    // Memory objects of the discrete time dynamics
+    int mem_F, mem_G;
   };
 
   class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -261,7 +279,7 @@ namespace casadi {
     virtual void* alloc_memory() const { return new FixedStepMemory();}
 
     /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<FixedStepMemory*>(mem);}
+    virtual void free_memory(void *mem) const;
 
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
@@ -291,6 +309,23 @@ namespace casadi {
     /// Get explicit dynamics (backward problem)
     virtual const Function& getExplicitB() const { return G_;}
 
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const;
+
+    /** \brief Generate code for the declarations of the C function */
+    virtual void generateDeclarations(CodeGenerator& g) const;
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
+    /** \brief Generate code for the initial guess of Z, cf. reset */
+    virtual void generateReset(CodeGenerator& g, const std::string& Z,
+                               const std::string& x, const std::string& z) const;
+
+    /** \brief Generate code for the initial guess of RZ, cf. resetB */
+    virtual void generateResetB(CodeGenerator& g, const std::string& RZ,
+                                const std::string& rx, const std::string& rz) const;
+
     // Discrete time dynamics
     Function F_, G_;
 
@@ -101,14 +101,108 @@ namespace casadi {
   Interpolant::~Interpolant() {
   }
 
+  Options Interpolant::options_
+  = {{&FunctionInternal::options_},
+     {{"lookup_mode",
+       {OT_STRINGVECTOR,
+        "Grid lookup for each dimension: 'linear' (scan), 'exact' (uniform grid), "
+        "'binary' (bisection) or 'auto' [auto]"}},
+      {"batch_x",
+       {OT_INT,
+        "Number of points evaluated per call, passed as the columns of x [1]"}}
+     }
+  };
+
+  void Interpolant::init(const Dict& opts) {
+    // The number of points is needed for the sparsity patterns
+    batch_x_ = 1;
+    vector<string> lookup_mode;
+    for (auto&& op : opts) {
+      if (op.first=="batch_x") {
+        batch_x_ = op.second;
+      } else if (op.first=="lookup_mode") {
+        lookup_mode = op.second;
+      }
+    }
+    casadi_assert_message(batch_x_>=1, "Interpolant: 'batch_x' must be positive");
+
+    // Call the base class initializer
+    FunctionInternal::init(opts);
+
+    // Lookup mode for each dimension
+    lookup_mode_ = interpret_lookup_mode(lookup_mode, grid_, offset_);
+  }
+
+  std::vector<int> Interpolant::interpret_lookup_mode(const std::vector<std::string>& modes,
+                                                      const std::vector<double>& grid,
+                                                      const std::vector<int>& offset) {
+    int ndim = offset.size()-1;
+    casadi_assert_message(modes.empty() || modes.size()==ndim,
+                          "Interpolant: 'lookup_mode' must have one entry per dimension");
+    vector<int> ret(ndim);
+    for (int i=0; i<ndim; ++i) {
+      const double* g = get_ptr(grid) + offset[i];
+      int ng = offset[i+1]-offset[i];
+
+      // Is the grid uniform, up to rounding?
+      bool uniform = true;
+      double h = (g[ng-1]-g[0])/(ng-1), tol = 1e-10*max(fabs(g[0]), fabs(g[ng-1]));
+      for (int j=1; j<ng-1 && uniform; ++j) uniform = fabs(g[j]-(g[0]+j*h)) <= tol;
+
+      string mode = modes.empty() ? "auto" : modes[i];
+      if (mode=="auto") {
+        ret[i] = uniform ? 1 : ng>=16 ? 2 : 0;
+      } else if (mode=="linear") {
+        ret[i] = 0;
+      } else if (mode=="exact") {
+        casadi_assert_message(uniform, "Interpolant: 'exact' lookup requires a uniform grid");
+        ret[i] = 1;
+      } else if (mode=="binary") {
+        ret[i] = 2;
+      } else {
+        casadi_error("Interpolant: Unknown lookup mode '" + mode + "'");
+      }
+    }
+    return ret;
+  }
+
+  void Interpolant::sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    sp_fwd_batch(batch_x_, ndim_, 1, arg[0], res[0]);
+  }
+
+  void Interpolant::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    sp_rev_batch(batch_x_, ndim_, 1, arg[0], res[0]);
+  }
+
+  void Interpolant::sp_fwd_batch(int nb, int nx, int nr, const bvec_t* x, bvec_t* r) {
+    if (!r) return;
+    for (int j=0; j<nb; ++j) {
+      bvec_t s = 0;
+      if (x) for (int i=0; i<nx; ++i) s |= x[j*nx+i];
+      for (int i=0; i<nr; ++i) r[j*nr+i] = s;
+    }
+  }
+
+  void Interpolant::sp_rev_batch(int nb, int nx, int nr, bvec_t* x, bvec_t* r) {
+    if (!r) return;
+    for (int j=0; j<nb; ++j) {
+      bvec_t s = 0;
+      for (int i=0; i<nr; ++i) {
+        s |= r[j*nr+i];
+        r[j*nr+i] = 0;
+      }
+      if (x) for (int i=0; i<nx; ++i) x[j*nx+i] |= s;
+    }
+  }
+
   Sparsity Interpolant::get_sparsity_in(int i) {
     casadi_assert(i==0);
-    return Sparsity::dense(ndim_);
+    return Sparsity::dense(ndim_, batch_x_);
   }
 
   Sparsity Interpolant::get_sparsity_out(int i) {
     casadi_assert(i==0);
-    return Sparsity::scalar();
+    return Sparsity::dense(1, batch_x_);
   }
 
   std::string Interpolant::get_name_in(int i) {
@@ -55,6 +55,15 @@ namespace casadi {
     virtual size_t get_n_out() { return 1;}
     ///@}
 
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    /// Initialize
+    virtual void init(const Dict& opts);
+
     /// @{
     /** \brief Sparsities of function inputs and outputs */
     virtual Sparsity get_sparsity_in(int i);
@@ -67,6 +76,20 @@ namespace casadi {
     virtual std::string get_name_out(int i);
     /// @}
 
+    ///@{
+    /** \brief Sparsity propagation, each point only depends on its own column of x */
+    virtual bool has_spfwd() const { return true;}
+    virtual bool has_sprev() const { return true;}
+    virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    virtual void sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    ///@}
+
+    ///@{
+    /** \brief Sparsity propagation for nr outputs per point, also used by derivatives */
+    static void sp_fwd_batch(int nb, int nx, int nr, const bvec_t* x, bvec_t* r);
+    static void sp_rev_batch(int nb, int nx, int nr, bvec_t* x, bvec_t* r);
+    ///@}
+
     // Creator function for internal class
     typedef Interpolant* (*Creator)(const std::string& name,
                                     const std::vector<double>& grid,
@@ -93,6 +116,17 @@ namespace casadi {
 
     // Values at gridpoints
     std::vector<double> values_;
+
+    // Number of points evaluated per call
+    int batch_x_;
+
+    // Lookup mode for each dimension, see casadi_low
+    std::vector<int> lookup_mode_;
+
+    // Interpret a lookup mode option, "auto" picks the fastest exact lookup for the grid
+    static std::vector<int> interpret_lookup_mode(const std::vector<std::string>& modes,
+                                                  const std::vector<double>& grid,
+                                                  const std::vector<int>& offset);
   };
 
 } // namespace casadi
@@ -84,42 +84,48 @@ namespace casadi {
 
 #ifndef SWIG
     // Set sparsity pattern
-    void reset(const int* sp) const;
+    void reset(const int* sp, int mem=0) const;
 
     // Select pivots
-    void pivoting(const double* A) const;
+    void pivoting(const double* A, int mem=0) const;
 
     // Factorize linear system of equations
-    void factorize(const double* A) const;
+    void factorize(const double* A, int mem=0) const;
 
     // Solve factorized linear system of equations
-    void solve(double* x, int nrhs=1, bool tr=false) const;
+    void solve(double* x, int nrhs=1, bool tr=false, int mem=0) const;
 
     /** \brief Solve the system of equations <tt>Lx = b</tt>
         Only when a Cholesky factorization is available
     */
-    void solve_cholesky(double* x, int nrhs, bool tr) const;
+    void solve_cholesky(double* x, int nrhs, bool tr, int mem=0) const;
+
+    /// Checkout a memory object, e.g. one per concurrent caller
+    int checkout() const;
+
+    /// Release a memory object
+    void release(int mem) const;
 #endif // SWIG
 
     /** \brief Obtain a symbolic Cholesky factorization
         Only for Cholesky solvers
     */
-    Sparsity cholesky_sparsity(bool tr=false) const;
+    Sparsity cholesky_sparsity(bool tr=false, int mem=0) const;
 
     /** \brief Obtain a numeric Cholesky factorization
         Only for Cholesky solvers
      */
-    DM cholesky(bool tr=false) const;
+    DM cholesky(bool tr=false, int mem=0) const;
 
     /** \brief Number of negative eigenvalues
       * Not available for all solvers
       */
-    int neig() const;
+    int neig(int mem=0) const;
 
     /** \brief Matrix rank
       * Not available for all solvers
       */
-    int rank() const;
+    int rank(int mem=0) const;
   };
 
 
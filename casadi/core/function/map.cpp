@@ -25,6 +25,11 @@
 
 #include "map.hpp"
 
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <functional>
+
 using namespace std;
 
 namespace casadi {
@@ -38,6 +43,10 @@ namespace casadi {
       ret.assignNode(new Map(name, f, n));
     } else if (parallelization== "openmp") {
       ret.assignNode(new MapOmp(name, f, n));
+    } else if (parallelization== "thread") {
+      ret.assignNode(new MapThread(name, f, n));
+    } else if (parallelization== "simd") {
+      ret.assignNode(new MapSimd(name, f, n));
     } else {
       casadi_error("Unknown parallelization: " + parallelization);
     }
@@ -65,14 +74,14 @@ namespace casadi {
   }
 
   template<typename T>
-  void Map::evalGen(const T** arg, T** res, int* iw, T* w) const {
+  void Map::evalGen(const T** arg, T** res, int* iw, T* w, int mem) const {
     int n_in = this->n_in(), n_out = this->n_out();
     const T** arg1 = arg+n_in;
     copy_n(arg, n_in, arg1);
     T** res1 = res+n_out;
     copy_n(res, n_out, res1);
     for (int i=0; i<n_; ++i) {
-      f_(arg1, res1, iw, w, 0);
+      f_(arg1, res1, iw, w, mem);
       for (int j=0; j<n_in; ++j) {
         if (arg1[j]) arg1[j] += f_.nnz_in(j);
       }
@@ -107,6 +116,10 @@ namespace casadi {
     }
   }
 
+  Dict Map::map_options() const {
+    return derived_options();
+  }
+
   void Map::generateDeclarations(CodeGenerator& g) const {
     f_->addDependency(g);
   }
@@ -146,7 +159,7 @@ namespace casadi {
 
     // Generate map of derivative
     Function df = f_.forward_new(nfwd);
-    Function dm = df.map(name + "_map", parallelization(), n_, derived_options());
+    Function dm = df.map(name + "_map", parallelization(), n_, map_options());
 
     // Input expressions
     vector<MX> arg = dm.mx_in();
@@ -199,7 +212,7 @@ namespace casadi {
 
     // Generate map of derivative
     Function df = f_.reverse_new(nadj);
-    Function dm = df.map(name + "_map", parallelization(), n_, derived_options());
+    Function dm = df.map(name + "_map", parallelization(), n_, map_options());
 
     // Input expressions
     vector<MX> arg = dm.mx_in();
@@ -244,7 +257,15 @@ namespace casadi {
   }
 
   void Map::eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
-    evalGen(arg, res, iw, w);
+    // Own memory object of f, the map may be evaluated concurrently
+    int m = f_.checkout();
+    try {
+      evalGen(arg, res, iw, w, m);
+    } catch(...) {
+      f_.release(m);
+      throw;
+    }
+    f_.release(m);
   }
 
   MapOmp::~MapOmp() {
@@ -324,4 +345,194 @@ namespace casadi {
     alloc_iw(f_.sz_iw() * n_);
   }
 
+  MapThread::~MapThread() {
+  }
+
+  Options MapThread::options_
+  = {{&FunctionInternal::options_},
+     {{"max_num_threads",
+       {OT_INT,
+        "Maximum number of worker threads. Defaults to the number of "
+        "concurrent threads supported by the hardware."}}
+     }
+  };
+
+  void MapThread::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Default options
+    max_num_threads_ = std::thread::hardware_concurrency();
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="max_num_threads") {
+        max_num_threads_ = op.second;
+      }
+    }
+
+    // Number of worker threads
+    n_threads_ = std::max(1, std::min(n_, max_num_threads_));
+
+    // Allocate memory for holding memory object references
+    alloc_iw(n_threads_, true);
+
+    // Allocate sufficient memory for each worker thread
+    alloc_arg(f_.sz_arg() * n_threads_);
+    alloc_res(f_.sz_res() * n_threads_);
+    alloc_w(f_.sz_w() * n_threads_);
+    alloc_iw(f_.sz_iw() * n_threads_);
+  }
+
+  Dict MapThread::map_options() const {
+    Dict opts = Map::map_options();
+    opts["max_num_threads"] = max_num_threads_;
+    return opts;
+  }
+
+  template<typename A, typename R, typename T, typename E>
+  void MapThread::evalThread(A** arg, R** res, int* iw, T* w, E eval) const {
+    int n_in = this->n_in(), n_out = this->n_out();
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+
+    // Checkout memory objects, one per worker
+    int* ind = iw; iw += n_threads_;
+    for (int t=0; t<n_threads_; ++t) ind[t] = f_.checkout();
+
+    // Evaluations are claimed in chunks to limit contention on the counter
+    int chunk = std::max(1, n_ / (4*n_threads_));
+    std::atomic<int> next(0);
+
+    // Exceptions are passed on to the calling thread
+    std::vector<std::exception_ptr> err(n_threads_);
+
+    // Work performed by each thread
+    std::function<void(int)> work([&](int t) {
+      A** arg1 = arg + n_in + t*sz_arg;
+      R** res1 = res + n_out + t*sz_res;
+      int* iw1 = iw + t*sz_iw;
+      T* w1 = w + t*sz_w;
+      try {
+        for (int i0=next.fetch_add(chunk); i0<n_; i0=next.fetch_add(chunk)) {
+          for (int i=i0; i<std::min(i0+chunk, n_); ++i) {
+            // Input buffers
+            for (int j=0; j<n_in; ++j) {
+              arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : 0;
+            }
+            // Output buffers
+            for (int j=0; j<n_out; ++j) {
+              res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : 0;
+            }
+            // Evaluation
+            eval(arg1, res1, iw1, w1, ind[t]);
+          }
+        }
+      } catch (...) {
+        err[t] = std::current_exception();
+        // Stop the other workers
+        next = n_;
+      }
+    });
+
+    // Launch the workers, the calling thread acts as the first one
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads_-1);
+    for (int t=1; t<n_threads_; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto&& th : workers) th.join();
+
+    // Release memory objects
+    for (int t=0; t<n_threads_; ++t) f_.release(ind[t]);
+
+    // Rethrow the first exception, if any
+    for (auto&& e : err) if (e) std::rethrow_exception(e);
+  }
+
+  void MapThread::eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
+    evalThread(arg, res, iw, w,
+               [&](const double** arg1, double** res1, int* iw1, double* w1, int m) {
+                 f_(arg1, res1, iw1, w1, m);
+               });
+  }
+
+  void MapThread::sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    // Fall back to serial propagation if the function relies on its Jacobian sparsity,
+    // which is calculated on demand and not safe to be accessed concurrently
+    if (!f_->has_spfwd()) return Map::sp_fwd(arg, res, iw, w, mem);
+    evalThread(arg, res, iw, w,
+               [&](const bvec_t** arg1, bvec_t** res1, int* iw1, bvec_t* w1, int m) {
+                 f_(arg1, res1, iw1, w1, m);
+               });
+  }
+
+  void MapThread::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    // Fall back to serial propagation, cf. sp_fwd
+    if (!f_->has_sprev()) return Map::sp_rev(arg, res, iw, w, mem);
+    evalThread(arg, res, iw, w,
+               [&](bvec_t** arg1, bvec_t** res1, int* iw1, bvec_t* w1, int m) {
+                 f_.rev(arg1, res1, iw1, w1, m);
+               });
+  }
+
+  MapSimd::~MapSimd() {
+  }
+
+  Options MapSimd::options_
+  = {{&FunctionInternal::options_},
+     {{"batch_size",
+       {OT_INT,
+        "Number of points evaluated together"}}
+     }
+  };
+
+  void MapSimd::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Default options
+    batch_size_ = 64;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="batch_size") {
+        batch_size_ = op.second;
+      }
+    }
+    casadi_assert_message(batch_size_>0, "Option \"batch_size\" must be positive");
+    batch_size_ = std::min(batch_size_, n_);
+
+    // Make sure that batched evaluation is supported
+    casadi_assert_message(f_.has_eval_batch(),
+                          "Parallelization \"simd\" requires a function supporting batched "
+                          "evaluation, such as an SXFunction. Got " + f_.type_name() + ".");
+
+    // Allocate sufficient memory for a batch
+    alloc_w(f_.sz_w() * batch_size_);
+  }
+
+  Dict MapSimd::map_options() const {
+    Dict opts = Map::map_options();
+    opts["batch_size"] = batch_size_;
+    return opts;
+  }
+
+  void MapSimd::eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
+    int n_in = this->n_in(), n_out = this->n_out();
+    const double** arg1 = arg+n_in;
+    double** res1 = res+n_out;
+    for (int i=0; i<n_; i+=batch_size_) {
+      // Input buffers
+      for (int j=0; j<n_in; ++j) {
+        arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : 0;
+      }
+      // Output buffers
+      for (int j=0; j<n_out; ++j) {
+        res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : 0;
+      }
+      // Evaluate the batch
+      f_.eval_batch(arg1, res1, iw, w, std::min(batch_size_, n_-i));
+    }
+  }
+
 } // namespace casadi
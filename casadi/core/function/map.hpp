@@ -70,7 +70,7 @@ namespace casadi {
 
     /** \brief  Evaluate or propagate sparsities */
     template<typename T>
-    void evalGen(const T** arg, T** res, int* iw, T* w) const;
+    void evalGen(const T** arg, T** res, int* iw, T* w, int mem=0) const;
 
     /// Evaluate the function numerically
     virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
@@ -123,6 +123,9 @@ namespace casadi {
     virtual int get_n_reverse() const { return 64;}
     ///@}
 
+    /** \brief Options for the maps of the derivative functions */
+    virtual Dict map_options() const;
+
   protected:
     // Constructor (protected, use create function)
     Map(const std::string& name, const Function& f, int n);
@@ -163,6 +166,98 @@ namespace casadi {
     virtual void generateBody(CodeGenerator& g) const;
   };
 
+  /** A map Evaluate in parallel using a pool of C++11 threads
+      Contrary to MapOmp, the work vectors are allocated per worker thread rather
+      than per evaluation, so the memory use does not grow with the number of
+      evaluations. The evaluations are claimed in chunks by the workers.
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_EXPORT MapThread : public Map {
+    friend class Map;
+  protected:
+    // Constructor (protected, use create function in Map)
+    MapThread(const std::string& name, const Function& f, int n) : Map(name, f, n) {}
+
+    /** \brief  Destructor */
+    virtual ~MapThread();
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    virtual void init(const Dict& opts);
+
+    /// Type of parallellization
+    virtual std::string parallelization() const { return "thread"; }
+
+    /** \brief Options for the maps of the derivative functions */
+    virtual Dict map_options() const;
+
+    /** \brief  Distribute the evaluations over the worker threads */
+    template<typename A, typename R, typename T, typename E>
+    void evalThread(A** arg, R** res, int* iw, T* w, E eval) const;
+
+    /// Evaluate the function numerically
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief  Propagate sparsity forward */
+    virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+
+    /** \brief  Propagate sparsity backwards */
+    virtual void sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+
+    // Maximum number of threads, as given by the user
+    int max_num_threads_;
+
+    // Number of worker threads actually used
+    int n_threads_;
+  };
+
+  /** A map Evaluate in blocks of points using batched evaluation
+      The function is evaluated for blocks of consecutive points at a time, which
+      amortizes the instruction dispatch over the points in the block and allows
+      the operations to be vectorized. Requires a function that supports batched
+      evaluation, such as an SXFunction.
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_EXPORT MapSimd : public Map {
+    friend class Map;
+  protected:
+    // Constructor (protected, use create function in Map)
+    MapSimd(const std::string& name, const Function& f, int n) : Map(name, f, n) {}
+
+    /** \brief  Destructor */
+    virtual ~MapSimd();
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    virtual void init(const Dict& opts);
+
+    /// Type of parallellization
+    virtual std::string parallelization() const { return "simd"; }
+
+    /** \brief Options for the maps of the derivative functions */
+    virtual Dict map_options() const;
+
+    /// Evaluate the function numerically
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    // Number of points evaluated together
+    int batch_size_;
+  };
+
 } // namespace casadi
 /// \endcond
 
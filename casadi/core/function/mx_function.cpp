@@ -27,9 +27,18 @@
 #include "../casadi_types.hpp"
 #include "../global_options.hpp"
 #include "../casadi_interrupt.hpp"
+#include "../mx/casadi_call.hpp"
+#include "../mx/getnonzeros.hpp"
+#include "../mx/setnonzeros.hpp"
 
 #include <stack>
 #include <typeinfo>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 
 using namespace std;
 
@@ -52,7 +61,13 @@ namespace casadi {
         "Default input values"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"cse",
+       {OT_BOOL,
+        "Merge identical subexpressions before sorting the graph"}},
+      {"num_threads",
+       {OT_INT,
+        "Number of threads used to evaluate independent nodes concurrently"}}
      }
   };
 
@@ -64,6 +79,8 @@ namespace casadi {
 
     // Default (temporary) options
     bool live_variables = true;
+    bool cse = false;
+    num_threads_ = 1;
 
     // Read options
     for (auto&& op : opts) {
@@ -71,8 +88,13 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables = op.second;
+      } else if (op.first=="cse") {
+        cse = op.second;
+      } else if (op.first=="num_threads") {
+        num_threads_ = op.second;
       }
     }
+    casadi_assert_message(num_threads_>=1, "Option \"num_threads\" must be positive");
 
     // Check/set default inputs
     if (default_in_.empty()) {
@@ -82,6 +104,15 @@ namespace casadi {
                             "Option 'default_in' has incorrect length");
     }
 
+    // Common subexpression elimination
+    if (cse) {
+      if (verbose()) {
+        userOut() << "MXFunction::init: " << Function("tmp", vector<MX>{}, out_).n_nodes()
+                  << " nodes before cse" << endl;
+      }
+      out_ = MX::cse(out_);
+    }
+
     // Stack used to sort the computational graph
     stack<MXNode*> s;
 
@@ -272,6 +303,9 @@ namespace casadi {
     }
 
     if (verbose()) {
+      if (cse) {
+        userOut() << "MXFunction::init: " << n_nodes() << " nodes after cse" << endl;
+      }
       if (live_variables) {
         userOut() << "Using live variables: work array is "
              <<  worksize << " instead of "
@@ -285,13 +319,14 @@ namespace casadi {
     workloc_.resize(worksize+1);
     fill(workloc_.begin(), workloc_.end(), -1);
     size_t wind=0, sz_w=0;
+    sz_arg_el_ = sz_res_el_ = sz_iw_el_ = 0;
     for (auto it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
       if (it->op!=OP_OUTPUT) {
         for (int c=0; c<it->res.size(); ++c) {
           if (it->res[c]>=0) {
-            alloc_arg(it->data->sz_arg());
-            alloc_res(it->data->sz_res());
-            alloc_iw(it->data->sz_iw());
+            sz_arg_el_ = max(sz_arg_el_, it->data->sz_arg());
+            sz_res_el_ = max(sz_res_el_, it->data->sz_res());
+            sz_iw_el_ = max(sz_iw_el_, it->data->sz_iw());
             sz_w = max(sz_w, it->data->sz_w());
             if (workloc_[it->res[c]] < 0) {
               workloc_[it->res[c]] = wind;
@@ -306,8 +341,74 @@ namespace casadi {
       if (workloc_[i]<0) workloc_[i] = i==0 ? 0 : workloc_[i-1];
       workloc_[i] += sz_w;
     }
+    sz_w_el_ = sz_w;
     sz_w += wind;
-    alloc_w(sz_w);
+
+    // Work vectors for the elements, one set per thread. The temporary work vector of the
+    // first thread is placed before the work vector elements, the others after
+    alloc_arg(num_threads_*sz_arg_el_);
+    alloc_res(num_threads_*sz_res_el_);
+    alloc_iw(num_threads_*sz_iw_el_);
+    alloc_w(sz_w + (num_threads_-1)*sz_w_el_);
+
+    // Dependencies between the elements of the algorithm, from the work vector accesses
+    dep_count_.clear();
+    dep_succ_ind_.clear();
+    dep_succ_.clear();
+    if (num_threads_>1) {
+      int n_alg = algorithm_.size();
+      // Last element writing to, and elements reading from since, each work vector element
+      vector<int> last_write(worksize, -1);
+      vector<vector<int> > reads(worksize);
+      // Elements preceding each element
+      vector<vector<int> > pred(n_alg);
+      for (int k=0; k<n_alg; ++k) {
+        const AlgEl& e = algorithm_[k];
+        vector<int>& p = pred[k];
+        // Work vector elements read (the arguments of inputs are not work vector elements)
+        if (e.op!=OP_INPUT) {
+          for (int a : e.arg) {
+            if (a>=0 && last_write[a]>=0) p.push_back(last_write[a]);
+          }
+        }
+        // Work vector elements written (the results of outputs are not work vector elements)
+        if (e.op!=OP_OUTPUT) {
+          for (int r : e.res) {
+            if (r<0) continue;
+            if (last_write[r]>=0) p.push_back(last_write[r]);
+            p.insert(p.end(), reads[r].begin(), reads[r].end());
+          }
+        }
+        // Update the access history
+        if (e.op!=OP_INPUT) {
+          for (int a : e.arg) if (a>=0) reads[a].push_back(k);
+        }
+        if (e.op!=OP_OUTPUT) {
+          for (int r : e.res) {
+            if (r<0) continue;
+            last_write[r] = k;
+            reads[r].clear();
+          }
+        }
+        // Remove self-references (in-place operations) and duplicates
+        sort(p.begin(), p.end());
+        p.erase(unique(p.begin(), p.end()), p.end());
+        p.erase(remove(p.begin(), p.end(), k), p.end());
+      }
+      // Transpose to get the successors in compressed format
+      dep_count_.resize(n_alg);
+      dep_succ_ind_.resize(n_alg+1, 0);
+      for (int k=0; k<n_alg; ++k) {
+        dep_count_[k] = pred[k].size();
+        for (int j : pred[k]) dep_succ_ind_[j+1]++;
+      }
+      for (int k=0; k<n_alg; ++k) dep_succ_ind_[k+1] += dep_succ_ind_[k];
+      dep_succ_.resize(dep_succ_ind_.back());
+      vector<int> pos(dep_succ_ind_.begin(), dep_succ_ind_.end()-1);
+      for (int k=0; k<n_alg; ++k) {
+        for (int j : pred[k]) dep_succ_[pos[j]++] = k;
+      }
+    }
 
     // Reset the temporary variables
     for (int i=0; i<nodes.size(); ++i) {
@@ -383,38 +484,128 @@ namespace casadi {
                    << free_vars_ << " are free.");
     }
 
-    // Evaluate all of the nodes of the algorithm:
-    // should only evaluate nodes that have not yet been calculated!
-    for (auto&& e : algorithm_) {
-      if (e.op==OP_INPUT) {
-        // Pass an input
-        double *w1 = w+workloc_[e.res.front()];
-        int nnz=e.data.nnz();
-        int i=e.arg.at(0);
-        int nz_offset=e.arg.at(2);
-        if (arg[i]==0) {
-          fill(w1, w1+nnz, 0);
-        } else {
-          copy(arg[i]+nz_offset, arg[i]+nz_offset+nnz, w1);
-        }
-      } else if (e.op==OP_OUTPUT) {
-        // Get an output
-        double *w1 = w+workloc_[e.arg.front()];
-        int i=e.res.front();
-        if (res[i]!=0) copy(w1, w1+nnz_out(i), res[i]);
-      } else {
-        // Point pointers to the data corresponding to the element
-        for (int i=0; i<e.arg.size(); ++i)
-          arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : 0;
-        for (int i=0; i<e.res.size(); ++i)
-          res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : 0;
+    // Evaluate independent nodes concurrently
+    if (num_threads_>1) {
+      eval_threaded(arg, res, iw, w);
+    } else {
+      // Evaluate all of the nodes of the algorithm:
+      // should only evaluate nodes that have not yet been calculated!
+      for (auto&& e : algorithm_) eval_el(e, arg, res, arg1, res1, iw, w, w);
+    }
 
-        // Evaluate
-        e.data->eval(arg1, res1, iw, w, 0);
+    casadi_msg("MXFunction::eval():end "  << name_);
+  }
+
+  void MXFunction::eval_el(const AlgEl& e, const double** arg, double** res,
+                            const double** arg1, double** res1, int* iw, double* w,
+                            double* ws) const {
+    if (e.op==OP_INPUT) {
+      // Pass an input
+      double *w1 = w+workloc_[e.res.front()];
+      int nnz=e.data.nnz();
+      int i=e.arg.at(0);
+      int nz_offset=e.arg.at(2);
+      if (arg[i]==0) {
+        fill(w1, w1+nnz, 0);
+      } else {
+        copy(arg[i]+nz_offset, arg[i]+nz_offset+nnz, w1);
       }
+    } else if (e.op==OP_OUTPUT) {
+      // Get an output
+      double *w1 = w+workloc_[e.arg.front()];
+      int i=e.res.front();
+      if (res[i]!=0) copy(w1, w1+nnz_out(i), res[i]);
+    } else {
+      // Point pointers to the data corresponding to the element
+      for (int i=0; i<e.arg.size(); ++i)
+        arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : 0;
+      for (int i=0; i<e.res.size(); ++i)
+        res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : 0;
+
+      // Evaluate
+      e.data->eval(arg1, res1, iw, ws, 0);
     }
+  }
 
-    casadi_msg("MXFunction::eval():end "  << name_);
+  void MXFunction::eval_threaded(const double** arg, double** res, int* iw, double* w) const {
+    int n_alg = algorithm_.size();
+
+    // Number of unfinished dependencies for each element
+    std::vector<std::atomic<int> > count(n_alg);
+    for (int k=0; k<n_alg; ++k) count[k] = dep_count_[k];
+
+    // Elements ready for evaluation, shared between the threads
+    std::vector<int> ready;
+    for (int k=0; k<n_alg; ++k) if (dep_count_[k]==0) ready.push_back(k);
+    std::mutex mtx;
+    std::condition_variable cv;
+    int n_done = 0;
+    bool abort = false;
+
+    // Exceptions are passed on to the calling thread
+    std::vector<std::exception_ptr> err(num_threads_);
+
+    // Work performed by each thread
+    std::function<void(int)> work([&](int t) {
+      const double** arg1 = arg + n_in() + t*sz_arg_el_;
+      double** res1 = res + n_out() + t*sz_res_el_;
+      int* iw1 = iw + t*sz_iw_el_;
+      double* ws = t==0 ? w : w + workloc_.back() + (t-1)*sz_w_el_;
+      int k = -1;
+      try {
+        while (true) {
+          // Get an element from the queue unless one is already at hand
+          if (k<0) {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return abort || n_done==n_alg || !ready.empty();});
+            if (abort || n_done==n_alg) break;
+            k = ready.back();
+            ready.pop_back();
+          }
+
+          // Evaluate
+          eval_el(algorithm_[k], arg, res, arg1, res1, iw1, w, ws);
+
+          // Release the successors, continue with the first one that becomes ready
+          int next = -1;
+          std::vector<int> released;
+          for (int i=dep_succ_ind_[k]; i<dep_succ_ind_[k+1]; ++i) {
+            int j = dep_succ_[i];
+            if (--count[j]==0) {
+              if (next<0) {
+                next = j;
+              } else {
+                released.push_back(j);
+              }
+            }
+          }
+          bool finished;
+          {
+            std::lock_guard<std::mutex> lock(mtx);
+            finished = ++n_done==n_alg;
+            ready.insert(ready.end(), released.begin(), released.end());
+          }
+          if (!released.empty() || finished) cv.notify_all();
+          k = next;
+        }
+      } catch (...) {
+        err[t] = std::current_exception();
+        // Stop the other workers
+        std::lock_guard<std::mutex> lock(mtx);
+        abort = true;
+        cv.notify_all();
+      }
+    });
+
+    // Launch the workers, the calling thread acts as the first one
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads_-1);
+    for (int t=1; t<num_threads_; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto&& th : workers) th.join();
+
+    // Rethrow the first exception, if any
+    for (auto&& e : err) if (e) std::rethrow_exception(e);
   }
 
   void MXFunction::print(ostream &stream, const AlgEl& el) const {
@@ -1322,6 +1513,290 @@ namespace casadi {
     return in_;
   }
 
+  void MXFunction::serialize(Serializer& s) const {
+    s.pack("MXFunction");
+    s.pack(name_);
+    s.pack(ischeme_);
+    s.pack(oscheme_);
+
+    // Symbolic inputs
+    s.pack(static_cast<int>(in_.size()));
+    for (auto&& i : in_) {
+      casadi_assert_message(i.is_symbolic(), "MXFunction::serialize: Function \"" + name_
+                            + "\" has inputs that are not purely symbolic");
+      s.pack(i.name());
+      s.pack(i.sparsity());
+    }
+    s.pack(static_cast<int>(out_.size()));
+
+    // The algorithm, one element at a time
+    s.pack(static_cast<int>(workloc_.size()-1));
+    s.pack(static_cast<int>(algorithm_.size()));
+    for (auto&& e : algorithm_) {
+      s.pack(e.op);
+      s.pack(e.arg);
+      s.pack(e.res);
+      if (e.op==OP_INPUT || e.op==OP_OUTPUT) continue;
+
+      // Dimensions of arguments not in the work vector
+      for (int i=0; i<e.arg.size(); ++i) {
+        if (e.arg[i]<0) {
+          s.pack(e.data->dep(i).size1());
+          s.pack(e.data->dep(i).size2());
+        }
+      }
+
+      // Data needed to recreate the node
+      switch (e.op) {
+      case OP_PARAMETER:
+        s.pack(e.data.name());
+        s.pack(e.data.sparsity());
+        break;
+      case OP_CONST:
+        s.pack(e.data->getMatrixValue());
+        break;
+      case OP_CALL:
+        s.pack(e.data->getFunction(0));
+        break;
+      case OP_GETNONZEROS:
+        s.pack(e.data.sparsity());
+        s.pack(static_cast<const GetNonzeros*>(e.data.get())->all());
+        break;
+      case OP_SETNONZEROS:
+        s.pack(static_cast<const SetNonzeros<false>*>(e.data.get())->all());
+        break;
+      case OP_ADDNONZEROS:
+        s.pack(static_cast<const SetNonzeros<true>*>(e.data.get())->all());
+        break;
+      case OP_RESHAPE:
+      case OP_PROJECT:
+        s.pack(e.data.sparsity());
+        break;
+      case OP_HORZSPLIT:
+      case OP_VERTSPLIT:
+      case OP_DIAGSPLIT:
+        s.pack(e.data->nout());
+        for (int i=0; i<e.data->nout(); ++i) s.pack(e.data->sparsity(i));
+        break;
+      case OP_HORZREPMAT:
+        s.pack(e.data.size2()/e.data->dep(0).size2());
+        break;
+      case OP_HORZREPSUM:
+        s.pack(e.data->dep(0).size2()/e.data.size2());
+        break;
+      case OP_MTIMES:
+      case OP_TRANSPOSE:
+      case OP_HORZCAT:
+      case OP_VERTCAT:
+      case OP_DIAGCAT:
+      case OP_DETERMINANT:
+      case OP_INVERSE:
+      case OP_DOT:
+      case OP_BILIN:
+      case OP_RANK1:
+      case OP_NORMF:
+      case OP_NORM2:
+      case OP_NORM1:
+      case OP_NORMINF:
+        break;
+      default:
+        casadi_assert_message(e.op<OP_CONST || e.op==OP_ERFINV || e.op==OP_PRINTME
+                              || e.op==OP_LIFT,
+                              "MXFunction::serialize: Function \"" + name_
+                              + "\" contains an unsupported operation: " + e.data->type_name());
+      }
+    }
+
+    // Options
+    s.pack(default_in_);
+    s.pack(num_threads_);
+  }
+
+  Function MXFunction::deserialize(Deserializer& s) {
+    string name;
+    vector<string> ischeme, oscheme;
+    s.unpack(name);
+    s.unpack(ischeme);
+    s.unpack(oscheme);
+
+    // Symbolic inputs
+    int n;
+    s.unpack(n);
+    s.check(n>=0, "bad number of inputs");
+    vector<MX> arg(n);
+    for (auto&& i : arg) {
+      string i_name;
+      Sparsity sp;
+      s.unpack(i_name);
+      s.unpack(sp);
+      i = MX::sym(i_name, sp);
+    }
+    s.unpack(n);
+    s.check(n>=0, "bad number of outputs");
+    vector<MX> res(n);
+
+    // Rebuild the expression graph by executing the algorithm symbolically
+    int worksize, n_alg;
+    s.unpack(worksize);
+    s.unpack(n_alg);
+    s.check(worksize>=0 && n_alg>=0, "bad algorithm size");
+    vector<MX> swork(worksize), arg1, res1;
+    AlgEl e;
+    for (int k=0; k<n_alg; ++k) {
+      s.unpack(e.op);
+      s.unpack(e.arg);
+      s.unpack(e.res);
+      if (e.op==OP_INPUT) {
+        s.check(e.arg.size()==3 && e.arg[0]>=0 && e.arg[0]<arg.size() && e.arg[1]==0
+                && e.res.size()==1 && e.res[0]>=0 && e.res[0]<worksize,
+                "bad input instruction");
+        swork[e.res[0]] = arg[e.arg[0]];
+        continue;
+      } else if (e.op==OP_OUTPUT) {
+        s.check(e.arg.size()==1 && e.arg[0]>=0 && e.arg[0]<worksize && e.res.size()==1
+                && e.res[0]>=0 && e.res[0]<res.size(), "bad output instruction");
+        res[e.res[0]] = swork[e.arg[0]];
+        continue;
+      }
+      for (int el : e.arg) s.check(el<worksize, "bad work vector index");
+      for (int el : e.res) s.check(el<worksize, "bad work vector index");
+
+      // Arguments of the operation
+      arg1.resize(e.arg.size());
+      for (int i=0; i<arg1.size(); ++i) {
+        if (e.arg[i]<0) {
+          int nrow, ncol;
+          s.unpack(nrow);
+          s.unpack(ncol);
+          arg1[i] = MX(nrow, ncol);
+        } else {
+          arg1[i] = swork[e.arg[i]];
+        }
+      }
+
+      // Perform the operation
+      res1.resize(e.res.size());
+      Sparsity sp;
+      vector<int> nz;
+      switch (e.op) {
+      case OP_PARAMETER:
+        {
+          string p_name;
+          s.unpack(p_name);
+          s.unpack(sp);
+          res1[0] = MX::sym(p_name, sp);
+        }
+        break;
+      case OP_CONST:
+        {
+          DM v;
+          s.unpack(v);
+          res1[0] = v;
+        }
+        break;
+      case OP_CALL:
+        {
+          Function f;
+          s.unpack(f);
+          s.check(!f.is_null() && f.n_in()==arg1.size() && f.n_out()==res1.size(),
+                  "bad function call");
+          res1 = Call::create(f, arg1);
+        }
+        break;
+      case OP_GETNONZEROS:
+        s.unpack(sp);
+        s.unpack(nz);
+        res1[0] = arg1.at(0)->getGetNonzeros(sp, nz);
+        break;
+      case OP_SETNONZEROS:
+        s.unpack(nz);
+        res1[0] = arg1.at(1)->getSetNonzeros(arg1.at(0), nz);
+        break;
+      case OP_ADDNONZEROS:
+        s.unpack(nz);
+        res1[0] = arg1.at(1)->getAddNonzeros(arg1.at(0), nz);
+        break;
+      case OP_RESHAPE:
+        s.unpack(sp);
+        res1[0] = reshape(arg1.at(0), sp);
+        break;
+      case OP_PROJECT:
+        s.unpack(sp);
+        res1[0] = project(arg1.at(0), sp);
+        break;
+      case OP_HORZSPLIT:
+      case OP_VERTSPLIT:
+      case OP_DIAGSPLIT:
+        {
+          s.unpack(n);
+          s.check(n==res1.size(), "bad split");
+          vector<int> offset1(1, 0), offset2(1, 0);
+          for (int i=0; i<n; ++i) {
+            s.unpack(sp);
+            offset1.push_back(offset1.back() + sp.size1());
+            offset2.push_back(offset2.back() + sp.size2());
+          }
+          if (e.op==OP_HORZSPLIT) {
+            res1 = horzsplit(arg1.at(0), offset2);
+          } else if (e.op==OP_VERTSPLIT) {
+            res1 = vertsplit(arg1.at(0), offset1);
+          } else {
+            res1 = diagsplit(arg1.at(0), offset1, offset2);
+          }
+        }
+        break;
+      case OP_HORZREPMAT:
+        s.unpack(n);
+        res1[0] = arg1.at(0)->getRepmat(1, n);
+        break;
+      case OP_HORZREPSUM:
+        s.unpack(n);
+        res1[0] = arg1.at(0)->getRepsum(1, n);
+        break;
+      case OP_MTIMES: res1[0] = MX::mac(arg1.at(1), arg1.at(2), arg1.at(0)); break;
+      case OP_TRANSPOSE: res1[0] = arg1.at(0).T(); break;
+      case OP_HORZCAT: res1[0] = horzcat(arg1); break;
+      case OP_VERTCAT: res1[0] = vertcat(arg1); break;
+      case OP_DIAGCAT: res1[0] = diagcat(arg1); break;
+      case OP_DETERMINANT: res1[0] = det(arg1.at(0)); break;
+      case OP_INVERSE: res1[0] = inv(arg1.at(0)); break;
+      case OP_DOT: res1[0] = arg1.at(0)->getDot(arg1.at(1)); break;
+      case OP_BILIN: res1[0] = bilin(arg1.at(0), arg1.at(1), arg1.at(2)); break;
+      case OP_RANK1: res1[0] = rank1(arg1.at(0), arg1.at(1), arg1.at(2), arg1.at(3)); break;
+      case OP_NORMF: res1[0] = arg1.at(0)->getNormF(); break;
+      case OP_NORM2: res1[0] = arg1.at(0)->getNorm2(); break;
+      case OP_NORM1: res1[0] = arg1.at(0)->getNorm1(); break;
+      case OP_NORMINF: res1[0] = arg1.at(0)->getNormInf(); break;
+      default:
+        {
+          s.check(e.op<OP_CONST || e.op==OP_ERFINV || e.op==OP_PRINTME || e.op==OP_LIFT,
+                  "unknown operation");
+          s.check(arg1.size()==casadi_math<MX>::ndeps(e.op), "bad number of arguments");
+          MX dummy;
+          casadi_math<MX>::fun(e.op, arg1.at(0), arg1.size()>1 ? arg1[1] : dummy, res1.at(0));
+        }
+      }
+
+      // Get the results
+      s.check(res1.size()==e.res.size(), "bad number of results");
+      for (int i=0; i<res1.size(); ++i) {
+        if (e.res[i]>=0) swork[e.res[i]] = res1[i];
+      }
+    }
+
+    // Options
+    vector<double> default_in;
+    int num_threads;
+    s.unpack(default_in);
+    s.unpack(num_threads);
+    Dict opts;
+    opts["input_scheme"] = ischeme;
+    opts["output_scheme"] = oscheme;
+    opts["default_in"] = default_in;
+    opts["num_threads"] = num_threads;
+    return Function(name, arg, res, opts);
+  }
+
   std::string MXFunction::type_name() const {
     return "mxfunction";
   }
@@ -87,6 +87,25 @@ namespace casadi {
     /** \brief  Evaluate numerically, work vectors given */
     virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
 
+    /** \brief  Evaluate an element of the algorithm, ws is the work vector for the node */
+    void eval_el(const AlgEl& e, const double** arg, double** res, const double** arg1,
+                 double** res1, int* iw, double* w, double* ws) const;
+
+    /** \brief  Evaluate independent elements of the algorithm concurrently */
+    void eval_threaded(const double** arg, double** res, int* iw, double* w) const;
+
+    /// Number of threads for evaluating independent elements concurrently
+    int num_threads_;
+
+    /// Number of elements each element of the algorithm depends on
+    std::vector<int> dep_count_;
+
+    /// Elements depending on each element of the algorithm (compressed)
+    std::vector<int> dep_succ_ind_, dep_succ_;
+
+    /// Largest work vectors needed by an element of the algorithm
+    size_t sz_arg_el_, sz_res_el_, sz_iw_el_, sz_w_el_;
+
     /** \brief  Print description */
     virtual void print(std::ostream &stream) const;
 
@@ -105,6 +124,12 @@ namespace casadi {
     /** \brief  Initialize */
     virtual void init(const Dict& opts);
 
+    /** \brief Serialize the algorithm, see Function::save */
+    virtual void serialize(Serializer& s) const;
+
+    /** \brief Restore a function written by serialize */
+    static Function deserialize(Deserializer& s);
+
     /** \brief Generate code for the declarations of the C function */
     virtual void generateDeclarations(CodeGenerator& g) const;
 
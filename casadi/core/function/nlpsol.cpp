@@ -309,6 +309,53 @@ namespace casadi {
     }
   }
 
+  void Nlpsol::serialize(Serializer& s) const {
+    s.pack("Nlpsol");
+    s.pack(name_);
+    s.pack(plugin_name());
+    s.pack(oracle_);
+
+    // Options, the oracle has already been expanded if requested
+    Dict opts = init_opts_;
+    opts.erase("expand");
+    s.pack(opts);
+
+    // Functions generated from the oracle
+    s.pack(static_cast<int>(all_functions_.size()));
+    for (auto&& i : all_functions_) {
+      s.pack(i.first);
+      s.pack(i.second.f);
+    }
+  }
+
+  Function Nlpsol::deserialize(Deserializer& s) {
+    string name, plugin;
+    Function oracle;
+    Dict opts;
+    s.unpack(name);
+    s.unpack(plugin);
+    s.unpack(oracle);
+    s.unpack(opts);
+    int n;
+    s.unpack(n);
+    s.check(n>=0, "bad number of functions");
+    map<string, Function> precomputed;
+    for (int i=0; i<n; ++i) {
+      string fname;
+      s.unpack(fname);
+      s.unpack(precomputed[fname]);
+    }
+
+    // Create the solver, reusing the functions instead of generating them again
+    Function ret;
+    Nlpsol* node = instantiatePlugin(name, plugin, oracle);
+    ret.assignNode(node);
+    node->precomputed_ = precomputed;
+    ret->construct(opts);
+    node->precomputed_.clear();
+    return ret;
+  }
+
   void Nlpsol::init_memory(void* mem) const {
     OracleFunction::init_memory(mem);
     auto m = static_cast<NlpsolMemory*>(mem);
@@ -118,6 +118,12 @@ namespace casadi {
     /// Initialize
     virtual void init(const Dict& opts);
 
+    /** \brief Serialize the solver and the functions it has created, see Function::save */
+    virtual void serialize(Serializer& s) const;
+
+    /** \brief Restore a solver written by serialize */
+    static Function deserialize(Deserializer& s);
+
     /** \brief Create memory block */
     virtual void* alloc_memory() const { return new NlpsolMemory();}
 
@@ -59,6 +59,9 @@ namespace casadi {
 
     FunctionInternal::init(opts);
 
+    // Keep the options for serialization
+    init_opts_ = opts;
+
     // Read options
     for (auto&& op : opts) {
       if (op.first=="common_options") {
@@ -121,8 +124,10 @@ namespace casadi {
     // Combine specific and common options
     Dict opt = combine(specific_options, common_options_);
 
-    // Generate the function
-    Function ret = oracle_.factory(fname, s_in, s_out, aux, opt);
+    // Generate the function, unless restored by deserialization
+    auto pc = precomputed_.find(fname);
+    Function ret = pc!=precomputed_.end() ? pc->second
+      : oracle_.factory(fname, s_in, s_out, aux, opt);
     set_function(ret, fname, true);
     return ret;
   }
@@ -257,8 +262,12 @@ namespace casadi {
     if (verbose())
       log("OracleFunction::jit_dependencies", "compiling to "+ fname+"'.");
     // JIT dependent functions
-    compiler_ = Importer(generate_dependencies(fname, Dict()),
-                         compilerplugin_, jit_options_);
+    CodeGenerator gen(fname, jit_codegen_options_);
+    gen.add(oracle_);
+    for (auto&& e : all_functions_) {
+      if (e.second.jit) gen.add(e.second.f);
+    }
+    compiler_ = jit_compile(gen);
 
     // Replace the Oracle functions with generated functions
     for (auto&& e : all_functions_) {
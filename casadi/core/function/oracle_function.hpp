@@ -42,6 +42,9 @@ namespace casadi {
 
     // Function specific statistics
     std::map<std::string, FStats> fstats;
+
+    // Destructor, derived memory is freed through this class
+    virtual ~OracleMemory() {}
   };
 
   /** \brief Base class for functions that perform calculation with an oracle
@@ -66,6 +69,12 @@ namespace casadi {
 
     // All NLP functions
     std::map<std::string, RegFun> all_functions_;
+
+    // Functions restored by deserialization, used by create_function if available
+    std::map<std::string, Function> precomputed_;
+
+    // Options passed at construction
+    Dict init_opts_;
   public:
     /** \brief  Constructor */
     OracleFunction(const std::string& name, const Function& oracle);
@@ -112,6 +112,12 @@ namespace casadi {
     /// Load and get the creator function
     static Plugin& getPlugin(const std::string& pname);
 
+    /// Protects the collection of plugins, which may be loaded from several threads
+    static std::recursive_mutex& plugin_mutex() {
+      static std::recursive_mutex m;
+      return m;
+    }
+
     // Create solver instance
     template<class Problem>
       static Derived* instantiatePlugin(const std::string& fname,
@@ -122,6 +128,7 @@ namespace casadi {
 
   template<class Derived>
   bool PluginInterface<Derived>::has_plugin(const std::string& pname, bool verbose) {
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
 
     // Quick return if available
     if (Derived::solvers_.find(pname) != Derived::solvers_.end()) {
@@ -332,6 +339,7 @@ namespace casadi {
 
   template<class Derived>
   void PluginInterface<Derived>::registerPlugin(const Plugin& plugin) {
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
 
     // Check if the solver name is in use
     typename std::map<std::string, Plugin>::iterator it=Derived::solvers_.find(plugin.name);
@@ -345,6 +353,7 @@ namespace casadi {
   template<class Derived>
   typename PluginInterface<Derived>::Plugin&
   PluginInterface<Derived>::getPlugin(const std::string& pname) {
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
 
     // Check if the solver has been loaded
     auto it=Derived::solvers_.find(pname);
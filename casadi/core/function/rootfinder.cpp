@@ -169,8 +169,15 @@ Function Function::rootfinder_fun() {
 
   void Rootfinder::init_memory(void* mem) const {
     OracleFunction::init_memory(mem);
-    //auto m = static_cast<RootfinderMemory*>(mem);
-    linsol_.reset(sp_jac_);
+    auto m = static_cast<RootfinderMemory*>(mem);
+    m->mem_linsol = linsol_.checkout();
+    linsol_.reset(sp_jac_, m->mem_linsol);
+  }
+
+  void Rootfinder::free_memory(void *mem) const {
+    auto m = static_cast<RootfinderMemory*>(mem);
+    linsol_.release(m->mem_linsol);
+    delete m;
   }
 
   void Rootfinder::eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
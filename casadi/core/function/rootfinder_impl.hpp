@@ -40,6 +40,9 @@ namespace casadi {
 
     // Outputs
     double** ires;
+
+    // Memory object of the linear solver
+    int mem_linsol;
   };
 
   /// Internal class
@@ -84,6 +87,9 @@ namespace casadi {
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
 
+    /** \brief Free memory block */
+    virtual void free_memory(void *mem) const;
+
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
                           int*& iw, double*& w) const;
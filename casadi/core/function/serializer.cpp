@@ -0,0 +1,304 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "serializer.hpp"
+#include "sx_function.hpp"
+#include "mx_function.hpp"
+#include "nlpsol_impl.hpp"
+#include <cstring>
+
+using namespace std;
+namespace casadi {
+
+  // Markers preceding a function or sparsity pattern
+  enum SerializerMarker {SER_NEW=-1, SER_NULL=-2};
+
+  Serializer::Serializer() {
+  }
+
+  void Serializer::pack_raw(const void* e, size_t sz) {
+    buf_.append(static_cast<const char*>(e), sz);
+  }
+
+  void Serializer::pack(int e) {
+    pack_raw(&e, sizeof(e));
+  }
+
+  void Serializer::pack(bool e) {
+    pack(static_cast<int>(e));
+  }
+
+  void Serializer::pack(double e) {
+    pack_raw(&e, sizeof(e));
+  }
+
+  void Serializer::pack(const string& e) {
+    pack(static_cast<int>(e.size()));
+    pack_raw(e.data(), e.size());
+  }
+
+  void Serializer::pack(const vector<int>& e) {
+    pack(static_cast<int>(e.size()));
+    if (!e.empty()) pack_raw(&e.front(), e.size()*sizeof(int));
+  }
+
+  void Serializer::pack(const vector<double>& e) {
+    pack(static_cast<int>(e.size()));
+    if (!e.empty()) pack_raw(&e.front(), e.size()*sizeof(double));
+  }
+
+  void Serializer::pack(const vector<string>& e) {
+    pack(static_cast<int>(e.size()));
+    for (auto&& i : e) pack(i);
+  }
+
+  void Serializer::pack(const Sparsity& e) {
+    // Already written?
+    auto it = sparsities_.find(e.get());
+    if (it!=sparsities_.end()) return pack(it->second);
+
+    // Write pattern
+    pack(static_cast<int>(SER_NEW));
+    pack(e.size1());
+    pack(e.size2());
+    pack(e.get_colind());
+    pack(e.get_row());
+    int ind = sparsities_.size();
+    sparsities_[e.get()] = ind;
+  }
+
+  void Serializer::pack(const DM& e) {
+    pack(e.sparsity());
+    pack(e.nonzeros());
+  }
+
+  void Serializer::pack(const GenericType& e) {
+    pack(static_cast<int>(e.getType()));
+    switch (e.getType()) {
+    case OT_NULL: break;
+    case OT_BOOL: pack(e.as_bool()); break;
+    case OT_INT: pack(e.as_int()); break;
+    case OT_DOUBLE: pack(e.as_double()); break;
+    case OT_STRING: pack(e.as_string()); break;
+    case OT_INTVECTOR: pack(e.as_int_vector()); break;
+    case OT_BOOLVECTOR: pack(e.as_bool_vector()); break;
+    case OT_DOUBLEVECTOR: pack(e.as_double_vector()); break;
+    case OT_STRINGVECTOR: pack(e.as_string_vector()); break;
+    case OT_DICT: pack(e.as_dict()); break;
+    case OT_FUNCTION: pack(e.as_function()); break;
+    case OT_INTVECTORVECTOR:
+      {
+        const vector<vector<int> >& v = e.as_int_vector_vector();
+        pack(static_cast<int>(v.size()));
+        for (auto&& i : v) pack(i);
+      }
+      break;
+    default:
+      casadi_error("Cannot serialize option of type " + e.get_description());
+    }
+  }
+
+  void Serializer::pack(const Dict& e) {
+    pack(static_cast<int>(e.size()));
+    for (auto&& i : e) {
+      pack(i.first);
+      pack(i.second);
+    }
+  }
+
+  void Serializer::pack(const Function& e) {
+    if (e.is_null()) return pack(static_cast<int>(SER_NULL));
+
+    // Already written?
+    auto it = functions_.find(e.get());
+    if (it!=functions_.end()) return pack(it->second);
+
+    // Write function, nested functions are written first
+    pack(static_cast<int>(SER_NEW));
+    e->serialize(*this);
+    int ind = functions_.size();
+    functions_[e.get()] = ind;
+  }
+
+  Deserializer::Deserializer(const char* data, size_t sz) : pos_(data), end_(data+sz) {
+  }
+
+  void Deserializer::corrupt(const char* what) const {
+    casadi_error("Deserializer: Corrupt data, " + string(what));
+  }
+
+  void Deserializer::unpack_raw(void* e, size_t sz) {
+    check(sz<=static_cast<size_t>(end_-pos_), "unexpected end of data");
+    memcpy(e, pos_, sz);
+    pos_ += sz;
+  }
+
+  void Deserializer::unpack(int& e) {
+    unpack_raw(&e, sizeof(e));
+  }
+
+  void Deserializer::unpack(bool& e) {
+    int i;
+    unpack(i);
+    e = i!=0;
+  }
+
+  void Deserializer::unpack(double& e) {
+    unpack_raw(&e, sizeof(e));
+  }
+
+  void Deserializer::unpack(string& e) {
+    int n;
+    unpack(n);
+    check(n>=0 && n<=end_-pos_, "bad string length");
+    e.assign(pos_, n);
+    pos_ += n;
+  }
+
+  void Deserializer::unpack(vector<int>& e) {
+    int n;
+    unpack(n);
+    check(n>=0, "bad vector length");
+    e.resize(n);
+    if (n>0) unpack_raw(&e.front(), n*sizeof(int));
+  }
+
+  void Deserializer::unpack(vector<double>& e) {
+    int n;
+    unpack(n);
+    check(n>=0, "bad vector length");
+    e.resize(n);
+    if (n>0) unpack_raw(&e.front(), n*sizeof(double));
+  }
+
+  void Deserializer::unpack(vector<string>& e) {
+    int n;
+    unpack(n);
+    check(n>=0, "bad vector length");
+    e.resize(n);
+    for (auto&& i : e) unpack(i);
+  }
+
+  void Deserializer::unpack(Sparsity& e) {
+    int ind;
+    unpack(ind);
+    if (ind!=SER_NEW) {
+      check(ind>=0 && ind<sparsities_.size(), "bad sparsity reference");
+      e = sparsities_[ind];
+      return;
+    }
+    int nrow, ncol;
+    vector<int> colind, row;
+    unpack(nrow);
+    unpack(ncol);
+    unpack(colind);
+    unpack(row);
+    e = Sparsity(nrow, ncol, colind, row);
+    sparsities_.push_back(e);
+  }
+
+  void Deserializer::unpack(DM& e) {
+    Sparsity sp;
+    vector<double> nz;
+    unpack(sp);
+    unpack(nz);
+    check(nz.size()==sp.nnz(), "nonzero count mismatch");
+    e = DM(sp, nz);
+  }
+
+  void Deserializer::unpack(GenericType& e) {
+    int t;
+    unpack(t);
+    switch (t) {
+    case OT_NULL: e = GenericType(); break;
+    case OT_BOOL: { bool v; unpack(v); e = v;} break;
+    case OT_INT: { int v; unpack(v); e = v;} break;
+    case OT_DOUBLE: { double v; unpack(v); e = v;} break;
+    case OT_STRING: { string v; unpack(v); e = v;} break;
+    case OT_INTVECTOR: { vector<int> v; unpack(v); e = v;} break;
+    case OT_BOOLVECTOR:
+      {
+        vector<int> v;
+        unpack(v);
+        e = vector<bool>(v.begin(), v.end());
+      }
+      break;
+    case OT_DOUBLEVECTOR: { vector<double> v; unpack(v); e = v;} break;
+    case OT_STRINGVECTOR: { vector<string> v; unpack(v); e = v;} break;
+    case OT_DICT: { Dict v; unpack(v); e = v;} break;
+    case OT_FUNCTION: { Function v; unpack(v); e = v;} break;
+    case OT_INTVECTORVECTOR:
+      {
+        int n;
+        unpack(n);
+        check(n>=0, "bad vector length");
+        vector<vector<int> > v(n);
+        for (auto&& i : v) unpack(i);
+        e = v;
+      }
+      break;
+    default:
+      check(false, "unknown option type");
+    }
+  }
+
+  void Deserializer::unpack(Dict& e) {
+    int n;
+    unpack(n);
+    check(n>=0, "bad dictionary size");
+    e.clear();
+    for (int i=0; i<n; ++i) {
+      string key;
+      unpack(key);
+      unpack(e[key]);
+    }
+  }
+
+  void Deserializer::unpack(Function& e) {
+    int ind;
+    unpack(ind);
+    if (ind==SER_NULL) {
+      e = Function();
+    } else if (ind!=SER_NEW) {
+      check(ind>=0 && ind<functions_.size(), "bad function reference");
+      e = functions_[ind];
+    } else {
+      // Dispatch on the class
+      string cl;
+      unpack(cl);
+      if (cl=="SXFunction") {
+        e = SXFunction::deserialize(*this);
+      } else if (cl=="MXFunction") {
+        e = MXFunction::deserialize(*this);
+      } else if (cl=="Nlpsol") {
+        e = Nlpsol::deserialize(*this);
+      } else {
+        casadi_error("Deserializer: Unknown function class '" + cl + "'");
+      }
+      functions_.push_back(e);
+    }
+  }
+
+} // namespace casadi
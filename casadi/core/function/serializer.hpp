@@ -0,0 +1,134 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_SERIALIZER_HPP
+#define CASADI_SERIALIZER_HPP
+
+#include "function.hpp"
+#include <map>
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Helper class for writing functions to the binary format of Function::save
+
+      Data is appended to a byte buffer in native byte order. Functions and
+      sparsity patterns that occur more than once are written only the first
+      time and referred to by index afterwards.
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_EXPORT Serializer {
+  public:
+    /// Constructor
+    Serializer();
+
+    ///@{
+    /// Append data to the buffer
+    void pack(int e);
+    void pack(bool e);
+    void pack(double e);
+    void pack(const std::string& e);
+    void pack(const char* e) { pack(std::string(e));}
+    void pack(const std::vector<int>& e);
+    void pack(const std::vector<double>& e);
+    void pack(const std::vector<std::string>& e);
+    void pack(const Sparsity& e);
+    void pack(const DM& e);
+    void pack(const GenericType& e);
+    void pack(const Dict& e);
+    void pack(const Function& e);
+    ///@}
+
+    /// Append raw bytes
+    void pack_raw(const void* e, size_t sz);
+
+    /// Serialized data
+    const std::string& data() const { return buf_;}
+
+  private:
+    // Buffer
+    std::string buf_;
+
+    // Functions and sparsity patterns already written
+    std::map<const void*, int> functions_, sparsities_;
+  };
+
+  /** \brief Helper class for reading functions written by Serializer
+
+      Reads directly from a block of memory, typically a memory mapped file.
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_EXPORT Deserializer {
+  public:
+    /// Constructor
+    Deserializer(const char* data, size_t sz);
+
+    ///@{
+    /// Read data from the buffer
+    void unpack(int& e);
+    void unpack(bool& e);
+    void unpack(double& e);
+    void unpack(std::string& e);
+    void unpack(std::vector<int>& e);
+    void unpack(std::vector<double>& e);
+    void unpack(std::vector<std::string>& e);
+    void unpack(Sparsity& e);
+    void unpack(DM& e);
+    void unpack(GenericType& e);
+    void unpack(Dict& e);
+    void unpack(Function& e);
+    ///@}
+
+    /// Read raw bytes
+    void unpack_raw(void* e, size_t sz);
+
+    /// Check that a class record has the expected layout
+    void check(bool cond, const char* what) const {
+      if (!cond) corrupt(what);
+    }
+
+    /// Have all data been read?
+    bool done() const { return pos_==end_;}
+
+  private:
+    // Raise an error for corrupt data
+    void corrupt(const char* what) const;
+
+    // Current position and end of the buffer
+    const char *pos_, *end_;
+
+    // Functions and sparsity patterns already read
+    std::vector<Function> functions_;
+    std::vector<Sparsity> sparsities_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_SERIALIZER_HPP
@@ -164,8 +164,15 @@ namespace casadi {
       }
     }
 
-    // Evaluate the corresponding function
-    fk(arg1, res1, iw, w, 0);
+    // Evaluate the corresponding function, with an own memory object
+    int m = fk.checkout();
+    try {
+      fk(arg1, res1, iw, w, m);
+    } catch(...) {
+      fk.release(m);
+      throw;
+    }
+    fk.release(m);
 
     // Project results with different sparsity
     for (int i=0; i<n_out; ++i) {
@@ -26,12 +26,16 @@
 #include "sx_function.hpp"
 #include <limits>
 #include <stack>
+#include <set>
+#include <functional>
 #include <deque>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include "../std_vector_tools.hpp"
 #include "../sx/sx_node.hpp"
+#include "../sx/unary_sx.hpp"
+#include "../sx/binary_sx.hpp"
 #include "../casadi_types.hpp"
 #include "../sparsity_internal.hpp"
 #include "../global_options.hpp"
@@ -41,6 +45,25 @@ namespace casadi {
 
   using namespace std;
 
+  // Built-in operations supported by the bytecode
+#define CASADI_BYTECODE_OPS(X)                                          \
+  X(ASSIGN) X(ADD) X(SUB) X(MUL) X(DIV) X(NEG) X(EXP) X(LOG) X(POW) X(CONSTPOW) \
+  X(SQRT) X(SQ) X(TWICE) X(SIN) X(COS) X(TAN) X(ASIN) X(ACOS) X(ATAN)  \
+  X(LT) X(LE) X(EQ) X(NE) X(NOT) X(AND) X(OR) X(IF_ELSE_ZERO)          \
+  X(FLOOR) X(CEIL) X(FMOD) X(FABS) X(SIGN) X(COPYSIGN) X(ERF) X(FMIN) X(FMAX) \
+  X(INV) X(SINH) X(COSH) X(TANH) X(ASINH) X(ACOSH) X(ATANH) X(ATAN2)    \
+  X(ERFINV) X(LIFT) X(PRINTME)
+
+  /* Bytecode instructions: Each operation comes in three consecutive variants, with
+     both operands in the work vector, with a constant second operand and with a
+     constant first operand, followed by the remaining instructions */
+#define CASADI_BYTECODE_ENUM(NAME) BC_##NAME, BC_##NAME##_RC, BC_##NAME##_CR,
+  enum BytecodeOp {
+    CASADI_BYTECODE_OPS(CASADI_BYTECODE_ENUM)
+    BC_CONST, BC_INPUT, BC_OUTPUT, BC_MULADD, BC_END
+  };
+#undef CASADI_BYTECODE_ENUM
+
 
   SXFunction::SXFunction(const std::string& name,
                                          const vector<SX >& inputv,
@@ -81,6 +104,9 @@ namespace casadi {
                    << free_vars_ << " are free.");
     }
 
+    // Use the bytecode, if available
+    if (!bytecode_.empty()) return eval_bytecode(arg, res, w);
+
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
@@ -101,6 +127,216 @@ namespace casadi {
     casadi_msg("SXFunction::eval():end " << name_);
   }
 
+  void SXFunction::eval_batch(void* mem, const double** arg, double** res, int* iw, double* w,
+                              int n) const {
+    casadi_msg("SXFunction::eval_batch():begin  " << name_);
+
+    // Make sure no free parameters
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      repr(ss);
+      casadi_error("Cannot evaluate \"" << ss.str() << "\" since variables "
+                   << free_vars_ << " are free.");
+    }
+
+    // Each element of the work vector is expanded to n contiguous lanes, one per point,
+    // so that the dispatch is performed once per instruction rather than once per point
+    // and the elementwise operations can be vectorized by the compiler
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w+e.i1*n, w+e.i2*n, w+e.i0*n, n)
+
+      case OP_CONST:
+        fill_n(w+e.i0*n, n, e.d);
+        break;
+      case OP_INPUT:
+        if (arg[e.i1]==0) {
+          fill_n(w+e.i0*n, n, 0.);
+        } else {
+          int nnz = nnz_in(e.i1);
+          for (int k=0; k<n; ++k) w[e.i0*n+k] = arg[e.i1][k*nnz + e.i2];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=0) {
+          int nnz = nnz_out(e.i0);
+          for (int k=0; k<n; ++k) res[e.i0][k*nnz + e.i2] = w[e.i1*n+k];
+        }
+        break;
+      default:
+        casadi_error("SXFunction::eval_batch: Unknown operation" << e.op);
+      }
+    }
+
+    casadi_msg("SXFunction::eval_batch():end " << name_);
+  }
+
+  void SXFunction::init_bytecode() {
+    int n = algorithm_.size();
+
+    // Instruction that defined the current value of each work vector element
+    vector<int> def(sz_w(), -1);
+
+    // Instructions defining the operands of each instruction and the number of uses
+    vector<int> dep1(n, -1), dep2(n, -1), nuse(n, 0);
+    for (int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op==OP_OUTPUT) {
+        nuse[dep1[k] = def[e.i1]]++;
+      } else {
+        int ndeps = casadi_math<double>::ndeps(e.op);
+        if (ndeps>=1) nuse[dep1[k] = def[e.i1]]++;
+        if (ndeps==2) nuse[dep2[k] = def[e.i2]]++;
+        def[e.i0] = k;
+      }
+    }
+
+    // Variant of each instruction: 0 for none, 1 for constant second operand,
+    // 2 for constant first operand, 3 for fused multiply-add, -1 if removed
+    vector<int> variant(n, 0);
+
+    // Fuse a multiplication with a subsequent addition being its only use
+    for (int k=0; k+1<n; ++k) {
+      if (algorithm_[k].op==OP_MUL && algorithm_[k+1].op==OP_ADD && nuse[k]==1
+          && (dep1[k+1]==k || dep2[k+1]==k)) {
+        variant[k] = -1;
+        variant[k+1] = 3;
+        k++;
+      }
+    }
+
+    // Fold constant operands into binary operations
+    for (int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (variant[k]!=0 || e.op==OP_OUTPUT || casadi_math<double>::ndeps(e.op)!=2) continue;
+      if (algorithm_[dep2[k]].op==OP_CONST) {
+        variant[k] = 1;
+        nuse[dep2[k]]--;
+      } else if (algorithm_[dep1[k]].op==OP_CONST) {
+        variant[k] = 2;
+        nuse[dep1[k]]--;
+      }
+    }
+
+    // Constants no longer used can be removed
+    for (int k=0; k<n; ++k) {
+      if (algorithm_[k].op==OP_CONST && nuse[k]==0) variant[k] = -1;
+    }
+
+    // Generate the bytecode
+    bytecode_.clear();
+    bytecode_.reserve(n+1);
+    for (int k=0; k<n; ++k) {
+      if (variant[k]<0) continue;
+      const AlgEl& e = algorithm_[k];
+      ScalarBytecode b;
+      b.i0 = e.i0;
+      b.i1 = e.i1;
+      b.i2 = e.i2;
+      switch (e.op) {
+      case OP_CONST:
+        b.op = BC_CONST;
+        b.d = e.d;
+        break;
+      case OP_PARAMETER:
+        // Free variables, only relevant for sparsity propagation
+        b.op = BC_CONST;
+        b.d = 0;
+        break;
+      case OP_INPUT: b.op = BC_INPUT; break;
+      case OP_OUTPUT: b.op = BC_OUTPUT; break;
+#define CASADI_BYTECODE_CASE(NAME) case OP_##NAME: b.op = BC_##NAME; break;
+        CASADI_BYTECODE_OPS(CASADI_BYTECODE_CASE)
+#undef CASADI_BYTECODE_CASE
+      default:
+        casadi_error("SXFunction::init_bytecode: Unknown operation" << e.op);
+      }
+      if (variant[k]==1) {
+        b.op += BC_ADD_RC - BC_ADD;
+        b.d = algorithm_[dep2[k]].d;
+      } else if (variant[k]==2) {
+        b.op += BC_ADD_CR - BC_ADD;
+        b.d = algorithm_[dep1[k]].d;
+      } else if (variant[k]==3) {
+        // The multiplication operands, followed by the other operand of the addition
+        const AlgEl& m = algorithm_[k-1];
+        b.op = BC_MULADD;
+        b.i1 = m.i1;
+        b.i2 = m.i2;
+        b.i3 = dep1[k]==k-1 ? e.i2 : e.i1;
+      }
+      bytecode_.push_back(b);
+    }
+
+    // Terminate
+    ScalarBytecode b;
+    b.op = BC_END;
+    bytecode_.push_back(b);
+  }
+
+  void SXFunction::eval_bytecode(const double** arg, double** res, double* w) const {
+    const ScalarBytecode* pc = &bytecode_.front();
+
+    // NOTE: With GCC-compatible compilers, the dispatch is performed with computed gotos,
+    // giving each instruction its own indirect branch, which is much easier to predict than
+    // the single indirect branch of a switch statement. The fused multiply-add is performed
+    // as two separately rounded operations, so that the result is bit-identical, unless
+    // floating-point contraction has been enabled for the compilation.
+#ifdef __GNUC__
+#define CASADI_BYTECODE_LABEL(NAME) &&L_##NAME, &&L_##NAME##_RC, &&L_##NAME##_CR,
+    static void* const labels[] = {
+      CASADI_BYTECODE_OPS(CASADI_BYTECODE_LABEL)
+      &&L_CONST, &&L_INPUT, &&L_OUTPUT, &&L_MULADD, &&L_END
+    };
+#undef CASADI_BYTECODE_LABEL
+#define CASADI_BYTECODE_TARGET(NAME) L_##NAME:
+#define CASADI_BYTECODE_NEXT goto *labels[(++pc)->op]
+    goto *labels[pc->op];
+#endif // __GNUC__
+#ifndef __GNUC__
+#define CASADI_BYTECODE_TARGET(NAME) case BC_##NAME:
+#define CASADI_BYTECODE_NEXT break
+    for (;; ++pc) {
+      switch (pc->op) {
+#endif // __GNUC__
+
+#define CASADI_BYTECODE_EVAL(NAME)                                      \
+    CASADI_BYTECODE_TARGET(NAME)                                        \
+      BinaryOperation<OP_##NAME>::fcn(w[pc->i1], w[pc->i2], w[pc->i0]); \
+      CASADI_BYTECODE_NEXT;                                             \
+    CASADI_BYTECODE_TARGET(NAME##_RC)                                   \
+      BinaryOperation<OP_##NAME>::fcn(w[pc->i1], pc->d, w[pc->i0]);     \
+      CASADI_BYTECODE_NEXT;                                             \
+    CASADI_BYTECODE_TARGET(NAME##_CR)                                   \
+      BinaryOperation<OP_##NAME>::fcn(pc->d, w[pc->i2], w[pc->i0]);     \
+      CASADI_BYTECODE_NEXT;
+    CASADI_BYTECODE_OPS(CASADI_BYTECODE_EVAL)
+#undef CASADI_BYTECODE_EVAL
+
+    CASADI_BYTECODE_TARGET(CONST)
+      w[pc->i0] = pc->d;
+      CASADI_BYTECODE_NEXT;
+    CASADI_BYTECODE_TARGET(INPUT)
+      w[pc->i0] = arg[pc->i1]==0 ? 0 : arg[pc->i1][pc->i2];
+      CASADI_BYTECODE_NEXT;
+    CASADI_BYTECODE_TARGET(OUTPUT)
+      if (res[pc->i0]!=0) res[pc->i0][pc->i2] = w[pc->i1];
+      CASADI_BYTECODE_NEXT;
+    CASADI_BYTECODE_TARGET(MULADD)
+      w[pc->i0] = w[pc->i1] * w[pc->i2] + w[pc->i3];
+      CASADI_BYTECODE_NEXT;
+    CASADI_BYTECODE_TARGET(END)
+      return;
+#ifndef __GNUC__
+      default:
+        casadi_error("SXFunction::eval_bytecode: Unknown instruction" << pc->op);
+      }
+    }
+#endif // __GNUC__
+#undef CASADI_BYTECODE_TARGET
+#undef CASADI_BYTECODE_NEXT
+  }
+
 
   SX SXFunction::hess(int iind, int oind) {
     casadi_assert_message(sparsity_out(oind).is_scalar(false), "Function must be scalar");
@@ -185,48 +421,190 @@ namespace casadi {
   }
 
   void SXFunction::generateBody(CodeGenerator& g) const {
+    int n = algorithm_.size();
+    vector<int> def(sz_w(), -1);
+
+    // Quick return if no splitting
+    if (g.split_size<=0 || n<=g.split_size) {
+      generateAlgorithm(g.body, 0, n, vector<bool>(n, false), def);
+      return;
+    }
+
+    // Store the results that are used outside of their chunk in the work vector
+    vector<bool> in_w(n, false);
+    for (int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      int ndep;
+      switch (e.op) {
+      case OP_OUTPUT: ndep = 1; break;
+      case OP_CONST: case OP_INPUT: ndep = 0; break;
+      default: ndep = casadi_math<double>::ndeps(e.op);
+      }
+      for (int c=0; c<ndep; ++c) {
+        int d = def[c==0 ? e.i1 : e.i2];
+        if (d>=0 && d/g.split_size != k/g.split_size) in_w[d] = true;
+      }
+      if (e.op!=OP_OUTPUT) def[e.i0] = k;
+    }
+
+    // Generate a function for each chunk
+    fill(def.begin(), def.end(), -1);
+    for (int k=0; k<n; k+=g.split_size) {
+      stringstream s;
+      generateAlgorithm(s, k, min(k+g.split_size, n), in_w, def);
+      g.body << "  " << g.addChunk(s.str()) << "(arg, res, w);" << endl;
+    }
+  }
 
-    // Which variables have been declared
+  void SXFunction::generateAlgorithm(std::ostream& s, int k_begin, int k_end,
+                                     const std::vector<bool>& in_w,
+                                     std::vector<int>& def) const {
+    // Which local variables have been declared
     vector<bool> declared(sz_w(), false);
 
     // Run the algorithm
-    for (vector<AlgEl>::const_iterator it = algorithm_.begin(); it!=algorithm_.end(); ++it) {
+    for (int k=k_begin; k<k_end; ++k) {
+      const AlgEl& e = algorithm_[k];
+
       // Indent
-      g.body << "  ";
+      s << "  ";
 
-      if (it->op==OP_OUTPUT) {
-        g.body << "if (res[" << it->i0 << "]!=0) "
-                      << "res["<< it->i0 << "][" << it->i2 << "]=" << "a" << it->i1;
+      if (e.op==OP_OUTPUT) {
+        s << "if (res[" << e.i0 << "]!=0) "
+          << "res["<< e.i0 << "][" << e.i2 << "]=" << (in_w[def[e.i1]] ? "w[" : "a") << e.i1
+          << (in_w[def[e.i1]] ? "]" : "");
       } else {
-        // Declare result if not already declared
-        if (!declared[it->i0]) {
-          g.body << "real_t ";
-          declared[it->i0]=true;
-        }
-
         // Where to store the result
-        g.body << "a" << it->i0 << "=";
+        if (in_w[k]) {
+          s << "w[" << e.i0 << "]=";
+        } else {
+          // Declare result if not already declared
+          if (!declared[e.i0]) {
+            s << "real_t ";
+            declared[e.i0]=true;
+          }
+          s << "a" << e.i0 << "=";
+        }
 
         // What to store
-        if (it->op==OP_CONST) {
-          g.body << g.constant(it->d);
-        } else if (it->op==OP_INPUT) {
-          g.body << "arg[" << it->i1 << "] ? arg[" << it->i1 << "][" << it->i2 << "] : 0";
+        if (e.op==OP_CONST) {
+          s << CodeGenerator::constant(e.d);
+        } else if (e.op==OP_INPUT) {
+          s << "arg[" << e.i1 << "] ? arg[" << e.i1 << "][" << e.i2 << "] : 0";
         } else {
-          int ndep = casadi_math<double>::ndeps(it->op);
-          casadi_math<double>::printPre(it->op, g.body);
+          int ndep = casadi_math<double>::ndeps(e.op);
+          casadi_math<double>::printPre(e.op, s);
           for (int c=0; c<ndep; ++c) {
-            if (c==0) {
-              g.body << "a" << it->i1;
+            if (c!=0) casadi_math<double>::printSep(e.op, s);
+            int i = c==0 ? e.i1 : e.i2;
+            if (in_w[def[i]]) {
+              s << "w[" << i << "]";
             } else {
-              casadi_math<double>::printSep(it->op, g.body);
-              g.body << "a" << it->i2;
+              s << "a" << i;
             }
           }
-          casadi_math<double>::printPost(it->op, g.body);
+          casadi_math<double>::printPost(e.op, s);
         }
+        def[e.i0] = k;
       }
-      g.body  << ";" << endl;
+      s  << ";" << endl;
+    }
+  }
+
+  void SXFunction::resort_min_live(vector<SXNode*>& nodes) const {
+    int n = nodes.size();
+
+    // Set the temporary variables to be the corresponding place in the sorted graph
+    for (int i=0; i<n; ++i) {
+      if (nodes[i]) nodes[i]->temp = i;
+    }
+
+    // Dependencies of each instruction, -1 if none. An output instruction
+    // depends on the output nonzero and, for ordering only, on the previous output
+    vector<SXNode*> out_nz;
+    for (auto&& e : out_) {
+      for (auto&& nz : e.nonzeros()) out_nz.push_back(nz.get());
+    }
+    vector<int> dep0(n, -1), dep1(n, -1);
+    int prev_out = -1, curr_out = 0;
+    for (int i=0; i<n; ++i) {
+      SXNode* t = nodes[i];
+      if (t) {
+        if (t->ndep()>0) dep0[i] = t->dep(0)->temp;
+        if (t->ndep()>1) dep1[i] = t->dep(1)->temp;
+      } else {
+        dep0[i] = out_nz.at(curr_out++)->temp;
+        dep1[i] = prev_out;
+        prev_out = i;
+      }
+    }
+
+    // Remaining uses of each value and list of users of each instruction
+    vector<int> rem(n, 0), ndep_rem(n, 0), uind(n+1, 0), users;
+    for (int i=0; i<n; ++i) {
+      for (int d : {dep0[i], dep1[i]}) {
+        if (d<0) continue;
+        if (nodes[d]) rem[d]++;
+        ndep_rem[i]++;
+        uind[d+1]++;
+      }
+    }
+    for (int i=0; i<n; ++i) uind[i+1] += uind[i];
+    users.resize(uind[n]);
+    vector<int> upos(uind.begin(), uind.end()-1);
+    for (int i=0; i<n; ++i) {
+      for (int d : {dep0[i], dep1[i]}) {
+        if (d>=0) users[upos[d]++] = i;
+      }
+    }
+
+    // Net change in the number of live variables when executing an instruction
+    std::function<int(int)> score([&](int i) {
+      int s = nodes[i] ? -1 : 0;
+      if (dep0[i]>=0 && nodes[dep0[i]]) {
+        int occ = dep1[i]==dep0[i] ? 2 : 1;
+        if (rem[dep0[i]]==occ) s++;
+      }
+      if (dep1[i]>=0 && dep1[i]!=dep0[i] && nodes[dep1[i]] && rem[dep1[i]]==1) s++;
+      return s;
+    });
+
+    // Greedy list scheduling: largest reduction first, then the depth-first order
+    set<pair<int, int> > ready;
+    vector<int> key(n);
+    for (int i=0; i<n; ++i) {
+      if (ndep_rem[i]==0) ready.insert(make_pair(key[i] = -score(i), i));
+    }
+    vector<SXNode*> nodes_new;
+    nodes_new.reserve(n);
+    while (!ready.empty()) {
+      int i = ready.begin()->second;
+      ready.erase(ready.begin());
+      nodes_new.push_back(nodes[i]);
+      // Consume the dependencies
+      for (int d : {dep0[i], dep1[i]}) {
+        if (d<0 || !nodes[d]) continue;
+        if (--rem[d]<=2) {
+          // Users ready to execute may now free d
+          for (int k=uind[d]; k<uind[d+1]; ++k) {
+            int u = users[k];
+            if (ndep_rem[u]!=0 || !ready.erase(make_pair(key[u], u))) continue;
+            ready.insert(make_pair(key[u] = -score(u), u));
+          }
+        }
+      }
+      // Users that have become ready
+      for (int k=uind[i]; k<uind[i+1]; ++k) {
+        int u = users[k];
+        if (--ndep_rem[u]==0) ready.insert(make_pair(key[u] = -score(u), u));
+      }
+    }
+    casadi_assert(nodes_new.size()==n);
+    nodes.swap(nodes_new);
+
+    // Mark as sorted
+    for (SXNode* t : nodes) {
+      if (t) t->temp = 1;
     }
   }
 
@@ -244,7 +622,21 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"bytecode",
+       {OT_BOOL,
+        "Evaluate using a compact register-based bytecode with fused instructions "
+        "and threaded dispatch instead of interpreting the algorithm. "
+        "Gives identical results and is typically faster for large expression graphs"}},
+      {"cse",
+       {OT_BOOL,
+        "Merge identical subexpressions before sorting the graph"}},
+      {"min_live",
+       {OT_BOOL,
+        "Reorder the operations with greedy list scheduling: among the operations whose "
+        "arguments are available, execute first the one that frees the most intermediates. "
+        "This typically shrinks the work vector and the number of temporaries in "
+        "generated code, but is a heuristic and not guaranteed to be optimal"}}
      }
   };
 
@@ -255,6 +647,9 @@ namespace casadi {
 
     // Default (temporary) options
     bool live_variables = true;
+    bool bytecode = false;
+    bool cse = false;
+    bool min_live = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -262,6 +657,12 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables = op.second;
+      } else if (op.first=="bytecode") {
+        bytecode = op.second;
+      } else if (op.first=="cse") {
+        cse = op.second;
+      } else if (op.first=="min_live") {
+        min_live = op.second;
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
@@ -277,6 +678,63 @@ namespace casadi {
                             "Option 'default_in' has incorrect length");
     }
 
+    // Sort the expression graph, unless the algorithm has been restored by deserialize
+    size_t worksize = algorithm_.empty() ? init_algorithm(live_variables, cse, min_live)
+      : s_work_.size();
+
+    // Allocate work vectors (symbolic/numeric)
+    alloc_w(worksize);
+    s_work_.resize(worksize);
+
+    // Translate to bytecode
+    bytecode_.clear();
+    if (bytecode) {
+      init_bytecode();
+      if (verbose()) {
+        userOut() << "Bytecode has " << bytecode_.size()-1 << " instructions instead of "
+                  << algorithm_.size() << endl;
+      }
+    }
+
+    // Initialize just-in-time compilation for numeric evaluation using OpenCL
+    if (just_in_time_opencl_) {
+#ifdef WITH_OPENCL
+      freeOpenCL();
+      allocOpenCL();
+#else // WITH_OPENCL
+      casadi_error("Option \"just_in_time_opencl\" true requires CasADi "
+                   "to have been compiled with WITH_OPENCL=ON");
+#endif // WITH_OPENCL
+    }
+
+    // Initialize just-in-time compilation for sparsity propagation using OpenCL
+    if (just_in_time_sparsity_) {
+#ifdef WITH_OPENCL
+      spFreeOpenCL();
+      spAllocOpenCL();
+#else // WITH_OPENCL
+      casadi_error("Option \"just_in_time_sparsity\" true requires CasADi to "
+                   "have been compiled with WITH_OPENCL=ON");
+#endif // WITH_OPENCL
+    }
+
+    // Print
+    if (verbose()) {
+      userOut() << "SXFunction::init Initialized " << name_ << " ("
+           << algorithm_.size() << " elementary operations)" << endl;
+    }
+  }
+
+  size_t SXFunction::init_algorithm(bool live_variables, bool cse, bool min_live) {
+    // Common subexpression elimination
+    if (cse) {
+      if (verbose()) {
+        userOut() << "SXFunction::init: " << Function("tmp", vector<SX>{}, out_).n_nodes()
+                  << " nodes before cse" << endl;
+      }
+      out_ = SX::cse(out_);
+    }
+
     // Stack used to sort the computational graph
     stack<SXNode*> s;
 
@@ -297,6 +755,9 @@ namespace casadi {
       }
     }
 
+    // Reduce the number of simultaneously live variables
+    if (min_live) resort_min_live(nodes);
+
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (int i=0; i<nodes.size(); ++i) {
       if (nodes[i]) {
@@ -440,6 +901,9 @@ namespace casadi {
     }
 
     if (verbose()) {
+      if (cse) {
+        userOut() << "SXFunction::init: " << n_nodes() << " nodes after cse" << endl;
+      }
       if (live_variables) {
         userOut() << "Using live variables: work array is "
              <<  worksize << " instead of " << nodes.size() << endl;
@@ -448,9 +912,6 @@ namespace casadi {
       }
     }
 
-    // Allocate work vectors (symbolic/numeric)
-    alloc_w(worksize);
-    s_work_.resize(worksize);
 
     // Reset the temporary variables
     for (int i=0; i<nodes.size(); ++i) {
@@ -496,33 +957,159 @@ namespace casadi {
       }
     }
 
-    // Initialize just-in-time compilation for numeric evaluation using OpenCL
-    if (just_in_time_opencl_) {
-#ifdef WITH_OPENCL
-      freeOpenCL();
-      allocOpenCL();
-#else // WITH_OPENCL
-      casadi_error("Option \"just_in_time_opencl\" true requires CasADi "
-                   "to have been compiled with WITH_OPENCL=ON");
-#endif // WITH_OPENCL
+    return worksize;
+  }
+
+  void SXFunction::serialize(Serializer& s) const {
+    s.pack("SXFunction");
+    s.pack(name_);
+    s.pack(ischeme_);
+    s.pack(oscheme_);
+
+    // Sparsity and names of the symbolic inputs
+    s.pack(static_cast<int>(in_.size()));
+    for (auto&& i : in_) {
+      s.pack(i.sparsity());
+      for (auto&& e : i.nonzeros()) s.pack(e.name());
     }
 
-    // Initialize just-in-time compilation for sparsity propagation using OpenCL
-    if (just_in_time_sparsity_) {
-#ifdef WITH_OPENCL
-      spFreeOpenCL();
-      spAllocOpenCL();
-#else // WITH_OPENCL
-      casadi_error("Option \"just_in_time_sparsity\" true requires CasADi to "
-                   "have been compiled with WITH_OPENCL=ON");
-#endif // WITH_OPENCL
+    // Sparsity of the outputs
+    s.pack(static_cast<int>(out_.size()));
+    for (auto&& i : out_) s.pack(i.sparsity());
+
+    // Names of the free variables
+    s.pack(static_cast<int>(free_vars_.size()));
+    for (auto&& e : free_vars_) s.pack(e.name());
+
+    // The algorithm, as is
+    s.pack(static_cast<int>(sizeof(AlgEl)));
+    s.pack(static_cast<int>(algorithm_.size()));
+    if (!algorithm_.empty()) s.pack_raw(&algorithm_.front(), algorithm_.size()*sizeof(AlgEl));
+    s.pack(static_cast<int>(s_work_.size()));
+
+    // Options
+    s.pack(default_in_);
+    s.pack(!bytecode_.empty());
+  }
+
+  Function SXFunction::deserialize(Deserializer& s) {
+    string name;
+    vector<string> ischeme, oscheme;
+    s.unpack(name);
+    s.unpack(ischeme);
+    s.unpack(oscheme);
+
+    // Create symbolic inputs
+    int n;
+    s.unpack(n);
+    s.check(n>=0, "bad number of inputs");
+    vector<SX> arg(n);
+    for (auto&& i : arg) {
+      Sparsity sp;
+      s.unpack(sp);
+      vector<SXElem> nz(sp.nnz());
+      string nz_name;
+      for (auto&& e : nz) {
+        s.unpack(nz_name);
+        e = SXElem::sym(nz_name);
+      }
+      i = SX(sp, nz, false);
     }
 
-    // Print
-    if (verbose()) {
-      userOut() << "SXFunction::init Initialized " << name_ << " ("
-           << algorithm_.size() << " elementary operations)" << endl;
+    // Outputs, nonzeros assigned below
+    s.unpack(n);
+    s.check(n>=0, "bad number of outputs");
+    vector<SX> res(n);
+    for (auto&& i : res) {
+      Sparsity sp;
+      s.unpack(sp);
+      i = SX::zeros(sp);
+    }
+
+    // Free variables
+    s.unpack(n);
+    s.check(n>=0, "bad number of free variables");
+    vector<SXElem> free_vars(n);
+    string fv_name;
+    for (auto&& e : free_vars) {
+      s.unpack(fv_name);
+      e = SXElem::sym(fv_name);
+    }
+
+    // Algorithm
+    s.unpack(n);
+    s.check(n==sizeof(AlgEl), "incompatible platform");
+    s.unpack(n);
+    s.check(n>=0, "bad algorithm size");
+    vector<AlgEl> algorithm(n);
+    if (n>0) s.unpack_raw(&algorithm.front(), n*sizeof(AlgEl));
+    int worksize;
+    s.unpack(worksize);
+    s.check(worksize>=0, "bad work vector size");
+
+    // Options
+    Dict opts;
+    vector<double> default_in;
+    bool bytecode;
+    s.unpack(default_in);
+    s.unpack(bytecode);
+    opts["input_scheme"] = ischeme;
+    opts["output_scheme"] = oscheme;
+    opts["default_in"] = default_in;
+    if (bytecode) opts["bytecode"] = true;
+
+    // Rebuild the expression graph by executing the algorithm symbolically, without
+    // simplifications so that the nodes correspond one-to-one to the algorithm
+    vector<SXElem> w(worksize), operations, constants;
+    int k_free = 0;
+    for (auto&& e : algorithm) {
+      if (e.op==OP_OUTPUT) {
+        s.check(e.i0>=0 && e.i0<res.size() && e.i2>=0 && e.i2<res[e.i0].nnz()
+                && e.i1>=0 && e.i1<worksize, "bad output instruction");
+        res[e.i0].nonzeros()[e.i2] = w[e.i1];
+        continue;
+      }
+      s.check(e.i0>=0 && e.i0<worksize, "bad work vector index");
+      switch (e.op) {
+      case OP_INPUT:
+        s.check(e.i1>=0 && e.i1<arg.size() && e.i2>=0 && e.i2<arg[e.i1].nnz(),
+                "bad input instruction");
+        w[e.i0] = arg[e.i1].nonzeros()[e.i2];
+        break;
+      case OP_PARAMETER:
+        s.check(k_free<free_vars.size(), "bad number of free variables");
+        w[e.i0] = free_vars[k_free++];
+        break;
+      case OP_CONST:
+        w[e.i0] = e.d;
+        constants.push_back(w[e.i0]);
+        break;
+      default:
+        s.check((e.op>=0 && e.op<OP_CONST) || e.op==OP_ERFINV || e.op==OP_PRINTME || e.op==OP_LIFT,
+                "unknown operation");
+        s.check(e.i1>=0 && e.i1<worksize && e.i2>=0 && e.i2<worksize,
+                "bad work vector index");
+        if (casadi_math<double>::ndeps(e.op)==2) {
+          w[e.i0] = BinarySX::create(e.op, w[e.i1], w[e.i2]);
+        } else {
+          w[e.i0] = UnarySX::create(e.op, w[e.i1]);
+        }
+        operations.push_back(w[e.i0]);
+      }
     }
+    s.check(k_free==free_vars.size(), "bad number of free variables");
+
+    // Create the function, reusing the algorithm
+    Function ret;
+    SXFunction* node = new SXFunction(name, arg, res);
+    ret.assignNode(node);
+    node->algorithm_ = algorithm;
+    node->s_work_.resize(worksize);
+    node->operations_ = operations;
+    node->constants_ = constants;
+    node->free_vars_ = free_vars;
+    ret->construct(opts);
+    return ret;
   }
 
   void SXFunction::eval_sx(const SXElem** arg, SXElem** res, int* iw, SXElem* w, int mem) {
@@ -777,6 +1364,32 @@ namespace casadi {
   }
 
   void SXFunction::sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    // Propagate sparsity forward using the bytecode
+    if (!bytecode_.empty()) {
+      for (auto&& b : bytecode_) {
+        switch (b.op) {
+        case BC_CONST:
+          w[b.i0] = 0; break;
+        case BC_INPUT:
+          w[b.i0] = arg[b.i1]==0 ? 0 : arg[b.i1][b.i2]; break;
+        case BC_OUTPUT:
+          if (res[b.i0]!=0) res[b.i0][b.i2] = w[b.i1];
+          break;
+        case BC_MULADD:
+          w[b.i0] = w[b.i1] | w[b.i2] | w[b.i3]; break;
+        case BC_END:
+          break;
+        default: // Unary or binary operation, possibly with a constant operand
+          switch (b.op % 3) {
+          case 0: w[b.i0] = w[b.i1] | w[b.i2]; break;
+          case 1: w[b.i0] = w[b.i1]; break;
+          case 2: w[b.i0] = w[b.i2]; break;
+          }
+        }
+      }
+      return;
+    }
+
     // Propagate sparsity forward
     for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
       switch (it->op) {
@@ -796,6 +1409,43 @@ namespace casadi {
   void SXFunction::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
     fill_n(w, sz_w(), 0);
 
+    // Propagate sparsity backward using the bytecode
+    if (!bytecode_.empty()) {
+      for (auto it=bytecode_.rbegin(); it!=bytecode_.rend(); ++it) {
+        bvec_t seed;
+        switch (it->op) {
+        case BC_CONST:
+          w[it->i0] = 0;
+          break;
+        case BC_INPUT:
+          if (arg[it->i1]!=0) arg[it->i1][it->i2] |= w[it->i0];
+          w[it->i0] = 0;
+          break;
+        case BC_OUTPUT:
+          if (res[it->i0]!=0) {
+            w[it->i1] |= res[it->i0][it->i2];
+            res[it->i0][it->i2] = 0;
+          }
+          break;
+        case BC_MULADD:
+          seed = w[it->i0];
+          w[it->i0] = 0;
+          w[it->i1] |= seed;
+          w[it->i2] |= seed;
+          w[it->i3] |= seed;
+          break;
+        case BC_END:
+          break;
+        default: // Unary or binary operation, possibly with a constant operand
+          seed = w[it->i0];
+          w[it->i0] = 0;
+          if (it->op % 3 != 2) w[it->i1] |= seed;
+          if (it->op % 3 != 1) w[it->i2] |= seed;
+        }
+      }
+      return;
+    }
+
     // Propagate sparsity backward
     for (vector<AlgEl>::reverse_iterator it=algorithm_.rbegin(); it!=algorithm_.rend(); ++it) {
       // Temp seed
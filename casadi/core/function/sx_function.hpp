@@ -48,6 +48,16 @@ namespace casadi {
     };
   };
 
+  /** \brief  An instruction of the compact SXElem bytecode */
+  struct ScalarBytecode {
+    int op;     /// Bytecode instruction index
+    int i0, i1, i2;
+    union {
+      double d; /// Folded constant operand
+      int i3;   /// Addend of a fused multiply-add
+    };
+  };
+
 #ifdef WITH_OPENCL
   /** \brief Singleton for the sparsity propagation kernel
       TODO: Move to a separate file and make non sparsity pattern specific
@@ -97,6 +107,13 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Evaluate numerically, work vectors given */
   virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
 
+  /** \brief  Evaluate numerically for a batch of points, work vectors given */
+  virtual void eval_batch(void* mem, const double** arg, double** res, int* iw, double* w,
+                          int n) const;
+
+  /** \brief  Is batched evaluation supported? */
+  virtual bool has_eval_batch() const { return true;}
+
   /** \brief  evaluate symbolically while also propagating directional derivatives */
   virtual void eval_sx(const SXElem** arg, SXElem** res, int* iw, SXElem* w, int mem);
 
@@ -195,6 +212,9 @@ class CASADI_EXPORT SXFunction :
   /** \brief Number of nodes in the algorithm */
   virtual int n_nodes() const { return algorithm_.size() - nnz_out();}
 
+  /** \brief Estimated number of floating point operations per call */
+  virtual double n_flops() const { return operations_.size();}
+
   /** \brief  DATA MEMBERS */
 
   /** \brief  An element of the algorithm, namely a binary operation */
@@ -209,6 +229,18 @@ class CASADI_EXPORT SXFunction :
   /** \brief  all binary nodes of the tree in the order of execution */
   std::vector<AlgEl> algorithm_;
 
+  /** \brief  The algorithm translated to bytecode, empty if not used */
+  std::vector<ScalarBytecode> bytecode_;
+
+  /** \brief  Translate the algorithm to bytecode, fusing instructions where possible */
+  void init_bytecode();
+
+  /** \brief  Evaluate numerically using the bytecode */
+  void eval_bytecode(const double** arg, double** res, double* w) const;
+
+  /** \brief  Resort the nodes so that fewer intermediates are live at the same time */
+  void resort_min_live(std::vector<SXNode*>& nodes) const;
+
   /// work vector for symbolic calculations (allocated first time)
   std::vector<SXElem> s_work_;
   std::vector<SXElem> free_vars_;
@@ -231,12 +263,29 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Initialize */
   virtual void init(const Dict& opts);
 
+  /** \brief  Sort the expression graph and build the algorithm, returns the work vector size */
+  size_t init_algorithm(bool live_variables, bool cse, bool min_live);
+
+  /** \brief Serialize the algorithm, see Function::save */
+  virtual void serialize(Serializer& s) const;
+
+  /** \brief Restore a function written by serialize */
+  static Function deserialize(Deserializer& s);
+
   /** \brief Generate code for the declarations of the C function */
   virtual void generateDeclarations(CodeGenerator& g) const;
 
   /** \brief Generate code for the body of the C function */
   virtual void generateBody(CodeGenerator& g) const;
 
+  /** \brief Generate code for the instructions [k_begin, k_end) of the algorithm
+   * Results of instructions with in_w set are stored in the work vector, others
+   * in local variables. def holds the instruction that last assigned each work
+   * vector element and is updated.
+   */
+  void generateAlgorithm(std::ostream& s, int k_begin, int k_end,
+                         const std::vector<bool>& in_w, std::vector<int>& def) const;
+
   /** \brief  Propagate sparsity forward */
   virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
 
@@ -595,6 +595,17 @@ namespace casadi {
       return MatType::simplify(x);
     }
 
+    /** \brief Common subexpression elimination
+     * Identical subexpressions are merged into a single node */
+    friend inline MatType cse(const MatType& e) {
+      return MatType::cse(e);
+    }
+
+    /** \brief Common subexpression elimination, sharing nodes across expressions */
+    friend inline std::vector<MatType> cse(const std::vector<MatType>& e) {
+      return MatType::cse(e);
+    }
+
     /** \brief Get a string representation for a binary MatType, using custom arguments */
     inline friend std::string
       print_operator(const MatType& xb, const std::vector<std::string>& args) {
@@ -61,6 +61,11 @@ namespace casadi {
 
       static bool hierarchical_sparsity;
 
+      /** \brief Number of threads used for sparsity pattern propagation and coloring
+      * Default: 1
+      */
+      static int sparsity_num_threads;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -70,6 +75,10 @@ namespace casadi {
       static void setHierarchicalSparsity(bool flag) { hierarchical_sparsity = flag; }
       static bool getHierarchicalSparsity() { return hierarchical_sparsity; }
 
+      // Setter and getter for sparsity_num_threads
+      static void setSparsityNumThreads(int n) { sparsity_num_threads = n; }
+      static int getSparsityNumThreads() { return sparsity_num_threads; }
+
       static void setCasadiPath(const std::string & path) { casadipath = path; }
       static std::string getCasadiPath() { return casadipath; }
 
@@ -27,6 +27,8 @@
 #include "function/sx_function.hpp"
 #include "sx/sx_node.hpp"
 #include "function/linsol.hpp"
+#include <cstring>
+#include <cstdint>
 
 using namespace std;
 
@@ -456,6 +458,72 @@ namespace casadi {
     return r;
   }
 
+  template<>
+  SX SX::cse(const SX& e) {
+    return cse(vector<SX>{e}).front();
+  }
+
+  template<>
+  vector<SX> SX::cse(const vector<SX>& e) {
+    // Sort the expression
+    Function f("tmp", vector<SX>{}, e);
+    auto *ff = dynamic_cast<SXFunction *>(f.get());
+
+    // Iterators to the binary operations, constants and free variables
+    vector<SXElem>::const_iterator b_it = ff->operations_.begin();
+    vector<SXElem>::const_iterator c_it = ff->constants_.begin();
+    vector<SXElem>::const_iterator p_it = ff->free_vars_.begin();
+
+    // Nodes already encountered, indexed by operation and (merged) dependencies
+    map<tuple<int, const SXNode*, const SXNode*>, SXElem> ops;
+
+    // Constants, indexed by bit pattern so that e.g. 0 and -0 are kept apart
+    map<uint64_t, SXElem> consts;
+
+    // Evaluate the algorithm, reusing identical nodes
+    vector<SXElem> w(f.getWorkSize());
+    vector<SX> ret = e;
+    for (auto&& a : ff->algorithm_) {
+      switch (a.op) {
+      case OP_OUTPUT:
+        ret.at(a.i0)->at(a.i2) = w[a.i1];
+        break;
+      case OP_CONST:
+        {
+          SXElem c = *c_it++;
+          double v = static_cast<double>(c);
+          uint64_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          w[a.i0] = consts.insert(make_pair(bits, c)).first->second;
+        }
+        break;
+      case OP_PARAMETER:
+        w[a.i0] = *p_it++;
+        break;
+      default:
+        {
+          SXElem r = *b_it++;
+          bool binary = casadi_math<double>::ndeps(a.op)==2;
+          const SXNode* d0 = w[a.i1].get();
+          const SXNode* d1 = binary ? w[a.i2].get() : 0;
+          // Commutative operations: dependencies in canonical order
+          if (binary && operation_checker<CommChecker>(a.op) && d1<d0) swap(d0, d1);
+          auto it = ops.find(make_tuple(a.op, d0, d1));
+          if (it!=ops.end()) {
+            w[a.i0] = it->second;
+            break;
+          }
+          // Rebuild the node if any of its dependencies were replaced
+          if (r.dep(0).get()!=w[a.i1].get() || (binary && r.dep(1).get()!=w[a.i2].get())) {
+            r = binary ? SXElem::binary(a.op, w[a.i1], w[a.i2]) : SXElem::unary(a.op, w[a.i1]);
+          }
+          w[a.i0] = ops[make_tuple(a.op, d0, d1)] = r;
+        }
+      }
+    }
+    return ret;
+  }
+
   template<>
   SX SX::substitute(const SX& ex, const SX& v, const SX& vdef) {
     return substitute(vector<SX>{ex}, vector<SX>{v}, vector<SX>{vdef}).front();
@@ -271,6 +271,8 @@ namespace casadi {
     ///@{
     /// Functions called by friend functions defined for GenericMatrix
     static Matrix<Scalar> simplify(const Matrix<Scalar> &x);
+    static Matrix<Scalar> cse(const Matrix<Scalar>& e);
+    static std::vector<Matrix<Scalar> > cse(const std::vector<Matrix<Scalar> >& e);
     static Matrix<Scalar> jacobian(const Matrix<Scalar> &f, const Matrix<Scalar> &x,
                                      bool symmetric=false);
     static Matrix<Scalar> gradient(const Matrix<Scalar> &f, const Matrix<Scalar> &x);
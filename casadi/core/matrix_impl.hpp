@@ -2192,6 +2192,16 @@ namespace casadi {
     return x;
   }
 
+  template<typename Scalar>
+  Matrix<Scalar> Matrix<Scalar>::cse(const Matrix<Scalar>& e) {
+    return e;
+  }
+
+  template<typename Scalar>
+  std::vector<Matrix<Scalar> > Matrix<Scalar>::cse(const std::vector<Matrix<Scalar> >& e) {
+    return e;
+  }
+
   template<typename Scalar>
   Matrix<Scalar> Matrix<Scalar>::substitute(const Matrix<Scalar>& ex,
                                                 const Matrix<Scalar>& v,
@@ -2598,6 +2608,8 @@ namespace casadi {
                                      const SX &b, int order,
                                      const SX& w);
   template<> SX SX::simplify(const SX& x);
+  template<> SX SX::cse(const SX& e);
+  template<> std::vector<SX> SX::cse(const std::vector<SX>& e);
   template<> SX SX::substitute(const SX& ex, const SX& v, const SX& vdef);
   template<> std::vector<SX > SX::substitute(const std::vector<SX >& ex,
                                                 const std::vector<SX >& v,
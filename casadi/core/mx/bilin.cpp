@@ -31,7 +31,7 @@ using namespace std;
 namespace casadi {
 
   Bilin::Bilin(const MX& A, const MX& x, const MX& y) {
-    setDependencies(x, A);
+    setDependencies(A, x, y);
     setSparsity(Sparsity::scalar());
   }
 
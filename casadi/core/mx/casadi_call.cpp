@@ -84,7 +84,15 @@ namespace casadi {
   }
 
   void Call::eval(const double** arg, double** res, int* iw, double* w, int mem) const {
-    fcn_(arg, res, iw, w, mem);
+    // Own memory object, the node may be evaluated concurrently
+    int m = fcn_.checkout();
+    try {
+      fcn_(arg, res, iw, w, m);
+    } catch(...) {
+      fcn_.release(m);
+      throw;
+    }
+    fcn_.release(m);
   }
 
   int Call::nout() const {
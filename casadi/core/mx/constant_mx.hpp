@@ -181,8 +181,14 @@ namespace casadi {
   public:
     /** \brief Get a pointer to the singleton */
     static ZeroByZero* getInstance() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      // One per thread, kept alive as long as expressions refer to it
+      static thread_local ZeroByZero* instance = new ZeroByZero();
+      return instance;
+#else // WITH_THREADSAFE_SYMBOLICS
       static ZeroByZero instance;
       return &instance;
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
     /// Destructor
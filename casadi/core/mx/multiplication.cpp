@@ -123,6 +123,14 @@ namespace casadi {
                                g.work(res[0], nnz())) << endl;
     }
 
+    // Let the code generator specialize the kernel, if requested
+    if (g.unroll_size>0) {
+      g.body << "  " << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).sparsity(),
+                                 g.work(arg[2], dep(2).nnz()), dep(2).sparsity(),
+                                 g.work(res[0], nnz()), sparsity(), "w", false) << endl;
+      return;
+    }
+
     int nrow_x = dep(1).size1(), nrow_y = dep(2).size1(), ncol_y = dep(2).size2();
     g.body << "  for (i=0, rr=" << g.work(res[0], nnz()) <<"; i<" << ncol_y << "; ++i)";
     g.body << " for (j=0; j<" << nrow_x << "; ++j, ++rr)";
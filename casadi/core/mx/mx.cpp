@@ -32,6 +32,9 @@
 #include "../calculus.hpp"
 #include "../function/mx_function.hpp"
 #include "../function/linsol.hpp"
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
 
 using namespace std;
 namespace casadi {
@@ -1402,6 +1405,120 @@ namespace casadi {
 
   }
 
+  // Hash of a numerical matrix from its sparsity pattern and the bit patterns of its nonzeros
+  static size_t hash_bits(const DM& x) {
+    size_t h = x.sparsity().hash();
+    for (auto&& e : x.nonzeros()) {
+      uint64_t bits;
+      memcpy(&bits, &e, sizeof(bits));
+      hash_combine(h, bits);
+    }
+    return h;
+  }
+
+  // Are two numerical matrices identical, including the bit patterns of the nonzeros
+  static bool equal_bits(const DM& x, const DM& y) {
+    return x.sparsity()==y.sparsity()
+      && (x.nnz()==0 || memcmp(x.ptr(), y.ptr(), x.nnz()*sizeof(double))==0);
+  }
+
+  MX MX::cse(const MX& e) {
+    return cse(vector<MX>{e}).front();
+  }
+
+  std::vector<MX> MX::cse(const std::vector<MX>& e) {
+    // Sort the expression
+    Function f("tmp", vector<MX>{}, e);
+    auto *ff = dynamic_cast<MXFunction *>(f.get());
+
+    // Get references to the internal data structures
+    const vector<MXAlgEl>& algorithm = ff->algorithm_;
+    vector<MX> swork(ff->workloc_.size()-1);
+
+    // Nodes already encountered, indexed by operation and (sorted) dependencies
+    map<pair<int, vector<const MXNode*> >, vector<MX> > nodes;
+
+    // Constants, indexed by a hash of their values
+    unordered_map<size_t, vector<pair<DM, MX> > > consts;
+
+    // Evaluate the algorithm, reusing identical nodes
+    vector<MX> ret(f.n_out());
+    vector<MX> oarg, ores;
+    pair<int, vector<const MXNode*> > key;
+    for (auto&& a : algorithm) {
+      switch (a.op) {
+      case OP_INPUT:
+      case OP_PARAMETER:
+        swork[a.res.front()] = a.data;
+        break;
+      case OP_OUTPUT:
+        ret[a.res.front()] = swork[a.arg.front()];
+        break;
+      default:
+        {
+          // Arguments of the operation, have any of them been replaced?
+          bool changed = false;
+          oarg.resize(a.arg.size());
+          for (int i=0; i<oarg.size(); ++i) {
+            int el = a.arg[i];
+            oarg[i] = el<0 ? MX(a.data->dep(i).size()) : swork.at(el);
+            if (el>=0 && oarg[i].get()!=a.data->dep(i).get()) changed = true;
+          }
+
+          // Perform the operation
+          ores.resize(a.res.size());
+          if (!changed) {
+            if (ores.size()==1) {
+              ores[0] = a.data;
+            } else {
+              for (int i=0; i<ores.size(); ++i) {
+                if (a.res[i]>=0) ores[i] = a.data.getOutput(i);
+              }
+            }
+          } else {
+            const_cast<MX&>(a.data)->eval_mx(oarg, ores);
+          }
+
+          // Merge with an identical node, if any
+          if (ores.size()==1 && a.res[0]>=0 && ores[0].is_constant()) {
+            DM v = ores[0]->getMatrixValue();
+            vector<pair<DM, MX> >& cand = consts[hash_bits(v)];
+            bool found = false;
+            for (auto&& c : cand) {
+              if (equal_bits(c.first, v)) {
+                ores[0] = c.second;
+                found = true;
+                break;
+              }
+            }
+            if (!found) cand.push_back(make_pair(v, ores[0]));
+          } else if (ores.size()==1 && a.res[0]>=0) {
+            key.first = ores[0].op();
+            key.second.resize(ores[0].n_dep());
+            for (int i=0; i<key.second.size(); ++i) key.second[i] = ores[0].dep(i).get();
+            sort(key.second.begin(), key.second.end());
+            vector<MX>& cand = nodes[key];
+            bool found = false;
+            for (auto&& c : cand) {
+              if (is_equal(c, ores[0], 1)) {
+                ores[0] = c;
+                found = true;
+                break;
+              }
+            }
+            if (!found) cand.push_back(ores[0]);
+          }
+
+          // Get the result
+          for (int i=0; i<ores.size(); ++i) {
+            if (a.res[i]>=0) swork.at(a.res[i]) = ores[i];
+          }
+        }
+      }
+    }
+    return ret;
+  }
+
   void MX::shared(std::vector<MX>& ex, std::vector<MX>& v, std::vector<MX>& vdef,
                          const std::string& v_prefix, const std::string& v_suffix) {
 
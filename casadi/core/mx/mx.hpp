@@ -423,6 +423,8 @@ namespace casadi {
     static bool depends_on(const MX& x, const MX& arg);
     static MX logic_not(const MX& x);
     static MX simplify(const MX& x);
+    static MX cse(const MX& e);
+    static std::vector<MX> cse(const std::vector<MX>& e);
     static MX mpower(const MX& a, const MX& b);
     static MX dot(const MX& x, const MX& y);
     static MX mrdivide(const MX& a, const MX& b);
@@ -53,10 +53,18 @@ namespace casadi {
   template<bool Tr>
   void Solve<Tr>::eval(const double** arg, double** res, int* iw, double* w, int mem) const {
     if (arg[0]!=res[0]) copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
-    linsol_.reset(dep(1).sparsity());
-    linsol_.pivoting(arg[1]);
-    linsol_.factorize(arg[1]);
-    linsol_.solve(res[0], dep(0).size2(), Tr);
+    // Own memory object, the linear solver may be shared between calls
+    int m = linsol_.checkout();
+    try {
+      linsol_.reset(dep(1).sparsity(), m);
+      linsol_.pivoting(arg[1], m);
+      linsol_.factorize(arg[1], m);
+      linsol_.solve(res[0], dep(0).size2(), Tr, m);
+    } catch(...) {
+      linsol_.release(m);
+      throw;
+    }
+    linsol_.release(m);
   }
 
   template<bool Tr>
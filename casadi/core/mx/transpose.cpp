@@ -179,11 +179,8 @@ namespace casadi {
 
   void Transpose::generate(CodeGenerator& g, const std::string& mem,
                            const std::vector<int>& arg, const std::vector<int>& res) const {
-    g.addAuxiliary(CodeGenerator::AUX_TRANS);
-
-    g.body << "  trans("
-           << g.work(arg[0], nnz()) << ", " << g.sparsity(dep().sparsity()) << ", "
-           << g.work(res[0], nnz()) << ", " << g.sparsity(sparsity()) << ", iw);" << endl;
+    g.body << "  " << g.trans(g.work(arg[0], nnz()), dep().sparsity(),
+                              g.work(res[0], nnz()), sparsity(), "iw") << endl;
   }
 
   void DenseTranspose::generate(CodeGenerator& g, const std::string& mem,
@@ -144,17 +144,38 @@ namespace casadi {
   template<typename real_t>
   real_t CASADI_PREFIX(polyval)(const real_t* p, int n, real_t x);
 
+  /// LDL: LDL' factorization without pivoting, sp_lt is the pattern of L' from Sparsity::ldl
+  template<typename real_t>
+  void CASADI_PREFIX(ldl)(const int* sp_a, const real_t* a, const int* sp_lt, real_t* lt, real_t* d, real_t* w);
+
+  /// LDL_SOLVE: x <- inv(L*D*L')*x for nrhs right-hand sides, factorization from LDL
+  template<typename real_t>
+  void CASADI_PREFIX(ldl_solve)(real_t* x, int nrhs, const int* sp_lt, const real_t* lt, const real_t* d);
+
+  /// HOUSE: Householder reflection I - beta*v*v' mapping v to s*e_1, returns s
+  template<typename real_t>
+  real_t CASADI_PREFIX(house)(real_t* v, real_t* beta, int nv);
+
+  /// QR: Householder QR factorization of A(:, pc), sp_v, sp_r and pc from Sparsity::qr_sparse
+  template<typename real_t>
+  void CASADI_PREFIX(qr)(const int* sp_a, const real_t* nz_a, real_t* x, const int* sp_v, real_t* nz_v, const int* sp_r, real_t* nz_r, real_t* beta, const int* pc);
+
+  /// QR_SOLVE: x <- inv(A)*x or x <- inv(A')*x for nrhs right-hand sides, factorization from QR
+  template<typename real_t>
+  void CASADI_PREFIX(qr_solve)(real_t* x, int nrhs, int tr, const int* sp_v, const real_t* v, const int* sp_r, const real_t* r, const real_t* beta, const int* pc, real_t* w);
+
   // Loop over corners of a hypercube
   int CASADI_PREFIX(flip)(int* corner, int ndim);
 
-  // Find the interval to which a value belongs
+  // Find the interval to which a value belongs,
+  // lookup_mode is 0 for a linear scan, 1 for a uniform grid and 2 for a binary search
   template<typename real_t>
-  int CASADI_PREFIX(low)(real_t x, const double* grid, int ng);
+  int CASADI_PREFIX(low)(real_t x, const double* grid, int ng, int lookup_mode);
 
   // Get weights for the multilinear interpolant
   template<typename real_t>
   void CASADI_PREFIX(interpn_weights)(int ndim, const real_t* grid, const int* offset,
-    const real_t* x, real_t* alpha, int* index);
+    const real_t* x, real_t* alpha, int* index, const int* lookup_mode);
 
   // Get coefficients for the multilinear interpolant
   template<typename real_t>
@@ -164,12 +185,29 @@ namespace casadi {
   // Multiinear interpolant
   template<typename real_t>
   real_t CASADI_PREFIX(interpn)(int ndim, const real_t* grid, const int* offset,
-    const real_t* values, const real_t* x, int* iw, real_t* w);
+    const real_t* values, const real_t* x, const int* lookup_mode, int* iw, real_t* w);
 
   // Multiinear interpolant - calculate gradient
   template<typename real_t>
   void CASADI_PREFIX(interpn_grad)(real_t* grad, int ndim, const real_t* grid, const int* offset,
-                                   const real_t* values, const real_t* x, int* iw, real_t* w);
+    const real_t* values, const real_t* x, const int* lookup_mode, int* iw, real_t* w);
+
+  // Nonzero B-spline basis functions of degree k on knot span s and their first nder derivatives
+  template<typename real_t>
+  void CASADI_PREFIX(bspline_basis)(real_t x, const real_t* knots, int s, int k, int nder,
+    real_t* b);
+
+  // Tensor product sum for one partial derivative of a B-spline
+  template<typename real_t>
+  real_t CASADI_PREFIX(bspline_sum)(int ndim, const int* offset, const int* koffset,
+    const real_t* coeff, const int* ord, int nder, const int* start, int* cnt,
+    const real_t* basis);
+
+  // Tensor product B-spline: value (nder=0), gradient (nder=1) or dense Hessian (nder=2)
+  template<typename real_t>
+  void CASADI_PREFIX(bspline)(int ndim, const real_t* grid, const int* offset,
+    const real_t* knots, const int* koffset, const real_t* coeff, const real_t* x,
+    const int* lookup_mode, int nder, real_t* ret, int* iw, real_t* w);
 }
 
 // Implementations
@@ -675,17 +713,39 @@ namespace casadi {
   }
 
   template<typename real_t>
-  int CASADI_PREFIX(low)(real_t x, const double* grid, int ng) {
-    int i;
-    for (i=0; i<ng-2; ++i) {
-      if (x < grid[i]) break;
+  int CASADI_PREFIX(low)(real_t x, const double* grid, int ng, int lookup_mode) {
+    int i, j;
+    real_t r;
+    switch (lookup_mode) {
+    case 1:
+      /* Uniform grid, constant time */
+      r = (x-grid[0])*(ng-1)/(grid[ng-1]-grid[0]);
+      if (!(r>0)) return 0;
+      if (r>=ng-2) return ng-2;
+      return (int)r;
+    case 2:
+      /* Binary search for the last grid point not larger than x */
+      i = 0;
+      j = ng-2;
+      while (i<j) {
+        if (x<grid[(i+j+1)/2]) {
+          j = (i+j+1)/2-1;
+        } else {
+          i = (i+j+1)/2;
+        }
+      }
+      return i;
+    default:
+      /* Linear scan */
+      for (i=0; i<ng-2; ++i) {
+        if (x < grid[i+1]) break;
+      }
+      return i;
     }
-    return i;
   }
 
   template<typename real_t>
-  void CASADI_PREFIX(interpn_weights)(int ndim, const real_t* grid, const int* offset,
-    const real_t* x, real_t* alpha, int* index) {
+  void CASADI_PREFIX(interpn_weights)(int ndim, const real_t* grid, const int* offset, const real_t* x, real_t* alpha, int* index, const int* lookup_mode) {
     /* Left index and fraction of interval */
     int i;
     for (i=0; i<ndim; ++i) {
@@ -695,15 +755,14 @@ namespace casadi {
       const real_t* g = grid + offset[i];
       int ng = offset[i+1]-offset[i];
       /* Find left index */
-      int j = index[i] = CASADI_PREFIX(low)(xi, g, ng);
+      int j = index[i] = CASADI_PREFIX(low)(xi, g, ng, lookup_mode ? lookup_mode[i] : 0);
       /* Get interpolation/extrapolation alpha */
       alpha[i] = (xi-g[j])/(g[j+1]-g[j]);
     }
   }
 
   template<typename real_t>
-  real_t CASADI_PREFIX(interpn_interpolate)(int ndim, const int* offset, const real_t* values,
-                    const real_t* alpha, const int* index, const int* corner, real_t* coeff) {
+  real_t CASADI_PREFIX(interpn_interpolate)(int ndim, const int* offset, const real_t* values, const real_t* alpha, const int* index, const int* corner, real_t* coeff) {
     /* Get weight and value for corner */
     real_t c=1;
     int ld=1; /* leading dimension */
@@ -726,16 +785,16 @@ namespace casadi {
   }
 
   template<typename real_t>
-  real_t CASADI_PREFIX(interpn)(int ndim, const real_t* grid, const int* offset,
-    const real_t* values, const real_t* x, int* iw, real_t* w) {
+  real_t CASADI_PREFIX(interpn)(int ndim, const real_t* grid, const int* offset, const real_t* values, const real_t* x, const int* lookup_mode, int* iw, real_t* w) {
     /* Work vectors */
     real_t* alpha = w; w += ndim;
     int* index = iw; iw += ndim;
     int* corner = iw; iw += ndim;
+    int i;
     /* Left index and fraction of interval */
-    CASADI_PREFIX(interpn_weights)(ndim, grid, offset, x, alpha, index);
+    CASADI_PREFIX(interpn_weights)(ndim, grid, offset, x, alpha, index, lookup_mode);
     /* Loop over all corners, add contribution to output */
-    CASADI_PREFIX(fill)(corner, ndim, 0);
+    for (i=0; i<ndim; ++i) corner[i] = 0;
     real_t ret = 0;
     do {
       real_t* coeff = 0;
@@ -746,8 +805,7 @@ namespace casadi {
   }
 
   template<typename real_t>
-  void CASADI_PREFIX(interpn_grad)(real_t* grad, int ndim, const real_t* grid, const int* offset,
-                                   const real_t* values, const real_t* x, int* iw, real_t* w) {
+  void CASADI_PREFIX(interpn_grad)(real_t* grad, int ndim, const real_t* grid, const int* offset, const real_t* values, const real_t* x, const int* lookup_mode, int* iw, real_t* w) {
     /* Quick return */
     if (!grad) return;
     /* Work vectors */
@@ -755,17 +813,17 @@ namespace casadi {
     real_t* coeff = w; w += ndim;
     int* index = iw; iw += ndim;
     int* corner = iw; iw += ndim;
+    int i;
     /* Left index and fraction of interval */
-    CASADI_PREFIX(interpn_weights)(ndim, grid, offset, x, alpha, index);
+    CASADI_PREFIX(interpn_weights)(ndim, grid, offset, x, alpha, index, lookup_mode);
     /* Loop over all corners, add contribution to output */
-    CASADI_PREFIX(fill)(corner, ndim, 0);
+    for (i=0; i<ndim; ++i) corner[i] = 0;
     CASADI_PREFIX(fill)(grad, ndim, 0.);
     do {
       /* Get coefficients */
       real_t v = CASADI_PREFIX(interpn_interpolate)(ndim, offset, values,
         alpha, index, corner, coeff);
       /* Propagate to alpha */
-      int i;
       for (i=ndim-1; i>=0; --i) {
         if (corner[i]) {
           grad[i] += v*coeff[i];
@@ -777,7 +835,6 @@ namespace casadi {
       }
     } while (CASADI_PREFIX(flip)(corner, ndim));
     /* Propagate to x */
-    int i;
     for (i=0; i<ndim; ++i) {
       const real_t* g = grid + offset[i];
       int j = index[i];
@@ -785,6 +842,253 @@ namespace casadi {
     }
   }
 
+  template<typename real_t>
+  void CASADI_PREFIX(bspline_basis)(real_t x, const real_t* knots, int s, int k, int nder, real_t* b) {
+    int d, p, r, i;
+    real_t v, v1, den1, den2;
+    for (d=0; d<=nder; ++d, b+=k+1) {
+      for (r=0; r<=k; ++r) b[r] = 0;
+      if (d>k) continue;
+      /* Degree zero, then raise the degree in place, highest index first */
+      b[0] = 1;
+      for (p=1; p<=k; ++p) {
+        for (r=p; r>=0; --r) {
+          i = s-p+r;
+          v1 = r>0 ? b[r-1] : 0;
+          v = b[r];
+          den1 = knots[i+p]-knots[i];
+          den2 = knots[i+p+1]-knots[i+1];
+          if (den1!=0) v1 /= den1;
+          if (den2!=0) v /= den2;
+          if (p<=k-d) {
+            /* Cox-de Boor recursion */
+            b[r] = (x-knots[i])*v1 + (knots[i+p+1]-x)*v;
+          } else {
+            /* Differentiate */
+            b[r] = p*(v1-v);
+          }
+        }
+      }
+    }
+  }
+
+  template<typename real_t>
+  real_t CASADI_PREFIX(bspline_sum)(int ndim, const int* offset, const int* koffset, const real_t* coeff, const int* ord, int nder, const int* start, int* cnt, const real_t* basis) {
+    int i, ind, ld, ng;
+    real_t ret, c;
+    for (i=0; i<ndim; ++i) cnt[i] = 0;
+    ret = 0;
+    while (1) {
+      /* Contribution of one coefficient */
+      c = 1;
+      ind = 0;
+      ld = 1;
+      for (i=0; i<ndim; ++i) {
+        c *= basis[(i*(nder+1) + ord[i])*4 + cnt[i]];
+        ind += (start[i]+cnt[i])*ld;
+        ld *= offset[i+1]-offset[i];
+      }
+      ret += c*coeff[ind];
+      /* Next coefficient in the support */
+      for (i=0; i<ndim; ++i) {
+        ng = offset[i+1]-offset[i];
+        if (++cnt[i] < koffset[i+1]-koffset[i]-ng) break;
+        cnt[i] = 0;
+      }
+      if (i==ndim) return ret;
+    }
+  }
+
+  template<typename real_t>
+  void CASADI_PREFIX(bspline)(int ndim, const real_t* grid, const int* offset, const real_t* knots, const int* koffset, const real_t* coeff, const real_t* x, const int* lookup_mode, int nder, real_t* ret, int* iw, real_t* w) {
+    /* Work vectors */
+    int* start = iw; iw += ndim;
+    int* cnt = iw; iw += ndim;
+    int* ord = iw; iw += ndim;
+    int i, j, k, s, ng;
+    real_t xi;
+    /* Quick return */
+    if (!ret) return;
+    /* Locate the knot span and evaluate the basis in each dimension */
+    for (i=0; i<ndim; ++i) {
+      xi = x ? x[i] : 0;
+      ng = offset[i+1]-offset[i];
+      k = koffset[i+1]-koffset[i]-ng-1;
+      s = CASADI_PREFIX(low)(xi, grid+offset[i], ng, lookup_mode ? lookup_mode[i] : 0) + 2;
+      if (s<k) s = k;
+      if (s>ng-1) s = ng-1;
+      start[i] = s-k;
+      CASADI_PREFIX(bspline_basis)(xi, knots+koffset[i], s, k, nder, w+i*(nder+1)*4);
+      ord[i] = 0;
+    }
+    /* Sum up the requested partial derivatives */
+    if (nder==0) {
+      ret[0] = CASADI_PREFIX(bspline_sum)(ndim, offset, koffset, coeff, ord, nder, start, cnt, w);
+    } else if (nder==1) {
+      for (i=0; i<ndim; ++i) {
+        ord[i] = 1;
+        ret[i] = CASADI_PREFIX(bspline_sum)(ndim, offset, koffset, coeff, ord, nder, start, cnt, w);
+        ord[i] = 0;
+      }
+    } else {
+      for (i=0; i<ndim; ++i) {
+        for (j=i; j<ndim; ++j) {
+          ord[i]++;
+          ord[j]++;
+          ret[i*ndim+j] = ret[j*ndim+i] = CASADI_PREFIX(bspline_sum)(ndim, offset, koffset, coeff, ord, nder, start, cnt, w);
+          ord[i] = ord[j] = 0;
+        }
+      }
+    }
+  }
+
+  template<typename real_t>
+  void CASADI_PREFIX(ldl)(const int* sp_a, const real_t* a, const int* sp_lt, real_t* lt, real_t* d, real_t* w) {
+    /* Get sparsities */
+    int n=sp_lt[1];
+    const int *colind_a=sp_a+2, *row_a=sp_a+2+n+1, *colind_lt=sp_lt+2, *row_lt=sp_lt+2+n+1;
+    int c, k, k2, r;
+    /* Entries of w outside of the current column must be zero */
+    for (c=0; c<n; ++c) w[c] = 0;
+    /* Loop over the columns of L', i.e. the rows of L */
+    for (c=0; c<n; ++c) {
+      /* Scatter the upper triangular part of column c of A */
+      d[c] = 0;
+      for (k=colind_a[c]; k<colind_a[c+1]; ++k) {
+        r = row_a[k];
+        if (r<c) {
+          w[r] = a[k];
+        } else if (r==c) {
+          d[c] = a[k];
+        }
+      }
+      /* Solve with L, rows in increasing order form a topological ordering */
+      for (k=colind_lt[c]; k<colind_lt[c+1]; ++k) {
+        r = row_lt[k];
+        for (k2=colind_lt[r]; k2<colind_lt[r+1]; ++k2) w[r] -= lt[k2]*w[row_lt[k2]];
+        lt[k] = w[r]/d[r];
+        d[c] -= lt[k]*w[r];
+      }
+      /* Reset w */
+      for (k=colind_lt[c]; k<colind_lt[c+1]; ++k) w[row_lt[k]] = 0;
+    }
+  }
+
+  template<typename real_t>
+  void CASADI_PREFIX(ldl_solve)(real_t* x, int nrhs, const int* sp_lt, const real_t* lt, const real_t* d) {
+    /* Get sparsities */
+    int n=sp_lt[1];
+    const int *colind_lt=sp_lt+2, *row_lt=sp_lt+2+n+1;
+    int r, c, k;
+    for (r=0; r<nrhs; ++r) {
+      /* Solve L*y = x */
+      for (c=0; c<n; ++c) {
+        for (k=colind_lt[c]; k<colind_lt[c+1]; ++k) x[c] -= lt[k]*x[row_lt[k]];
+      }
+      /* Divide by D */
+      for (c=0; c<n; ++c) x[c] /= d[c];
+      /* Solve L'*x = y */
+      for (c=n-1; c>=0; --c) {
+        for (k=colind_lt[c]; k<colind_lt[c+1]; ++k) x[row_lt[k]] -= lt[k]*x[c];
+      }
+      x += n;
+    }
+  }
+
+  template<typename real_t>
+  real_t CASADI_PREFIX(house)(real_t* v, real_t* beta, int nv) {
+    /* Reflection of v[0] onto the positive real axis, cf. cs_house in CSparse */
+    int i;
+    real_t v0=v[0], sigma=0, s;
+    for (i=1; i<nv; ++i) sigma += v[i]*v[i];
+    if (sigma==0) {
+      s = fabs(v0);
+      *beta = v0 <= 0 ? 2 : 0;
+      v[0] = 1;
+    } else {
+      s = sqrt(v0*v0 + sigma);
+      v[0] = v0 <= 0 ? v0 - s : -sigma/(v0 + s);
+      *beta = -1/(s*v[0]);
+    }
+    return s;
+  }
+
+  template<typename real_t>
+  void CASADI_PREFIX(qr)(const int* sp_a, const real_t* nz_a, real_t* x, const int* sp_v, real_t* nz_v, const int* sp_r, real_t* nz_r, real_t* beta, const int* pc) {
+    /* Get sparsities, the first row of each column of V is the pivot row */
+    int ncol=sp_a[1];
+    const int *colind_a=sp_a+2, *row_a=sp_a+2+ncol+1;
+    const int *colind_v=sp_v+2, *row_v=sp_v+2+ncol+1;
+    const int *colind_r=sp_r+2, *row_r=sp_r+2+ncol+1;
+    int c, j, k, k1;
+    real_t alpha;
+    /* Left-looking, one column at a time */
+    for (c=0; c<ncol; ++c) {
+      /* Clear the rows touched by the column */
+      for (k=colind_v[c]; k<colind_v[c+1]; ++k) x[row_v[k]] = 0;
+      for (k=colind_r[c]; k<colind_r[c+1]; ++k) x[row_v[colind_v[row_r[k]]]] = 0;
+      /* Scatter the permuted column of A */
+      for (k=colind_a[pc[c]]; k<colind_a[pc[c]+1]; ++k) x[row_a[k]] = nz_a[k];
+      /* Apply the previous reflections, the last entry in each column of R is the diagonal */
+      for (k=colind_r[c]; k<colind_r[c+1]-1; ++k) {
+        j = row_r[k];
+        alpha = 0;
+        for (k1=colind_v[j]; k1<colind_v[j+1]; ++k1) alpha += nz_v[k1]*x[row_v[k1]];
+        alpha *= beta[j];
+        for (k1=colind_v[j]; k1<colind_v[j+1]; ++k1) x[row_v[k1]] -= alpha*nz_v[k1];
+        nz_r[k] = x[row_v[colind_v[j]]];
+      }
+      /* Gather the remaining rows and reflect them onto the pivot row */
+      for (k=colind_v[c]; k<colind_v[c+1]; ++k) nz_v[k] = x[row_v[k]];
+      k = colind_r[c+1]-1;
+      nz_r[k] = CASADI_PREFIX(house)(nz_v+colind_v[c], beta+c, colind_v[c+1]-colind_v[c]);
+    }
+  }
+
+  template<typename real_t>
+  void CASADI_PREFIX(qr_solve)(real_t* x, int nrhs, int tr, const int* sp_v, const real_t* v, const int* sp_r, const real_t* r, const real_t* beta, const int* pc, real_t* w) {
+    /* Get sparsities */
+    int nrow=sp_v[0], ncol=sp_v[1];
+    const int *colind_v=sp_v+2, *row_v=sp_v+2+ncol+1;
+    const int *colind_r=sp_r+2, *row_r=sp_r+2+ncol+1;
+    int c, k, rhs;
+    real_t alpha;
+    for (rhs=0; rhs<nrhs; ++rhs) {
+      if (tr) {
+        /* Solve R'*y = x(pc), y(c) is stored at the pivot row of column c */
+        for (k=0; k<nrow; ++k) w[k] = 0;
+        for (c=0; c<ncol; ++c) {
+          alpha = x[pc[c]];
+          for (k=colind_r[c]; k<colind_r[c+1]-1; ++k) alpha -= r[k]*w[row_v[colind_v[row_r[k]]]];
+          w[row_v[colind_v[c]]] = alpha/r[colind_r[c+1]-1];
+        }
+        /* Multiply with Q */
+        for (c=ncol-1; c>=0; --c) {
+          alpha = 0;
+          for (k=colind_v[c]; k<colind_v[c+1]; ++k) alpha += v[k]*w[row_v[k]];
+          alpha *= beta[c];
+          for (k=colind_v[c]; k<colind_v[c+1]; ++k) w[row_v[k]] -= alpha*v[k];
+        }
+        for (k=0; k<nrow; ++k) x[k] = w[k];
+      } else {
+        /* Multiply with Q' */
+        for (k=0; k<nrow; ++k) w[k] = x[k];
+        for (c=0; c<ncol; ++c) {
+          alpha = 0;
+          for (k=colind_v[c]; k<colind_v[c+1]; ++k) alpha += v[k]*w[row_v[k]];
+          alpha *= beta[c];
+          for (k=colind_v[c]; k<colind_v[c+1]; ++k) w[row_v[k]] -= alpha*v[k];
+        }
+        /* Solve with R, back substitution */
+        for (c=ncol-1; c>=0; --c) {
+          alpha = w[row_v[colind_v[c]]] /= r[colind_r[c+1]-1];
+          for (k=colind_r[c]; k<colind_r[c+1]-1; ++k) w[row_v[colind_v[row_r[k]]]] -= r[k]*alpha;
+        }
+        for (c=0; c<ncol; ++c) x[pc[c]] = w[row_v[colind_v[c]]];
+      }
+      x += nrow;
+    }
+  }
 
 } // namespace casadi
 
@@ -27,6 +27,9 @@
 #include "weak_ref.hpp"
 
 #include <typeinfo>
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <mutex>
+#endif // WITH_THREADSAFE_SYMBOLICS
 
 using namespace std;
 namespace casadi {
@@ -169,6 +172,10 @@ namespace casadi {
   }
 
   WeakRef* SharedObjectNode::weak() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    static mutex weak_mtx;
+    lock_guard<mutex> lock(weak_mtx);
+#endif // WITH_THREADSAFE_SYMBOLICS
     if (weak_ref_==0) {
       weak_ref_ = new WeakRef(this);
     }
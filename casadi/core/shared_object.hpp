@@ -159,6 +159,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectNode {
     friend class SharedObject;
+    friend class WeakRef;
     friend class Memory;
   public:
 
@@ -208,7 +209,11 @@ namespace casadi {
 
   private:
     /// Number of references pointing to the object
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::atomic<unsigned int> count;
+#else // WITH_THREADSAFE_SYMBOLICS
     unsigned int count;
+#endif // WITH_THREADSAFE_SYMBOLICS
 
     /// Weak pointer (non-owning) object for the object
     WeakRef* weak_ref_;
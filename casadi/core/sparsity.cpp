@@ -27,6 +27,7 @@
 #include "matrix.hpp"
 #include "std_vector_tools.hpp"
 #include <climits>
+#include <mutex>
 
 using namespace std;
 
@@ -470,10 +471,13 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
-  }
+  /// Cached sparsity patterns, split by hash to reduce contention between threads
+  struct SparsityCacheShard {
+    std::mutex mtx;
+    Sparsity::CachingMap cache;
+  };
+  static const int SPARSITY_CACHE_N_SHARDS = 16;
+  static SparsityCacheShard sparsity_cache[SPARSITY_CACHE_N_SHARDS];
 
   const Sparsity& Sparsity::getScalar() {
     static ScalarSparsity ret;
@@ -549,6 +553,14 @@ namespace casadi {
     return (*this)->etree(ata);
   }
 
+  Sparsity Sparsity::ldl(std::vector<int>& p, bool amd) const {
+    return (*this)->ldl(p, amd);
+  }
+
+  void Sparsity::qr_sparse(Sparsity& V, Sparsity& R, std::vector<int>& pc, bool amd) const {
+    (*this)->qr_sparse(V, R, pc, amd);
+  }
+
   int Sparsity::dfs(int j, int top, std::vector<int>& xi,
                                  std::vector<int>& pstack, const std::vector<int>& pinv,
                                  std::vector<bool>& marked) const {
@@ -671,7 +683,9 @@ namespace casadi {
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
     // Get a reference to the cache
-    CachingMap& cache = getCache();
+    SparsityCacheShard& shard = sparsity_cache[h % SPARSITY_CACHE_N_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    CachingMap& cache = shard.cache;
 
     // Record the current number of buckets (for garbage collection below)
     int bucket_count_before = cache.bucket_count();
@@ -688,11 +702,9 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
-
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Get an owning reference to the cached pattern, if it still exists
+        Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        if (!ref.is_null()) {
 
           // Check if the pattern matches
           if (ref.is_equal(nrow, ncol, colind, row)) {
@@ -711,10 +723,9 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            // Recover cached sparsity
+            Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            if (!ref.is_null()) {
 
               // Match found if sparsity matches
               if (ref.is_equal(nrow, ncol, colind, row)) {
@@ -557,9 +557,6 @@ namespace casadi {
 #ifndef SWIG
     typedef std::unordered_multimap<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
-
     /// (Dense) scalar
     static const Sparsity& getScalar();
 
@@ -579,6 +576,26 @@ namespace casadi {
     */
     std::vector<int> etree(bool ata=false) const;
 
+    /** \brief Symbolic LDL factorization
+        Returns the sparsity pattern of L' for an LDL' factorization of the symmetric
+        matrix permuted symmetrically with p, A(p, p) = L*D*L', where L is unit lower
+        triangular. The rows in each column of the returned pattern are sorted.
+        If amd is true, p is an approximate minimum degree ordering, otherwise the
+        natural ordering.
+    */
+    Sparsity ldl(std::vector<int>& SWIG_OUTPUT(p), bool amd=true) const;
+
+    /** \brief Symbolic QR factorization
+        Returns the sparsity patterns of the Householder vectors V and the upper triangular
+        factor R of a Householder QR factorization of the matrix with permuted columns,
+        A(:, pc) = Q*R with Q = (I-beta_0*v_0*v_0')*...*(I-beta_{n-1}*v_{n-1}*v_{n-1}').
+        The first row in column j of V is the pivot row, which ends up holding row j of R.
+        If amd is true, pc is an approximate minimum degree ordering of A'*A, otherwise
+        the natural ordering.
+    */
+    void qr_sparse(Sparsity& SWIG_OUTPUT(V), Sparsity& SWIG_OUTPUT(R),
+                   std::vector<int>& SWIG_OUTPUT(pc), bool amd=true) const;
+
     /** \brief Depth-first search on the adjacency graph of the sparsity
         See Direct Methods for Sparse Linear Systems by Davis (2006).
     */
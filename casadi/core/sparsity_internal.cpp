@@ -25,9 +25,14 @@
 
 #include "sparsity_internal.hpp"
 #include "std_vector_tools.hpp"
+#include "global_options.hpp"
 #include <climits>
 #include <cstdlib>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <queue>
 #include "matrix.hpp"
 
 using namespace std;
@@ -206,6 +211,133 @@ namespace casadi {
 
   }
 
+  Sparsity SparsityInternal::ldl(std::vector<int>& p, bool amd) const {
+    casadi_assert_message(is_symmetric(), "LDL factorization requires a symmetric pattern");
+    int n = size2();
+    const int* colind = this->colind();
+    const int* row = this->row();
+
+    // Fill-reducing ordering
+    if (amd && n>2) {
+      p = this->amd(1);
+      p.resize(n);
+    } else {
+      p = range(n);
+    }
+    vector<int> iperm(n);
+    for (int k=0; k<n; ++k) iperm[p[k]] = k;
+
+    // Upper triangular part of the permuted pattern
+    vector<int> u_row, u_col;
+    for (int c=0; c<n; ++c) {
+      for (int k=colind[c]; k<colind[c+1]; ++k) {
+        int i = iperm[row[k]], j = iperm[c];
+        if (i<=j) {
+          u_row.push_back(i);
+          u_col.push_back(j);
+        }
+      }
+    }
+    Sparsity u = Sparsity::triplet(n, n, u_row, u_col);
+    const int* u_colind = u.colind();
+    const int* u_rowp = u.row();
+
+    // Elimination tree
+    vector<int> parent = u.etree();
+
+    // Column k of L' is the set of nodes reached from the rows of column k of U
+    vector<int> flag(n, -1), lt_colind(1, 0), lt_row;
+    for (int k=0; k<n; ++k) {
+      flag[k] = k;
+      for (int q=u_colind[k]; q<u_colind[k+1]; ++q) {
+        for (int i=u_rowp[q]; flag[i]!=k; i=parent[i]) {
+          flag[i] = k;
+          lt_row.push_back(i);
+        }
+      }
+      sort(lt_row.begin()+lt_colind.back(), lt_row.end());
+      lt_colind.push_back(lt_row.size());
+    }
+    return Sparsity(n, n, lt_colind, lt_row);
+  }
+
+  void SparsityInternal::qr_sparse(Sparsity& V, Sparsity& R, std::vector<int>& pc,
+                                   bool amd) const {
+    int nrow = size1(), ncol = size2();
+    casadi_assert_message(nrow>=ncol,
+                          "QR factorization requires at least as many rows as columns");
+    const int* colind = this->colind();
+    const int* row = this->row();
+
+    // Fill-reducing column ordering
+    if (amd && ncol>2) {
+      pc = this->amd(3);
+      pc.resize(ncol);
+    } else {
+      pc = range(ncol);
+    }
+
+    // Columns of V containing each row, rows that have been used as pivots
+    vector<vector<int> > row2v(nrow);
+    vector<bool> pivot(nrow, false);
+
+    // Rows touched by the current column, reflections queued for it
+    vector<int> rmark(nrow, -1), cmark(ncol, -1), xr;
+    priority_queue<int, vector<int>, greater<int> > q;
+
+    vector<int> v_colind(1, 0), v_row, r_colind(1, 0), r_row;
+    for (int c=0; c<ncol; ++c) {
+      // Pattern of the permuted column of A
+      xr.clear();
+      for (int k=colind[pc[c]]; k<colind[pc[c]+1]; ++k) {
+        int i = row[k];
+        rmark[i] = c;
+        xr.push_back(i);
+        for (int j : row2v[i]) {
+          if (cmark[j]!=c) {
+            cmark[j] = c;
+            q.push(j);
+          }
+        }
+      }
+
+      // Apply the reflections in order, each adds the pattern of its column of V
+      while (!q.empty()) {
+        int j = q.top();
+        q.pop();
+        r_row.push_back(j);
+        for (int k=v_colind[j]; k<v_colind[j+1]; ++k) {
+          int i = v_row[k];
+          if (rmark[i]==c) continue;
+          rmark[i] = c;
+          xr.push_back(i);
+          for (int j1 : row2v[i]) {
+            if (j1>j && cmark[j1]!=c) {
+              cmark[j1] = c;
+              q.push(j1);
+            }
+          }
+        }
+      }
+      r_row.push_back(c);
+      r_colind.push_back(r_row.size());
+
+      // The rows not yet used as pivots form the column of V
+      int nv0 = v_row.size();
+      for (int i : xr) if (!pivot[i]) v_row.push_back(i);
+      casadi_assert_message(v_row.size()>nv0,
+                            "QR factorization: the matrix is structurally rank-deficient");
+      sort(v_row.begin()+nv0, v_row.end());
+      v_colind.push_back(v_row.size());
+      for (int k=nv0; k<v_row.size(); ++k) row2v[v_row[k]].push_back(c);
+
+      // The first row becomes the pivot
+      pivot[v_row[nv0]] = true;
+    }
+    V = Sparsity(nrow, ncol, v_colind, v_row);
+    R = Sparsity(ncol, ncol, r_colind, r_row);
+  }
+
   int SparsityInternal::dfs(int j, int top, std::vector<int>& xi,
                                          std::vector<int>& pstack, const std::vector<int>& pinv,
                                          std::vector<bool>& marked) const {
@@ -1784,7 +1916,7 @@ namespace casadi {
     // allocate result
     vector<int> C_colind(n+1, 0), C_row;
 
-    C_colind.resize(anz + bnz);
+    C_row.resize(anz + bnz);
 
     int* Cp = &C_colind.front();
     for (int j=0; j<n; ++j) {
@@ -3113,6 +3245,22 @@ namespace casadi {
 
   Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, int cutoff) const {
 
+    // Color in parallel if requested and the graph is large enough to pay off
+    int n_threads = GlobalOptions::sparsity_num_threads;
+    if (n_threads>1 && size2()>=256*n_threads) {
+      vector<int> color;
+      int ncolor = uni_coloring_threaded(AT, cutoff, n_threads, color);
+      if (ncolor<0) return Sparsity();
+
+      // Create return sparsity containing the coloring
+      vector<int> ret_colind(ncolor+1, 0), ret_row(color.size());
+      for (int i=0; i<color.size(); ++i) ret_colind[color[i]+1]++;
+      for (int j=0; j<ncolor; ++j) ret_colind[j+1] += ret_colind[j];
+      vector<int> pos(ret_colind.begin(), ret_colind.end()-1);
+      for (int i=0; i<color.size(); ++i) ret_row[pos[color[i]]++] = i;
+      return Sparsity(size2(), ncolor, ret_colind, ret_row);
+    }
+
     // Allocate temporary vectors
     vector<int> forbiddenColors;
     forbiddenColors.reserve(size2());
@@ -3200,6 +3348,109 @@ namespace casadi {
 ;
   }
 
+  int SparsityInternal::uni_coloring_threaded(const Sparsity& AT, int cutoff, int n_threads,
+                                              std::vector<int>& color) const {
+    // Access the sparsity of the transpose
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    const int* colind = this->colind();
+    const int* row = this->row();
+
+    // Colors are read by other threads while being assigned
+    int n = size2();
+    vector<std::atomic<int> > color_a(n);
+    for (int i=0; i<n; ++i) color_a[i].store(-1, std::memory_order_relaxed);
+
+    // Columns that remain to be colored, initially all
+    vector<int> todo = range(n);
+
+    // Work is handed out in chunks of columns
+    const int chunk = 64;
+
+    // Run a parallel loop over the columns in todo, the calling thread acts as worker 0
+    std::function<void(std::function<void(int, int)>&)> run([&](std::function<void(int, int)>& f) {
+      std::atomic<int> next(0);
+      std::function<void(int)> work([&](int t) {
+        for (int k=next.fetch_add(chunk); k<todo.size(); k=next.fetch_add(chunk)) {
+          int k_end = std::min(k+chunk, static_cast<int>(todo.size()));
+          for (; k<k_end; ++k) f(t, todo[k]);
+        }
+      });
+      vector<std::thread> workers;
+      for (int t=1; t<n_threads; ++t) workers.emplace_back(work, t);
+      work(0);
+      for (auto&& th : workers) th.join();
+    });
+
+    // Per-thread forbidden colors and conflicting columns
+    vector<vector<int> > forbidden(n_threads);
+    vector<vector<int> > conflicts(n_threads);
+
+    // Speculatively color the columns, ignoring conflicts with concurrently colored columns
+    std::function<void(int, int)> assign([&](int t, int i) {
+      vector<int>& fc = forbidden[t];
+      for (int el=colind[i]; el<colind[i+1]; ++el) {
+        int c = row[el];
+        for (int el_nb=AT_colind[c]; el_nb<AT_colind[c+1]; ++el_nb) {
+          int i_nb = AT_row[el_nb];
+          if (i_nb==i) continue;
+          int color_nb = color_a[i_nb].load(std::memory_order_relaxed);
+          if (color_nb<0) continue;
+          if (color_nb>=fc.size()) fc.resize(color_nb+1, -1);
+          fc[color_nb] = i;
+        }
+      }
+      // Get the first nonforbidden color
+      int color_i;
+      for (color_i=0; color_i<fc.size(); ++color_i) {
+        if (fc[color_i]!=i) break;
+      }
+      color_a[i].store(color_i, std::memory_order_relaxed);
+    });
+
+    // Detect conflicts, the column with the larger index is recolored
+    std::function<void(int, int)> detect([&](int t, int i) {
+      int color_i = color_a[i].load(std::memory_order_relaxed);
+      for (int el=colind[i]; el<colind[i+1]; ++el) {
+        int c = row[el];
+        for (int el_nb=AT_colind[c]; el_nb<AT_colind[c+1]; ++el_nb) {
+          int i_nb = AT_row[el_nb];
+          if (i_nb>=i) break;
+          if (color_a[i_nb].load(std::memory_order_relaxed)==color_i) {
+            conflicts[t].push_back(i);
+            return;
+          }
+        }
+      }
+    });
+
+    // Iterate until no conflicts remain
+    int ncolor = 0;
+    while (!todo.empty()) {
+      run(assign);
+      run(detect);
+
+      // Stop if too many colors
+      for (int k=0; k<todo.size(); ++k) {
+        ncolor = std::max(ncolor, color_a[todo[k]].load(std::memory_order_relaxed)+1);
+      }
+      if (ncolor>cutoff) return -1;
+
+      // Columns to be recolored
+      todo.clear();
+      for (auto&& c : conflicts) {
+        todo.insert(todo.end(), c.begin(), c.end());
+        c.clear();
+      }
+      std::sort(todo.begin(), todo.end());
+    }
+
+    // Return the coloring
+    color.resize(n);
+    for (int i=0; i<n; ++i) color[i] = color_a[i].load(std::memory_order_relaxed);
+    return ncolor;
+  }
+
   Sparsity SparsityInternal::star_coloring2(int ordering, int cutoff) const {
     casadi_assert_warning(size2()==size1(),
                           "StarColoring requires a square matrix, but got "
@@ -83,6 +83,12 @@ namespace casadi {
     /// Calculate the elimination tree: See cs_etree in CSparse
     std::vector<int> etree(bool ata) const;
 
+    /// Symbolic LDL factorization, returns the pattern of L'
+    Sparsity ldl(std::vector<int>& p, bool amd) const;
+
+    /// Symbolic Householder QR factorization, patterns of V and R
+    void qr_sparse(Sparsity& V, Sparsity& R, std::vector<int>& pc, bool amd) const;
+
     /// Find strongly connected components: See cs_dfs in CSparse
     int dfs(int j, int top, std::vector<int>& xi, std::vector<int>& pstack,
                          const std::vector<int>& pinv, std::vector<bool>& marked) const;
@@ -421,6 +427,15 @@ namespace casadi {
      */
     Sparsity uni_coloring(const Sparsity& AT, int cutoff) const;
 
+    /** \brief Parallel distance-2 coloring, used by uni_coloring
+     *
+     * Speculative coloring with conflict resolution
+     * (Algorithm 4.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN).
+     * Returns the number of colors, or -1 if more than cutoff colors are needed.
+     */
+    int uni_coloring_threaded(const Sparsity& AT, int cutoff, int n_threads,
+                              std::vector<int>& color) const;
+
     /** \brief A greedy distance-2 coloring algorithm
      * See description in public class.
      */
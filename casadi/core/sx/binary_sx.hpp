@@ -72,7 +72,7 @@ class CASADI_EXPORT BinarySX : public SXNode {
         SXNode* n1 = dep(c1).assignNoDelete(casadi_limits<SXElem>::nan);
 
         // Check if this was the last reference
-        if (n1->count==0) {
+        if (n1) {
 
           // Check if binary
           if (!n1->hasDep()) { // n1 is not binary
@@ -102,7 +102,7 @@ class CASADI_EXPORT BinarySX : public SXNode {
                 SXNode *n2 = t->dep(c2).assignNoDelete(casadi_limits<SXElem>::nan);
 
                 // Check if this is the only reference to the element
-                if (n2->count == 0) {
+                if (n2) {
 
                   // Check if binary
                   if (!n2->hasDep()) {
@@ -47,6 +47,14 @@ public:
 // Destructor
 virtual ~ConstantSX() {}
 
+#ifdef WITH_SX_ARENA
+///@{
+/** \brief  Constants are shared through a cache, always allocate on the heap */
+static void* operator new(std::size_t sz) { return ::operator new(sz);}
+static void operator delete(void* ptr) { ::operator delete(ptr);}
+///@}
+#endif // WITH_SX_ARENA
+
 /** \brief  Get the value must be defined */
 virtual double to_double() const = 0;
 
@@ -88,13 +96,19 @@ class CASADI_EXPORT RealtypeSX : public ConstantSX {
 
     /// Destructor
     virtual ~RealtypeSX() {
+#ifndef WITH_THREADSAFE_SYMBOLICS
       size_t num_erased = cached_constants_.erase(value);
       assert(num_erased==1);
       (void)num_erased;
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
     /// Static creator function (use instead of constructor)
     inline static RealtypeSX* create(double value) {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      // Not cached, the expressions using the constant may belong to different threads
+      return new RealtypeSX(value);
+#else // WITH_THREADSAFE_SYMBOLICS
       // Try to find the constant
       CACHING_MAP<double, RealtypeSX*>::iterator it = cached_constants_.find(value);
 
@@ -111,6 +125,7 @@ class CASADI_EXPORT RealtypeSX : public ConstantSX {
       } else { // Else, returned the object
         return it->second;
       }
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
     ///@{
@@ -144,13 +159,19 @@ class CASADI_EXPORT IntegerSX : public ConstantSX {
 
     /// Destructor
     virtual ~IntegerSX() {
+#ifndef WITH_THREADSAFE_SYMBOLICS
       size_t num_erased = cached_constants_.erase(value);
       assert(num_erased==1);
       (void)num_erased;
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
     /// Static creator function (use instead of constructor)
     inline static IntegerSX* create(int value) {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+      // Not cached, the expressions using the constant may belong to different threads
+      return new IntegerSX(value);
+#else // WITH_THREADSAFE_SYMBOLICS
       // Try to find the constant
       CACHING_MAP<int, IntegerSX*>::iterator it = cached_constants_.find(value);
 
@@ -167,6 +188,7 @@ class CASADI_EXPORT IntegerSX : public ConstantSX {
       } else { // Else, returned the object
         return it->second;
       }
+#endif // WITH_THREADSAFE_SYMBOLICS
     }
 
     ///@{
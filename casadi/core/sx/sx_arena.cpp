@@ -0,0 +1,169 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "sx_arena.hpp"
+#include "../exception.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <new>
+
+using namespace std;
+namespace casadi {
+
+  /// Granularity of the allocations
+  static const size_t SX_ARENA_ALIGN = sizeof(void*);
+
+  /// Allocations up to this size are recycled
+  static const size_t SX_ARENA_N_FREE = 32;
+
+  struct SXArenaInternal {
+    /// Blocks of memory
+    vector<char*> blocks;
+
+    /// Block size
+    size_t block_size;
+
+    /// Unused part of the current block
+    char *pos, *end;
+
+    /// Number of nodes alive, plus one as long as the arena is in scope
+    atomic<size_t> n_live;
+
+    /// Freed memory, by size, only accessed by the thread the arena is active in
+    vector<char*> free_list[SX_ARENA_N_FREE];
+  };
+
+  /// Arenas in scope in the current thread, the active one last
+  static thread_local vector<SXArenaInternal*> sx_arena_stack;
+
+  /// Arena active in the current thread
+  static thread_local SXArenaInternal* sx_arena_active = 0;
+
+  /// Owner of an allocation, stored in front of it, null if on the heap
+  static inline SXArenaInternal*& sx_arena_owner(char* p) {
+    return *reinterpret_cast<SXArenaInternal**>(p);
+  }
+
+  /// Release the memory of an arena
+  static void sx_arena_release(SXArenaInternal* m) {
+    for (char* b : m->blocks) delete[] b;
+    delete m;
+  }
+
+  SXArena::SXArena(size_t block_size) {
+    casadi_assert_message(block_size>=1024, "SXArena: block size too small");
+    mem_ = new SXArenaInternal();
+    mem_->block_size = block_size;
+    mem_->pos = mem_->end = 0;
+    mem_->n_live = 1;
+
+    // Activate
+    sx_arena_stack.push_back(mem_);
+    sx_arena_active = mem_;
+  }
+
+  SXArena::~SXArena() {
+    // Remove from the stack, the innermost arena still in scope becomes active
+    auto it = find(sx_arena_stack.rbegin(), sx_arena_stack.rend(), mem_);
+    if (it!=sx_arena_stack.rend()) sx_arena_stack.erase(next(it).base());
+    sx_arena_active = sx_arena_stack.empty() ? 0 : sx_arena_stack.back();
+
+    // Release memory unless nodes are still alive
+    if (--mem_->n_live==0) sx_arena_release(mem_);
+  }
+
+  size_t SXArena::n_nodes() const {
+    return mem_->n_live - 1;
+  }
+
+  size_t SXArena::n_bytes() const {
+    return mem_->blocks.size()*mem_->block_size;
+  }
+
+  int SXArena::depth() {
+    return sx_arena_stack.size();
+  }
+
+  bool SXArena::enabled() {
+#ifdef WITH_SX_ARENA
+    return true;
+#else // WITH_SX_ARENA
+    return false;
+#endif // WITH_SX_ARENA
+  }
+
+  void* SXArena::allocate(size_t sz) {
+    SXArenaInternal* m = sx_arena_active;
+    if (m==0) {
+      char* p = static_cast<char*>(::operator new(SX_ARENA_ALIGN + sz));
+      sx_arena_owner(p) = 0;
+      return p + SX_ARENA_ALIGN;
+    }
+
+    // Round up, with room for the owner
+    sz = SX_ARENA_ALIGN*(1 + (sz+SX_ARENA_ALIGN-1)/SX_ARENA_ALIGN);
+    casadi_assert(4*sz<=m->block_size);
+    m->n_live++;
+
+    // Reuse freed memory, if possible
+    size_t k = sz/SX_ARENA_ALIGN;
+    char* p;
+    if (k<SX_ARENA_N_FREE && !m->free_list[k].empty()) {
+      p = m->free_list[k].back();
+      m->free_list[k].pop_back();
+    } else {
+      // New block
+      if (static_cast<size_t>(m->end-m->pos) < sz) {
+        char* b = new char[m->block_size];
+        m->blocks.push_back(b);
+        m->pos = b;
+        m->end = b + m->block_size;
+      }
+
+      // Take from the current block
+      p = m->pos;
+      m->pos += sz;
+    }
+    sx_arena_owner(p) = m;
+    return p + SX_ARENA_ALIGN;
+  }
+
+  void SXArena::deallocate(void* ptr, size_t sz) {
+    char* p = static_cast<char*>(ptr) - SX_ARENA_ALIGN;
+    SXArenaInternal* m = sx_arena_owner(p);
+    if (m==0) return ::operator delete(p);
+
+    // Recycle if the arena is active in the current thread
+    if (m==sx_arena_active) {
+      size_t k = 1 + (sz+SX_ARENA_ALIGN-1)/SX_ARENA_ALIGN;
+      if (k<SX_ARENA_N_FREE) m->free_list[k].push_back(p);
+    }
+
+    // Release the arena with the last node
+    if (--m->n_live==0) sx_arena_release(m);
+  }
+
+} // namespace casadi
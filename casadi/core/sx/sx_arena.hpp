@@ -0,0 +1,111 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_SX_ARENA_HPP
+#define CASADI_SX_ARENA_HPP
+
+#include "../casadi_common.hpp"
+#include <cstddef>
+
+namespace casadi {
+
+#ifndef SWIG
+  /// \cond INTERNAL
+  struct SXArenaInternal;
+  /// \endcond
+
+  /** \brief Arena allocator for the nodes of scalar expressions
+
+      While an SXArena object is in scope, the expression nodes created by
+      the current thread are placed in large, contiguous blocks of memory
+      owned by the arena instead of being allocated one by one on the heap.
+      Each node is preceded by a pointer to its arena, so that freeing it
+      only decreases a counter, or recycles the memory if the arena is the
+      active one. The blocks are released together when the arena has gone
+      out of scope and the last node allocated in it has been freed, so
+      expressions may safely outlive the arena.
+
+      Arenas in the same thread form a stack, the innermost one in scope
+      being active. They may go out of scope in any order, but must be
+      destroyed by the thread that created them.
+
+      Constants are shared between expressions through a global cache and
+      are always allocated on the heap.
+
+      Arena allocation requires CasADi to be built with WITH_SX_ARENA, which
+      leaves the default allocation of SX nodes unchanged when disabled.
+      Otherwise, an SXArena has no effect and enabled() returns false.
+
+      \code
+      {
+        SXArena arena;
+        SX x = SX::sym("x", 1000);
+        ... // build and use a large temporary expression
+      } // memory returned in blocks
+      \endcode
+  */
+  class CASADI_EXPORT SXArena {
+  public:
+    /** \brief Create an arena and make it active in the current thread
+        \param block_size Size in bytes of each allocated block of memory
+    */
+    explicit SXArena(size_t block_size=1<<20);
+
+    /** \brief Deactivate the arena, release the memory if no nodes are alive */
+    ~SXArena();
+
+    /// Number of nodes allocated in the arena that are still alive
+    size_t n_nodes() const;
+
+    /// Number of bytes reserved by the arena
+    size_t n_bytes() const;
+
+    /// Number of arenas in scope in the current thread
+    static int depth();
+
+    /// Are SX nodes allocated in arenas, i.e. was CasADi built with WITH_SX_ARENA
+    static bool enabled();
+
+    /// \cond INTERNAL
+    /** \brief Allocate memory for a node, in the active arena if any */
+    static void* allocate(size_t sz);
+
+    /** \brief Free memory of a node, allocated with allocate */
+    static void deallocate(void* ptr, size_t sz);
+    /// \endcond
+
+  private:
+    /// Not copyable
+    SXArena(const SXArena&);
+    SXArena& operator=(const SXArena&);
+
+    /// Arena data, may outlive the object
+    SXArenaInternal* mem_;
+  };
+#endif // SWIG
+
+} // namespace casadi
+
+#endif // CASADI_SX_ARENA_HPP
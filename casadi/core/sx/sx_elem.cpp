@@ -111,17 +111,17 @@ namespace casadi {
     SXNode* ret = node;
 
     // quick return if the old and new pointers point to the same object
-    if (node == scalar.node) return ret;
+    if (node == scalar.node) return 0;
 
     // decrease the counter but do not delete if this was the last pointer
-    --node->count;
+    bool last = --node->count == 0;
 
     // save the new pointer
     node = scalar.node;
     node->count++;
 
-    // Return a pointer to the old node
-    return ret;
+    // Return a pointer to the old node if no references remain
+    return last ? ret : 0;
   }
 
   SXElem& SXElem::operator=(double scalar) {
@@ -525,16 +525,16 @@ namespace casadi {
   }
 
   // node corresponding to a constant 0
-  const SXElem casadi_limits<SXElem>::zero(new ZeroSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::zero(new ZeroSX(), false);
   // node corresponding to a constant 1
-  const SXElem casadi_limits<SXElem>::one(new OneSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::one(new OneSX(), false);
   // node corresponding to a constant 2
-  const SXElem casadi_limits<SXElem>::two(IntegerSX::create(2), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::two(IntegerSX::create(2), false);
   // node corresponding to a constant -1
-  const SXElem casadi_limits<SXElem>::minus_one(new MinusOneSX(), false);
-  const SXElem casadi_limits<SXElem>::nan(new NanSX(), false);
-  const SXElem casadi_limits<SXElem>::inf(new InfSX(), false);
-  const SXElem casadi_limits<SXElem>::minus_inf(new MinusInfSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::minus_one(new MinusOneSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::nan(new NanSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::inf(new InfSX(), false);
+  CASADI_THREAD_LOCAL const SXElem casadi_limits<SXElem>::minus_inf(new MinusInfSX(), false);
 
   bool casadi_limits<SXElem>::is_zero(const SXElem& val) {
     return val.is_zero();
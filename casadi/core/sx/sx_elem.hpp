@@ -205,7 +205,7 @@ namespace casadi {
     void assignIfDuplicate(const SXElem& scalar, int depth=1);
 
     /** \brief Assign the node to something, without invoking the deletion of the node,
-     * if the count reaches 0 */
+     * if the count reaches 0. The old node is returned if this happened, otherwise null */
     SXNode* assignNoDelete(const SXElem& scalar);
     /// \endcond
 
@@ -241,13 +241,13 @@ namespace casadi {
     static bool isMinusInf(const SXElem& val);
     static bool isNaN(const SXElem& val);
 
-    static const SXElem zero;
-    static const SXElem one;
-    static const SXElem two;
-    static const SXElem minus_one;
-    static const SXElem nan;
-    static const SXElem inf;
-    static const SXElem minus_inf;
+    static CASADI_THREAD_LOCAL const SXElem zero;
+    static CASADI_THREAD_LOCAL const SXElem one;
+    static CASADI_THREAD_LOCAL const SXElem two;
+    static CASADI_THREAD_LOCAL const SXElem minus_one;
+    static CASADI_THREAD_LOCAL const SXElem nan;
+    static CASADI_THREAD_LOCAL const SXElem inf;
+    static CASADI_THREAD_LOCAL const SXElem minus_inf;
   };
 
 #endif // SWIG
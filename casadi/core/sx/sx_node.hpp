@@ -33,6 +33,7 @@
 
 /** \brief  Scalar expression (which also works as a smart pointer class to this class) */
 #include "sx_elem.hpp"
+#include "sx_arena.hpp"
 
 
 /// \cond INTERNAL
@@ -54,6 +55,14 @@ namespace casadi {
     /** \brief  destructor  */
     virtual ~SXNode();
 
+#ifdef WITH_SX_ARENA
+    ///@{
+    /** \brief  Allocation, in the active SXArena if any */
+    static void* operator new(std::size_t sz) { return SXArena::allocate(sz);}
+    static void operator delete(void* ptr, std::size_t sz) { SXArena::deallocate(ptr, sz);}
+    ///@}
+#endif // WITH_SX_ARENA
+
     ///@{
     /** \brief  check properties of a node */
     virtual bool is_constant() const; // check if constant
@@ -124,7 +133,11 @@ namespace casadi {
     int temp;
 
     // Reference counter -- counts the number of parents of the node
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    std::atomic<unsigned int> count;
+#else // WITH_THREADSAFE_SYMBOLICS
     unsigned int count;
+#endif // WITH_THREADSAFE_SYMBOLICS
 
   };
 
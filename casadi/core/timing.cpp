@@ -24,6 +24,8 @@
 
 
 #include "timing.hpp"
+#include <iomanip>
+#include <sstream>
 
 namespace casadi {
 
@@ -55,4 +57,122 @@ namespace casadi {
     n_call +=1;
   }
 
+  ProfileNode::ProfileNode(const std::string& name, const std::string& type)
+    : name(name), type(type), n_call(0), t_wall(0), t_proc(0), w_bytes(0), flops(-1) {
+  }
+
+  ProfileNode& ProfileNode::child(const std::string& name, const std::string& type) {
+    for (auto&& c : children) if (c.name==name) return c;
+    children.push_back(ProfileNode(name, type));
+    return children.back();
+  }
+
+  void ProfileNode::merge(const ProfileNode& other) {
+    n_call += other.n_call;
+    t_wall += other.t_wall;
+    t_proc += other.t_proc;
+    w_bytes = std::max(w_bytes, other.w_bytes);
+    flops = other.flops;
+    for (auto&& c : other.children) child(c.name, c.type).merge(c);
+  }
+
+  Dict ProfileNode::to_dict() const {
+    Dict ret;
+    ret["type"] = type;
+    ret["n_call"] = n_call;
+    ret["t_wall"] = t_wall;
+    ret["t_proc"] = t_proc;
+    ret["w_bytes"] = static_cast<int>(w_bytes);
+    if (flops>=0) ret["flops"] = flops*n_call;
+    Dict c;
+    for (auto&& e : children) c[e.name] = e.to_dict();
+    ret["children"] = c;
+    return ret;
+  }
+
+  /// Quoted JSON string, with quotes, backslashes and control characters escaped
+  static std::string json_string(const std::string& s) {
+    std::stringstream ss;
+    ss << '"';
+    for (unsigned char c : s) {
+      if (c=='"' || c=='\\') {
+        ss << '\\' << c;
+      } else if (c<0x20) {
+        ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+           << std::dec;
+      } else {
+        ss << c;
+      }
+    }
+    ss << '"';
+    return ss.str();
+  }
+
+  void ProfileNode::to_json(std::ostream& stream, int indent) const {
+    std::string pad(indent, ' ');
+    stream << pad << "{\"name\": " << json_string(name) << ", "
+           << "\"type\": " << json_string(type) << ", "
+           << "\"n_call\": " << n_call << ", \"t_wall\": " << t_wall << ", "
+           << "\"t_proc\": " << t_proc << ", \"w_bytes\": " << w_bytes;
+    if (flops>=0) stream << ", \"flops\": " << flops*n_call;
+    stream << ", \"children\": [";
+    for (int i=0; i<children.size(); ++i) {
+      stream << (i==0 ? "\n" : ",\n");
+      children[i].to_json(stream, indent+2);
+    }
+    if (!children.empty()) stream << "\n" << pad;
+    stream << "]}";
+  }
+
+  ProfileEvents::ProfileEvents(size_t max_size) : max_size(max_size), head(0), n_dropped(0) {
+  }
+
+  void ProfileEvents::push(const ProfileEvent& e) {
+    if (ev.size()<max_size) {
+      ev.push_back(e);
+    } else if (max_size>0) {
+      ev[head] = e;
+      head = (head+1) % max_size;
+      n_dropped++;
+    } else {
+      n_dropped++;
+    }
+  }
+
+  void ProfileEvents::append(const ProfileEvents& other) {
+    n_dropped += other.n_dropped;
+    for (auto&& e : other.get()) push(e);
+  }
+
+  std::vector<ProfileEvent> ProfileEvents::get() const {
+    std::vector<ProfileEvent> ret(ev.begin()+head, ev.end());
+    ret.insert(ret.end(), ev.begin(), ev.begin()+head);
+    return ret;
+  }
+
+  void ProfileEvents::clear() {
+    ev.clear();
+    head = 0;
+    n_dropped = 0;
+  }
+
+  void profile_trace(std::ostream& stream, const std::vector<ProfileEvent>& ev) {
+    std::streamsize prec = stream.precision();
+    stream << "{\"traceEvents\": [";
+    for (int i=0; i<ev.size(); ++i) {
+      stream << (i==0 ? "\n" : ",\n") << "  {\"name\": " << json_string(ev[i].name) << ", "
+             << "\"ph\": \"X\", "
+             << "\"ts\": " << std::fixed << std::setprecision(3) << ev[i].ts << ", "
+             << "\"dur\": " << ev[i].dur << ", \"pid\": 0, \"tid\": " << ev[i].tid << "}";
+    }
+    stream.unsetf(std::ios_base::floatfield);
+    stream.precision(prec);
+    stream << "\n]}\n";
+  }
+
+  double profile_clock() {
+    static const steady_clock::time_point t0 = steady_clock::now();
+    return duration<double, std::micro>(steady_clock::now() - t0).count();
+  }
+
 } // namespace casadi
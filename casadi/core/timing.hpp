@@ -30,6 +30,9 @@
 
 #include <ctime>
 #include <chrono>
+#include <vector>
+#include <string>
+#include <iostream>
 
 namespace casadi {
   /// \cond INTERNAL
@@ -80,6 +83,90 @@ namespace casadi {
       /// Accumulated proc time [s] since last reset
       double t_proc;
   };
+
+  /** \brief Profiling data for a function, including the functions it calls
+
+      Calls are merged by function name, giving a call tree with
+      accumulated statistics.
+  */
+  struct CASADI_EXPORT ProfileNode {
+    /// Constructor
+    ProfileNode(const std::string& name="", const std::string& type="");
+
+    /// Function name and class
+    std::string name, type;
+
+    /// Accumulated number of calls, wall time [s] and proc time [s]
+    int n_call;
+    double t_wall, t_proc;
+
+    /// Work memory needed for one call [bytes]
+    size_t w_bytes;
+
+    /// Estimated number of floating point operations per call, -1 if unknown
+    double flops;
+
+    /// Functions called
+    std::vector<ProfileNode> children;
+
+    /// Get a child, created if needed
+    ProfileNode& child(const std::string& name, const std::string& type);
+
+    /// Add the statistics of another tree for the same function
+    void merge(const ProfileNode& other);
+
+    /// Convert to a Dict, children indexed by name
+    Dict to_dict() const;
+
+    /// Print in JSON format
+    void to_json(std::ostream& stream, int indent=0) const;
+  };
+
+  /// A completed call, for tracing
+  struct CASADI_EXPORT ProfileEvent {
+    std::string name;
+    /// Start time and duration [us]
+    double ts, dur;
+    /// Thread
+    int tid;
+  };
+
+  /** \brief Completed calls, for tracing
+
+      At most max_size events are kept. When full, the oldest event is overwritten.
+  */
+  struct CASADI_EXPORT ProfileEvents {
+    /// Constructor
+    explicit ProfileEvents(size_t max_size=0);
+
+    /// Maximum number of events kept
+    size_t max_size;
+
+    /// Events, ring buffer with the oldest event at position head if full
+    std::vector<ProfileEvent> ev;
+    size_t head;
+
+    /// Number of events dropped since the last clear
+    size_t n_dropped;
+
+    /// Add an event
+    void push(const ProfileEvent& e);
+
+    /// Add the events of another buffer
+    void append(const ProfileEvents& other);
+
+    /// Get the events, oldest first
+    std::vector<ProfileEvent> get() const;
+
+    /// Remove all events
+    void clear();
+  };
+
+  /// Print events in Chrome trace event format
+  CASADI_EXPORT void profile_trace(std::ostream& stream, const std::vector<ProfileEvent>& ev);
+
+  /// Microseconds since the first call
+  CASADI_EXPORT double profile_clock();
 /// \endcond
 } // namespace casadi
 
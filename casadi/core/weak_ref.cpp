@@ -24,11 +24,19 @@
 
 
 #include "weak_ref.hpp"
+#ifdef WITH_THREADSAFE_SYMBOLICS
+#include <mutex>
+#endif // WITH_THREADSAFE_SYMBOLICS
 
 using namespace std;
 
 namespace casadi {
 
+#ifdef WITH_THREADSAFE_SYMBOLICS
+  /// Synchronizes the recovery of owning references with the deletion of the objects
+  static mutex weak_ref_mtx;
+#endif // WITH_THREADSAFE_SYMBOLICS
+
   WeakRef::WeakRef(int dummy) {
     casadi_assert(dummy==0);
   }
@@ -39,9 +47,24 @@ namespace casadi {
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    if (is_null()) return ret;
+    lock_guard<mutex> lock(weak_ref_mtx);
+    SharedObjectNode* raw = (*this)->raw_;
+    if (raw==0) return ret;
+    // The object may be in the process of being deleted, only count up if still referenced
+    unsigned int c = raw->count;
+    while (c!=0) {
+      if (raw->count.compare_exchange_weak(c, c+1)) {
+        ret.assignNodeNoCount(raw);
+        break;
+      }
+    }
+#else // WITH_THREADSAFE_SYMBOLICS
     if (alive()) {
       ret.assignNode((*this)->raw_);
     }
+#endif // WITH_THREADSAFE_SYMBOLICS
     return ret;
   }
 
@@ -62,6 +85,9 @@ namespace casadi {
   }
 
   void WeakRef::kill() {
+#ifdef WITH_THREADSAFE_SYMBOLICS
+    lock_guard<mutex> lock(weak_ref_mtx);
+#endif // WITH_THREADSAFE_SYMBOLICS
     (*this)->raw_ = 0;
   }
 
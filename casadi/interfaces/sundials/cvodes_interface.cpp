@@ -124,6 +124,12 @@ namespace casadi {
     }
   }
 
+  void CvodesInterface::free_memory(void *mem) const {
+    auto m = static_cast<CvodesMemory*>(mem);
+    free_linsol(m);
+    delete m;
+  }
+
   void CvodesInterface::init_memory(void* mem) const {
     SundialsInterface::init_memory(mem);
     auto m = to_mem(mem);
@@ -505,7 +511,7 @@ namespace casadi {
       casadi_copy(v, s.nx_, m->v1);
 
       // Solve for undifferentiated right-hand-side, save to output
-      s.linsolF_.solve(m->v1, 1);
+      s.linsolF_.solve(m->v1, 1, false, m->mem_linsolF);
       v = NV_DATA_S(z); // possibly different from r
       casadi_copy(m->v1, s.nx1_, v);
 
@@ -527,7 +533,7 @@ namespace casadi {
         }
 
         // Solve for sensitivity right-hand-sides
-        s.linsolF_.solve(m->v1 + s.nx1_, s.ns_);
+        s.linsolF_.solve(m->v1 + s.nx1_, s.ns_, false, m->mem_linsolF);
 
         // Save to output, reordered
         casadi_copy(m->v1 + s.nx1_, s.nx_-s.nx1_, v+s.nx1_);
@@ -552,7 +558,7 @@ namespace casadi {
       casadi_copy(v, s.nrx_, m->v1);
 
       // Solve for undifferentiated right-hand-side, save to output
-      s.linsolB_.solve(m->v1, 1);
+      s.linsolB_.solve(m->v1, 1, false, m->mem_linsolB);
       v = NV_DATA_S(zvecB); // possibly different from rvecB
       casadi_copy(m->v1, s.nrx1_, v);
 
@@ -576,7 +582,7 @@ namespace casadi {
         }
 
         // Solve for sensitivity right-hand-sides
-        s.linsolB_.solve(m->v1 + s.nx1_, s.ns_);
+        s.linsolB_.solve(m->v1 + s.nx1_, s.ns_, false, m->mem_linsolB);
 
         // Save to output, reordered
         casadi_copy(m->v1 + s.nx1_, s.nx_-s.nx1_, v+s.nx1_);
@@ -606,7 +612,7 @@ namespace casadi {
       s.calc_function(m, "jacF");
 
       // Prepare the solution of the linear system (e.g. factorize)
-      s.linsolF_.factorize(m->jac);
+      s.linsolF_.factorize(m->jac, m->mem_linsolF);
 
       return 0;
     } catch(exception& e) {
@@ -635,7 +641,7 @@ namespace casadi {
       s.calc_function(m, "jacB");
 
       // Prepare the solution of the linear system (e.g. factorize)
-      s.linsolB_.factorize(m->jacB);
+      s.linsolB_.factorize(m->jacB, m->mem_linsolB);
 
       return 0;
     } catch(exception& e) {
@@ -115,7 +115,7 @@ namespace casadi {
     virtual void* alloc_memory() const { return new CvodesMemory(*this);}
 
     /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<CvodesMemory*>(mem);}
+    virtual void free_memory(void *mem) const;
 
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
@@ -252,6 +252,12 @@ namespace casadi {
     }
   }
 
+  void IdasInterface::free_memory(void *mem) const {
+    auto m = static_cast<IdasMemory*>(mem);
+    free_linsol(m);
+    delete m;
+  }
+
   void IdasInterface::init_memory(void* mem) const {
     SundialsInterface::init_memory(mem);
     auto m = to_mem(mem);
@@ -645,7 +651,7 @@ namespace casadi {
       }
 
       // Solve for undifferentiated right-hand-side, save to output
-      s.linsolF_.solve(m->v1, 1);
+      s.linsolF_.solve(m->v1, 1, false, m->mem_linsolF);
       vx = NV_DATA_S(zvec); // possibly different from rvec
       vz = vx + s.nx_;
       casadi_copy(m->v1, s.nx1_, vx);
@@ -679,7 +685,7 @@ namespace casadi {
         }
 
         // Solve for sensitivity right-hand-sides
-        s.linsolF_.solve(m->v1 + s.nx1_ + s.nz1_, s.ns_);
+        s.linsolF_.solve(m->v1 + s.nx1_ + s.nz1_, s.ns_, false, m->mem_linsolF);
 
         // Save to output, reordered
         v_it = m->v1 + s.nx1_ + s.nz1_;
@@ -718,7 +724,7 @@ namespace casadi {
       }
 
       // Solve for undifferentiated right-hand-side, save to output
-      s.linsolB_.solve(m->v1, 1);
+      s.linsolB_.solve(m->v1, 1, false, m->mem_linsolB);
       vx = NV_DATA_S(zvecB); // possibly different from rvecB
       vz = vx + s.nrx_;
       casadi_copy(m->v1, s.nrx1_, vx);
@@ -757,7 +763,7 @@ namespace casadi {
         }
 
         // Solve for sensitivity right-hand-sides
-        s.linsolB_.solve(m->v1 + s.nrx1_ + s.nrz1_, s.ns_);
+        s.linsolB_.solve(m->v1 + s.nrx1_ + s.nrz1_, s.ns_, false, m->mem_linsolB);
 
         // Save to output, reordered
         v_it = m->v1 + s.nrx1_ + s.nrz1_;
@@ -791,7 +797,7 @@ namespace casadi {
       s.calc_function(m, "jacF");
 
       // Factorize the linear system
-      s.linsolF_.factorize(m->jac);
+      s.linsolF_.factorize(m->jac, m->mem_linsolF);
 
       return 0;
     } catch(exception& e) {
@@ -819,7 +825,7 @@ namespace casadi {
       s.calc_function(m, "jacB");
 
       // Factorize the linear system
-      s.linsolB_.factorize(m->jacB);
+      s.linsolB_.factorize(m->jacB, m->mem_linsolB);
 
       return 0;
     } catch(exception& e) {
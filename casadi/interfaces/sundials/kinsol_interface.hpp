@@ -155,9 +155,6 @@ namespace casadi {
     /** \brief Create memory block */
     virtual void* alloc_memory() const { return new KinsolMemory(*this);}
 
-    /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<KinsolMemory*>(mem);}
-
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
 
@@ -221,13 +221,20 @@ namespace casadi {
     m->rxz = N_VNew_Serial(nrx_+nrz_);
     m->rq = N_VNew_Serial(nrq_);
 
-    // Reset linear solvers
-    linsolF_.reset(get_function("jacF").sparsity_out(0));
+    // Reset linear solvers, one memory object per integrator memory
+    m->mem_linsolF = linsolF_.checkout();
+    linsolF_.reset(get_function("jacF").sparsity_out(0), m->mem_linsolF);
     if (nrx_>0) {
-      linsolB_.reset(get_function("jacB").sparsity_out(0));
+      m->mem_linsolB = linsolB_.checkout();
+      linsolB_.reset(get_function("jacB").sparsity_out(0), m->mem_linsolB);
     }
   }
 
+  void SundialsInterface::free_linsol(SundialsMemory* m) const {
+    linsolF_.release(m->mem_linsolF);
+    if (nrx_>0) linsolB_.release(m->mem_linsolB);
+  }
+
   void SundialsInterface::reset(IntegratorMemory* mem, double t, const double* x,
                                 const double* z, const double* p) const {
     auto m = static_cast<SundialsMemory*>(mem);
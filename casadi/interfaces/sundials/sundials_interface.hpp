@@ -74,6 +74,9 @@ namespace casadi {
     /// number of checkpoints stored so far
     int ncheck;
 
+    // Linear solver memory objects
+    int mem_linsolF, mem_linsolB;
+
     /// Constructor
     SundialsMemory();
 
@@ -101,6 +104,9 @@ namespace casadi {
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
 
+    /** \brief Release the linear solver memory objects of a memory block */
+    void free_linsol(SundialsMemory* m) const;
+
     // Get system Jacobian
     virtual Function getJ(bool backward) const = 0;
 
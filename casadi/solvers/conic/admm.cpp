@@ -0,0 +1,562 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "admm.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_ADMM_EXPORT
+  casadi_register_conic_admm(Conic::Plugin* plugin) {
+    plugin->creator = Admm::creator;
+    plugin->name = "admm";
+    plugin->doc = Admm::meta_doc.c_str();
+    plugin->version = 31;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_ADMM_EXPORT casadi_load_conic_admm() {
+    Conic::registerPlugin(casadi_register_conic_admm);
+  }
+
+  // Penalty parameter for equality constraints, relative to rho
+  static const double ADMM_RHO_EQ = 1e3;
+
+  Admm::Admm(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Admm::~Admm() {
+    clear_memory();
+  }
+
+  Options Admm::options_
+  = {{&Conic::options_},
+     {{"linear_solver",
+       {OT_STRING,
+        "Linear solver for the KKT system [ldl]"}},
+      {"linear_solver_options",
+       {OT_DICT,
+        "Options to be passed to the linear solver"}},
+      {"rho",
+       {OT_DOUBLE,
+        "Initial penalty parameter [0.1]"}},
+      {"rho_min",
+       {OT_DOUBLE,
+        "Smallest penalty parameter, also used for constraints without bounds [1e-6]"}},
+      {"rho_max",
+       {OT_DOUBLE,
+        "Largest penalty parameter [1e6]"}},
+      {"rho_interval",
+       {OT_INT,
+        "Number of iterations between updates of rho, 0 for a constant rho [25]"}},
+      {"sigma",
+       {OT_DOUBLE,
+        "Regularization of the primal variables [1e-6]"}},
+      {"alpha",
+       {OT_DOUBLE,
+        "Relaxation parameter, in (0, 2) [1.6]"}},
+      {"eps_abs",
+       {OT_DOUBLE,
+        "Absolute tolerance on the primal and dual residuals [1e-6]"}},
+      {"eps_rel",
+       {OT_DOUBLE,
+        "Relative tolerance on the primal and dual residuals [1e-6]"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations, reaching it is an error [4000]"}},
+      {"warm_start",
+       {OT_BOOL,
+        "Start from the solution of the previous call with the same memory block [true]"}}
+     }
+  };
+
+  void Admm::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    string linear_solver = "ldl";
+    Dict linear_solver_options;
+    rho0_ = 0.1;
+    rho_min_ = 1e-6;
+    rho_max_ = 1e6;
+    rho_interval_ = 25;
+    sigma_ = 1e-6;
+    alpha_ = 1.6;
+    eps_abs_ = 1e-6;
+    eps_rel_ = 1e-6;
+    max_iter_ = 4000;
+    warm_start_ = true;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="linear_solver") {
+        linear_solver = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options = op.second;
+      } else if (op.first=="rho") {
+        rho0_ = op.second;
+      } else if (op.first=="rho_min") {
+        rho_min_ = op.second;
+      } else if (op.first=="rho_max") {
+        rho_max_ = op.second;
+      } else if (op.first=="rho_interval") {
+        rho_interval_ = op.second;
+      } else if (op.first=="sigma") {
+        sigma_ = op.second;
+      } else if (op.first=="alpha") {
+        alpha_ = op.second;
+      } else if (op.first=="eps_abs") {
+        eps_abs_ = op.second;
+      } else if (op.first=="eps_rel") {
+        eps_rel_ = op.second;
+      } else if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
+      }
+    }
+    casadi_assert_message(alpha_>0 && alpha_<2, "Admm: 'alpha' must be in (0, 2)");
+    casadi_assert_message(rho_min_>0 && rho_min_<=rho0_ && rho0_<=rho_max_,
+                          "Admm: Need 0 < rho_min <= rho <= rho_max");
+
+    // Sparsity pattern of the reduced KKT system
+    int n = nx_ + na_;
+    kkt_ = Sparsity::blockcat({{H_.unite(Sparsity::diag(nx_)), A_.T()},
+                               {A_, Sparsity::diag(na_)}});
+
+    // Map the nonzeros of H, A, A' and the diagonal into the KKT matrix
+    vector<int> r, c;
+    H_.get_triplet(r, c);
+    kkt_h_.resize(r.size());
+    for (int k=0; k<r.size(); ++k) kkt_h_[k] = kkt_.get_nz(r[k], c[k]);
+    A_.get_triplet(r, c);
+    kkt_a_.resize(r.size());
+    kkt_at_.resize(r.size());
+    for (int k=0; k<r.size(); ++k) {
+      kkt_a_[k] = kkt_.get_nz(nx_+r[k], c[k]);
+      kkt_at_[k] = kkt_.get_nz(c[k], nx_+r[k]);
+    }
+    kkt_diag_.resize(n);
+    for (int i=0; i<n; ++i) kkt_diag_[i] = kkt_.get_nz(i, i);
+
+    // Create the linear solver
+    linsol_ = Linsol("linsol", linear_solver, linear_solver_options);
+
+    // Allocate work vectors
+    alloc_w(H_.nnz() + nx_ + A_.nnz(), true); // h, g, a
+    alloc_w(3*n, true); // lb, ub, rho_vec
+    alloc_w(nx_ + 4*n, true); // x, z, y, d, t
+    alloc_w(kkt_.nnz(), true); // kkt
+  }
+
+  void Admm::init_memory(void* mem) const {
+    auto m = static_cast<AdmmMemory*>(mem);
+
+    // The symbolic factorization is reused for all calls with this memory block
+    m->mem_linsol = linsol_.checkout();
+    linsol_.reset(kkt_, m->mem_linsol);
+    m->has_sol = false;
+    m->rho = rho0_;
+    m->iter = m->n_factor = 0;
+    m->return_status = 0;
+  }
+
+  void Admm::free_memory(void *mem) const {
+    auto m = static_cast<AdmmMemory*>(mem);
+    linsol_.release(m->mem_linsol);
+    delete m;
+  }
+
+  Dict Admm::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<AdmmMemory*>(mem);
+    stats["iter_count"] = m->iter;
+    stats["n_factor"] = m->n_factor;
+    stats["rho"] = m->rho;
+    if (m->return_status) stats["return_status"] = string(m->return_status);
+    stats["success"] = m->return_status!=0 && string(m->return_status)=="success";
+    return stats;
+  }
+
+  void Admm::set_rho(double rho, const double* lb, const double* ub, double* rho_vec) const {
+    for (int i=0; i<nx_+na_; ++i) {
+      if (lb[i]==ub[i]) {
+        rho_vec[i] = ADMM_RHO_EQ*rho;
+      } else if (lb[i]==-inf && ub[i]==inf) {
+        rho_vec[i] = rho_min_;
+      } else {
+        rho_vec[i] = rho;
+      }
+    }
+  }
+
+  void Admm::
+  eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
+    auto m = static_cast<AdmmMemory*>(mem);
+
+    if (inputs_check_) {
+      checkInputs(arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
+    }
+
+    // Variables are x and z = C*x with C = [I; A], multipliers y for z
+    int n = nx_ + na_;
+
+    // Problem data, missing entries are zero
+    double *h = w; w += H_.nnz();
+    double *g = w; w += nx_;
+    double *a = w; w += A_.nnz();
+    casadi_copy(arg[CONIC_H], H_.nnz(), h);
+    casadi_copy(arg[CONIC_G], nx_, g);
+    casadi_copy(arg[CONIC_A], A_.nnz(), a);
+
+    // Bounds on z
+    double *lb = w; w += n;
+    double *ub = w; w += n;
+    casadi_copy(arg[CONIC_LBX], nx_, lb);
+    casadi_copy(arg[CONIC_LBA], na_, lb+nx_);
+    casadi_copy(arg[CONIC_UBX], nx_, ub);
+    casadi_copy(arg[CONIC_UBA], na_, ub+nx_);
+    if (!arg[CONIC_LBX]) casadi_fill(lb, nx_, -inf);
+    if (!arg[CONIC_LBA]) casadi_fill(lb+nx_, na_, -inf);
+    if (!arg[CONIC_UBX]) casadi_fill(ub, nx_, inf);
+    if (!arg[CONIC_UBA]) casadi_fill(ub+nx_, na_, inf);
+
+    // Work vectors
+    double *rho_vec = w; w += n;
+    double *x = w; w += nx_;
+    double *z = w; w += n;
+    double *y = w; w += n;
+    double *d = w; w += n;
+    double *t = w; w += n;
+    double *kkt = w; w += kkt_.nnz();
+
+    // Initial guess
+    if (warm_start_ && m->has_sol) {
+      casadi_copy(get_ptr(m->x), nx_, x);
+      casadi_copy(get_ptr(m->z), n, z);
+      casadi_copy(get_ptr(m->y), n, y);
+    } else {
+      casadi_copy(arg[CONIC_X0], nx_, x);
+      casadi_copy(x, nx_, z);
+      casadi_fill(z+nx_, na_, 0.);
+      casadi_mv(a, A_, x, z+nx_, false);
+      for (int i=0; i<n; ++i) z[i] = min(max(z[i], lb[i]), ub[i]);
+      casadi_copy(arg[CONIC_LAM_X0], nx_, y);
+      casadi_copy(arg[CONIC_LAM_A0], na_, y+nx_);
+      m->rho = rho0_;
+    }
+    set_rho(m->rho, lb, ub, rho_vec);
+
+    // Only refactorize if rho or the problem matrices changed since the last factorization
+    bool refactor = m->rho_vec.empty()
+      || !equal(rho_vec, rho_vec+n, m->rho_vec.begin())
+      || !equal(h, h+H_.nnz(), m->h.begin())
+      || !equal(a, a+A_.nnz(), m->a.begin());
+    m->n_factor = 0;
+
+    // ADMM iterations
+    double norm_g = casadi_norm_inf(nx_, g);
+    m->return_status = 0;
+    for (m->iter=1; ; ++m->iter) {
+      if (refactor) {
+        // Assemble the KKT matrix
+        casadi_fill(kkt, kkt_.nnz(), 0.);
+        for (int k=0; k<H_.nnz(); ++k) kkt[kkt_h_[k]] += h[k];
+        for (int k=0; k<A_.nnz(); ++k) kkt[kkt_a_[k]] = kkt[kkt_at_[k]] = a[k];
+        for (int i=0; i<nx_; ++i) kkt[kkt_diag_[i]] += sigma_ + rho_vec[i];
+        for (int i=nx_; i<n; ++i) kkt[kkt_diag_[i]] = -1/rho_vec[i];
+
+        // Numeric factorization, the symbolic factorization is reused
+        linsol_.factorize(kkt, m->mem_linsol);
+        m->h.assign(h, h+H_.nnz());
+        m->a.assign(a, a+A_.nnz());
+        m->rho_vec.assign(rho_vec, rho_vec+n);
+        m->n_factor++;
+        refactor = false;
+      }
+
+      // Solve the KKT system for x~ and the multipliers nu of A*x~ = z~
+      for (int i=0; i<nx_; ++i) d[i] = sigma_*x[i] - g[i] + rho_vec[i]*z[i] - y[i];
+      for (int i=nx_; i<n; ++i) d[i] = z[i] - y[i]/rho_vec[i];
+      linsol_.solve(d, 1, false, m->mem_linsol);
+      for (int i=nx_; i<n; ++i) d[i] = z[i] + (d[i]-y[i])/rho_vec[i];
+
+      // Relaxed update of x, projection of z and dual update
+      for (int i=0; i<nx_; ++i) x[i] = alpha_*d[i] + (1-alpha_)*x[i];
+      for (int i=0; i<n; ++i) {
+        double zr = alpha_*d[i] + (1-alpha_)*z[i];
+        double zn = min(max(zr + y[i]/rho_vec[i], lb[i]), ub[i]);
+        y[i] += rho_vec[i]*(zr - zn);
+        z[i] = zn;
+      }
+
+      // Primal residual, C*x - z
+      casadi_copy(x, nx_, t);
+      casadi_fill(t+nx_, na_, 0.);
+      casadi_mv(a, A_, x, t+nx_, false);
+      double norm_cx = casadi_norm_inf(n, t), norm_z = casadi_norm_inf(n, z);
+      casadi_axpy(n, -1., z, t);
+      double r_p = casadi_norm_inf(n, t);
+
+      // Dual residual, H*x + g + C'*y
+      casadi_copy(y, nx_, t);
+      casadi_mv(a, A_, y+nx_, t, true);
+      double norm_cty = casadi_norm_inf(nx_, t);
+      casadi_fill(d, nx_, 0.);
+      casadi_mv(h, H_, x, d, false);
+      double norm_hx = casadi_norm_inf(nx_, d);
+      casadi_axpy(nx_, 1., g, d);
+      casadi_axpy(nx_, 1., t, d);
+      double r_d = casadi_norm_inf(nx_, d);
+
+      // Check convergence
+      double scale_p = max(norm_cx, norm_z), scale_d = max(max(norm_hx, norm_cty), norm_g);
+      if (r_p <= eps_abs_ + eps_rel_*scale_p && r_d <= eps_abs_ + eps_rel_*scale_d) {
+        m->return_status = "success";
+        break;
+      }
+      if (m->iter>=max_iter_) {
+        m->return_status = "Maximum number of iterations reached";
+        casadi_error("Admm failed: " + string(m->return_status));
+      }
+
+      // Balance the primal and dual residuals by updating rho
+      if (rho_interval_>0 && m->iter % rho_interval_ == 0) {
+        double rho = m->rho*sqrt((r_p/max(scale_p, 1e-10))/(r_d/max(scale_d, 1e-10)+1e-10));
+        rho = min(max(rho, rho_min_), rho_max_);
+        if (rho>5*m->rho || rho<0.2*m->rho) {
+          m->rho = rho;
+          set_rho(rho, lb, ub, rho_vec);
+          refactor = true;
+        }
+      }
+    }
+
+    // Store the solution for warm starting the next call
+    m->x.assign(x, x+nx_);
+    m->z.assign(z, z+n);
+    m->y.assign(y, y+n);
+    m->has_sol = true;
+
+    // Get the solution
+    casadi_copy(x, nx_, res[CONIC_X]);
+    casadi_copy(y, nx_, res[CONIC_LAM_X]);
+    casadi_copy(y+nx_, na_, res[CONIC_LAM_A]);
+    if (res[CONIC_COST]) {
+      *res[CONIC_COST] = 0.5*casadi_bilin(h, H_, x, x) + casadi_dot(nx_, g, x);
+    }
+  }
+
+  void Admm::generateBody(CodeGenerator& g) const {
+    // The generated code factorizes kkt_(perm, perm) with the built-in sparse LDL'
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    g.addAuxiliary(CodeGenerator::AUX_FILL);
+    g.addAuxiliary(CodeGenerator::AUX_AXPY);
+    g.addAuxiliary(CodeGenerator::AUX_NORM_INF);
+    g.addAuxiliary(CodeGenerator::AUX_MV);
+    g.addAuxiliary(CodeGenerator::AUX_BILIN);
+    g.addAuxiliary(CodeGenerator::AUX_DOT);
+    g.addAuxiliary(CodeGenerator::AUX_LDL);
+    int n = nx_ + na_;
+
+    // Fill-reducing ordering and symbolic factorization, not needed for evaluation
+    vector<int> perm;
+    Sparsity kktp_lt = kkt_.ldl(perm);
+    vector<int> iperm(n);
+    for (int k=0; k<n; ++k) iperm[perm[k]] = k;
+    vector<int> r, c;
+    kkt_.get_triplet(r, c);
+    for (int k=0; k<r.size(); ++k) {
+      r[k] = iperm[r[k]];
+      c[k] = iperm[c[k]];
+    }
+    Sparsity kktp = Sparsity::triplet(n, n, r, c);
+
+    // Locations of the nonzeros of H, A, A' and the diagonal in kktp
+    H_.get_triplet(r, c);
+    vector<int> kktp_h(r.size());
+    for (int k=0; k<r.size(); ++k) kktp_h[k] = kktp.get_nz(iperm[r[k]], iperm[c[k]]);
+    A_.get_triplet(r, c);
+    vector<int> kktp_a(r.size()), kktp_at(r.size());
+    for (int k=0; k<r.size(); ++k) {
+      kktp_a[k] = kktp.get_nz(iperm[nx_+r[k]], iperm[c[k]]);
+      kktp_at[k] = kktp.get_nz(iperm[c[k]], iperm[nx_+r[k]]);
+    }
+    vector<int> kktp_diag(n);
+    for (int i=0; i<n; ++i) kktp_diag[i] = kktp.get_nz(iperm[i], iperm[i]);
+
+    string sp_h = g.sparsity(H_), sp_a = g.sparsity(A_);
+    string sp_kkt = g.sparsity(kktp), sp_lt = g.sparsity(kktp_lt);
+    string perm_s = "s" + to_string(g.getConstant(perm, true));
+    string kh = "s" + to_string(g.getConstant(kktp_h, true));
+    string ka = "s" + to_string(g.getConstant(kktp_a, true));
+    string kat = "s" + to_string(g.getConstant(kktp_at, true));
+    string kd = "s" + to_string(g.getConstant(kktp_diag, true));
+
+    // The factorization is stored in static work vectors, the rest of the work vector
+    // has the same layout as in eval
+    string dp = g.static_work(n), lt = g.static_work(kktp_lt.nnz());
+    string dd = g.static_work(n), wl = g.static_work(n);
+    g.body << "  int i, k, iter, refactor;" << endl
+           << "  real_t zr, zn, r_p, r_d, scale_p, scale_d, norm_g, rho, rho_new;" << endl
+           << "  real_t *hv=w, *gv=hv+" << H_.nnz() << ", *av=gv+" << nx_ << ";" << endl
+           << "  real_t *lb=av+" << A_.nnz() << ", *ub=lb+" << n << ", *rv=ub+" << n << ";" << endl
+           << "  real_t *x=rv+" << n << ", *z=x+" << nx_ << ", *y=z+" << n
+           << ", *d=y+" << n << ", *t=d+" << n << ";" << endl
+           << "  real_t *kkt=t+" << n << ";" << endl;
+
+    // Problem data
+    g.body << "  copy(arg[" << CONIC_H << "], " << H_.nnz() << ", hv);" << endl
+           << "  copy(arg[" << CONIC_G << "], " << nx_ << ", gv);" << endl
+           << "  copy(arg[" << CONIC_A << "], " << A_.nnz() << ", av);" << endl;
+
+    // Bounds on z
+    const int bnd[4][3] = {{CONIC_LBX, 0, nx_}, {CONIC_LBA, nx_, na_},
+                           {CONIC_UBX, 0, nx_}, {CONIC_UBA, nx_, na_}};
+    for (int k=0; k<4; ++k) {
+      string v = k<2 ? "lb" : "ub";
+      g.body << "  if (arg[" << bnd[k][0] << "]) {" << endl
+             << "    copy(arg[" << bnd[k][0] << "], " << bnd[k][2] << ", "
+             << v << "+" << bnd[k][1] << ");" << endl
+             << "  } else {" << endl
+             << "    fill(" << v << "+" << bnd[k][1] << ", " << bnd[k][2] << ", "
+             << (k<2 ? "-" : "") << "INFINITY);" << endl
+             << "  }" << endl;
+    }
+
+    // Cold start from x0 and the multiplier guesses
+    g.body << "  copy(arg[" << CONIC_X0 << "], " << nx_ << ", x);" << endl
+           << "  copy(x, " << nx_ << ", z);" << endl
+           << "  fill(z+" << nx_ << ", " << na_ << ", 0.);" << endl
+           << "  mv(av, " << sp_a << ", x, z+" << nx_ << ", 0);" << endl
+           << "  for (i=0; i<" << n << "; ++i) z[i] = fmin(fmax(z[i], lb[i]), ub[i]);" << endl
+           << "  copy(arg[" << CONIC_LAM_X0 << "], " << nx_ << ", y);" << endl
+           << "  copy(arg[" << CONIC_LAM_A0 << "], " << na_ << ", y+" << nx_ << ");" << endl
+           << "  rho = " << CodeGenerator::constant(rho0_) << ";" << endl
+           << "  norm_g = norm_inf(" << nx_ << ", gv);" << endl
+           << "  refactor = 1;" << endl;
+
+    // ADMM iterations
+    g.body << "  for (iter=1; ; ++iter) {" << endl
+           << "    if (refactor) {" << endl
+           << "      for (i=0; i<" << n << "; ++i) {" << endl
+           << "        if (lb[i]==ub[i]) {" << endl
+           << "          rv[i] = " << CodeGenerator::constant(ADMM_RHO_EQ) << "*rho;" << endl
+           << "        } else if (lb[i]==-INFINITY && ub[i]==INFINITY) {" << endl
+           << "          rv[i] = " << CodeGenerator::constant(rho_min_) << ";" << endl
+           << "        } else {" << endl
+           << "          rv[i] = rho;" << endl
+           << "        }" << endl
+           << "      }" << endl
+           << "      fill(kkt, " << kktp.nnz() << ", 0.);" << endl
+           << "      for (k=0; k<" << H_.nnz() << "; ++k) kkt[" << kh << "[k]] += hv[k];" << endl
+           << "      for (k=0; k<" << A_.nnz() << "; ++k) {" << endl
+           << "        kkt[" << ka << "[k]] = av[k];" << endl
+           << "        kkt[" << kat << "[k]] = av[k];" << endl
+           << "      }" << endl
+           << "      for (i=0; i<" << nx_ << "; ++i) kkt[" << kd << "[i]] += "
+           << CodeGenerator::constant(sigma_) << " + rv[i];" << endl
+           << "      for (i=" << nx_ << "; i<" << n << "; ++i) kkt[" << kd << "[i]] = -1/rv[i];"
+           << endl
+           << "      ldl(" << sp_kkt << ", kkt, " << sp_lt << ", " << lt << ", " << dd << ", "
+           << wl << ");" << endl
+           << "      refactor = 0;" << endl
+           << "    }" << endl;
+
+    // Solve the KKT system
+    g.body << "    for (i=0; i<" << nx_ << "; ++i) d[i] = " << CodeGenerator::constant(sigma_)
+           << "*x[i] - gv[i] + rv[i]*z[i] - y[i];" << endl
+           << "    for (i=" << nx_ << "; i<" << n << "; ++i) d[i] = z[i] - y[i]/rv[i];" << endl
+           << "    for (i=0; i<" << n << "; ++i) " << dp << "[i] = d[" << perm_s << "[i]];" << endl
+           << "    ldl_solve(" << dp << ", 1, " << sp_lt << ", " << lt << ", " << dd << ");" << endl
+           << "    for (i=0; i<" << n << "; ++i) d[" << perm_s << "[i]] = " << dp << "[i];" << endl
+           << "    for (i=" << nx_ << "; i<" << n << "; ++i) d[i] = z[i] + (d[i]-y[i])/rv[i];"
+           << endl;
+
+    // Relaxed update of x, projection of z and dual update
+    string alpha = CodeGenerator::constant(alpha_);
+    string alpha1 = CodeGenerator::constant(1-alpha_);
+    g.body << "    for (i=0; i<" << nx_ << "; ++i) x[i] = " << alpha << "*d[i] + "
+           << alpha1 << "*x[i];" << endl
+           << "    for (i=0; i<" << n << "; ++i) {" << endl
+           << "      zr = " << alpha << "*d[i] + " << alpha1 << "*z[i];" << endl
+           << "      zn = fmin(fmax(zr + y[i]/rv[i], lb[i]), ub[i]);" << endl
+           << "      y[i] += rv[i]*(zr - zn);" << endl
+           << "      z[i] = zn;" << endl
+           << "    }" << endl;
+
+    // Residuals
+    g.body << "    copy(x, " << nx_ << ", t);" << endl
+           << "    fill(t+" << nx_ << ", " << na_ << ", 0.);" << endl
+           << "    mv(av, " << sp_a << ", x, t+" << nx_ << ", 0);" << endl
+           << "    scale_p = fmax(norm_inf(" << n << ", t), norm_inf(" << n << ", z));" << endl
+           << "    axpy(" << n << ", -1., z, t);" << endl
+           << "    r_p = norm_inf(" << n << ", t);" << endl
+           << "    copy(y, " << nx_ << ", t);" << endl
+           << "    mv(av, " << sp_a << ", y+" << nx_ << ", t, 1);" << endl
+           << "    fill(d, " << nx_ << ", 0.);" << endl
+           << "    mv(hv, " << sp_h << ", x, d, 0);" << endl
+           << "    scale_d = fmax(fmax(norm_inf(" << nx_ << ", d), norm_inf(" << nx_
+           << ", t)), norm_g);" << endl
+           << "    axpy(" << nx_ << ", 1., gv, d);" << endl
+           << "    axpy(" << nx_ << ", 1., t, d);" << endl
+           << "    r_d = norm_inf(" << nx_ << ", d);" << endl;
+
+    // Termination
+    string eps_abs = CodeGenerator::constant(eps_abs_);
+    string eps_rel = CodeGenerator::constant(eps_rel_);
+    g.body << "    if (r_p <= " << eps_abs << " + " << eps_rel << "*scale_p && r_d <= "
+           << eps_abs << " + " << eps_rel << "*scale_d) break;" << endl
+           << "    if (iter>=" << max_iter_ << ") return 1;" << endl;
+
+    // Update rho
+    if (rho_interval_>0) {
+      g.body << "    if (iter % " << rho_interval_ << " == 0) {" << endl
+             << "      rho_new = rho*sqrt((r_p/fmax(scale_p, 1e-10))/(r_d/fmax(scale_d, 1e-10)"
+             << "+1e-10));" << endl
+             << "      rho_new = fmin(fmax(rho_new, " << CodeGenerator::constant(rho_min_)
+             << "), " << CodeGenerator::constant(rho_max_) << ");" << endl
+             << "      if (rho_new>5*rho || rho_new<0.2*rho) {" << endl
+             << "        rho = rho_new;" << endl
+             << "        refactor = 1;" << endl
+             << "      }" << endl
+             << "    }" << endl;
+    }
+    g.body << "  }" << endl;
+
+    // Get the solution
+    g.body << "  copy(x, " << nx_ << ", res[" << CONIC_X << "]);" << endl
+           << "  copy(y, " << nx_ << ", res[" << CONIC_LAM_X << "]);" << endl
+           << "  copy(y+" << nx_ << ", " << na_ << ", res[" << CONIC_LAM_A << "]);" << endl
+           << "  if (res[" << CONIC_COST << "]) res[" << CONIC_COST << "][0] = "
+           << "0.5*bilin(hv, " << sp_h << ", x, x) + dot(" << nx_ << ", gv, x);" << endl;
+  }
+
+} // namespace casadi
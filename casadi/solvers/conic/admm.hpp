@@ -0,0 +1,157 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_ADMM_HPP
+#define CASADI_ADMM_HPP
+
+#include "casadi/core/function/conic_impl.hpp"
+#include "casadi/core/function/linsol.hpp"
+#include <casadi/solvers/conic/casadi_conic_admm_export.h>
+
+
+/** \defgroup plugin_Conic_admm
+
+    Operator splitting (ADMM) method for sparse convex QPs, in the style of OSQP.
+    The quasi-definite KKT matrix is factorized with a Linsol plugin and only
+    refactorized when the penalty parameter rho or the problem matrices change.
+    The primal and dual solution is kept in the memory block and used to warm
+    start the next call. Otherwise, and always in generated C code, the
+    iterations start from x0, lam_x0 and lam_a0. Generated C code uses a
+    built-in sparse LDL' factorization.
+*/
+
+/** \pluginsection{Conic,admm} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_CONIC_ADMM_EXPORT AdmmMemory : public ConicMemory {
+    // Linear solver memory
+    int mem_linsol;
+
+    // Solution of the last call, x, z = C*x and y
+    std::vector<double> x, z, y;
+
+    // Has a solution been stored?
+    bool has_sol;
+
+    // Penalty parameter
+    double rho;
+
+    // Data for the current factorization
+    std::vector<double> h, a, rho_vec;
+
+    // Number of iterations
+    int iter;
+
+    // Number of numeric factorizations during the last call
+    int n_factor;
+
+    // Return status
+    const char* return_status;
+  };
+
+  /** \brief \pluginbrief{Conic,admm}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_admm
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_CONIC_ADMM_EXPORT Admm : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Admm(const std::string& name,
+                  const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Admm(name, st);
+    }
+
+    /** \brief  Destructor */
+    virtual ~Admm();
+
+    // Get name of the plugin
+    virtual const char* plugin_name() const { return "admm";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    virtual void init(const Dict& opts);
+
+    /** \brief Create memory block */
+    virtual void* alloc_memory() const { return new AdmmMemory();}
+
+    /** \brief Free memory block */
+    virtual void free_memory(void *mem) const;
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
+
+    /** \brief  Evaluate numerically */
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Get all statistics */
+    virtual Dict get_stats(void* mem) const;
+
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+    // Penalty parameter for each constraint
+    void set_rho(double rho, const double* lb, const double* ub, double* rho_vec) const;
+
+    /// Solver for the KKT system
+    Linsol linsol_;
+
+    /// Sparsity pattern of the KKT matrix, [H+sigma*I+diag(rho_x), A'; A, -diag(1/rho_a)]
+    Sparsity kkt_;
+
+    /// Locations of the nonzeros of H, A, A' and the diagonal in kkt_
+    std::vector<int> kkt_h_, kkt_a_, kkt_at_, kkt_diag_;
+
+    /// Algorithmic parameters
+    double rho0_, rho_min_, rho_max_, sigma_, alpha_, eps_abs_, eps_rel_;
+    int max_iter_, rho_interval_;
+    bool warm_start_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_ADMM_HPP
@@ -0,0 +1,112 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+
+      #include "admm.hpp"
+      #include <string>
+
+      const std::string casadi::Admm::meta_doc=
+      "\n"
+"Operator splitting (ADMM) method for sparse convex QPs, in the style of\n"
+"OSQP. The quasi-definite KKT matrix is factorized with a Linsol plugin\n"
+"and only refactorized when the penalty parameter rho or the problem\n"
+"matrices change. The primal and dual solution is kept in the memory\n"
+"block and used to warm start the next call. Otherwise, and always in\n"
+"generated C code, the iterations start from x0, lam_x0 and lam_a0.\n"
+"Generated C code uses a built-in sparse LDL' factorization.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"|           Id          |    Type   | Default |      Description       |\n"
+"+=======================+===========+=========+========================+\n"
+"| alpha                 | OT_DOUBLE | 1.6     | Relaxation parameter,  |\n"
+"|                       |           |         | in (0, 2)              |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| eps_abs               | OT_DOUBLE | 1e-6    | Absolute tolerance on  |\n"
+"|                       |           |         | the primal and dual    |\n"
+"|                       |           |         | residuals              |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| eps_rel               | OT_DOUBLE | 1e-6    | Relative tolerance on  |\n"
+"|                       |           |         | the primal and dual    |\n"
+"|                       |           |         | residuals              |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| linear_solver         | OT_STRING | ldl     | Linear solver for the  |\n"
+"|                       |           |         | KKT system             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| linear_solver_options | OT_DICT   |         | Options to be passed   |\n"
+"|                       |           |         | to the linear solver   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| max_iter              | OT_INT    | 4000    | Maximum number of      |\n"
+"|                       |           |         | iterations             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| rho                   | OT_DOUBLE | 0.1     | Initial penalty        |\n"
+"|                       |           |         | parameter              |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| rho_interval          | OT_INT    | 25      | Number of iterations   |\n"
+"|                       |           |         | between updates of     |\n"
+"|                       |           |         | rho, 0 for a constant  |\n"
+"|                       |           |         | rho                    |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| rho_max               | OT_DOUBLE | 1e6     | Largest penalty        |\n"
+"|                       |           |         | parameter              |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| rho_min               | OT_DOUBLE | 1e-6    | Smallest penalty       |\n"
+"|                       |           |         | parameter, also used   |\n"
+"|                       |           |         | for constraints        |\n"
+"|                       |           |         | without bounds         |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| sigma                 | OT_DOUBLE | 1e-6    | Regularization of the  |\n"
+"|                       |           |         | primal variables       |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| warm_start            | OT_BOOL   | true    | Start from the         |\n"
+"|                       |           |         | solution of the        |\n"
+"|                       |           |         | previous call with the |\n"
+"|                       |           |         | same memory block      |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|       Id      |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| n_factor      |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"| rho           |\n"
+"+---------------+\n"
+"| success       |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
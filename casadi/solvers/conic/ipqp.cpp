@@ -0,0 +1,470 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "ipqp.hpp"
+#include <iomanip>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_IPQP_EXPORT
+  casadi_register_conic_ipqp(Conic::Plugin* plugin) {
+    plugin->creator = Ipqp::creator;
+    plugin->name = "ipqp";
+    plugin->doc = Ipqp::meta_doc.c_str();
+    plugin->version = 31;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_IPQP_EXPORT casadi_load_conic_ipqp() {
+    Conic::registerPlugin(casadi_register_conic_ipqp);
+  }
+
+  Ipqp::Ipqp(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Ipqp::~Ipqp() {
+    clear_memory();
+  }
+
+  Options Ipqp::options_
+  = {{&Conic::options_},
+     {{"linear_solver",
+       {OT_STRING,
+        "Linear solver for the KKT system [csparse]"}},
+      {"linear_solver_options",
+       {OT_DICT,
+        "Options to be passed to the linear solver"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]"}},
+      {"tol",
+       {OT_DOUBLE,
+        "Stopping tolerance on the primal and dual infeasibility "
+        "and the complementarity [1e-8]"}},
+      {"tau",
+       {OT_DOUBLE,
+        "Fraction of the distance to the boundary taken in each step [0.995]"}},
+      {"print_iter",
+       {OT_BOOL,
+        "Print information about each iteration [false]"}}
+     }
+  };
+
+  void Ipqp::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    string linear_solver = "csparse";
+    Dict linear_solver_options;
+    max_iter_ = 100;
+    tol_ = 1e-8;
+    tau_ = 0.995;
+    print_iter_ = false;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="linear_solver") {
+        linear_solver = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options = op.second;
+      } else if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      } else if (op.first=="tol") {
+        tol_ = op.second;
+      } else if (op.first=="tau") {
+        tau_ = op.second;
+      } else if (op.first=="print_iter") {
+        print_iter_ = op.second;
+      }
+    }
+    casadi_assert_message(tau_>0 && tau_<1, "Ipqp: 'tau' must be in (0, 1)");
+
+    // Sparsity pattern of the reduced KKT system, the diagonal is always structurally nonzero
+    kkt_ = Sparsity::blockcat({{H_.unite(Sparsity::diag(nx_)), A_.T()},
+                               {A_, Sparsity::diag(na_)}});
+
+    // Map the nonzeros of H, A, A' and the diagonal into the KKT matrix
+    vector<int> r, c;
+    H_.get_triplet(r, c);
+    kkt_h_.resize(r.size());
+    for (int k=0; k<r.size(); ++k) kkt_h_[k] = kkt_.get_nz(r[k], c[k]);
+    A_.get_triplet(r, c);
+    kkt_a_.resize(r.size());
+    kkt_at_.resize(r.size());
+    for (int k=0; k<r.size(); ++k) {
+      kkt_a_[k] = kkt_.get_nz(nx_+r[k], c[k]);
+      kkt_at_[k] = kkt_.get_nz(c[k], nx_+r[k]);
+    }
+    kkt_diag_.resize(nx_+na_);
+    for (int i=0; i<nx_+na_; ++i) kkt_diag_[i] = kkt_.get_nz(i, i);
+
+    // Create the linear solver
+    init_linsol(linear_solver, linear_solver_options);
+
+    // Allocate work vectors
+    int n = nx_ + na_;
+    alloc_w(H_.nnz() + nx_ + A_.nnz(), true); // h, g, a
+    alloc_w(12*n + 2*na_ + kkt_.nnz(), true);
+    alloc_iw(n, true);
+  }
+
+  void Ipqp::init_linsol(const std::string& linear_solver, const Dict& linear_solver_options) {
+    linsol_ = Linsol("linsol", linear_solver, linear_solver_options);
+  }
+
+  void Ipqp::init_memory(void* mem) const {
+    auto m = static_cast<IpqpMemory*>(mem);
+
+    // The symbolic factorization is reused for all calls with this memory block
+    m->mem_linsol = linsol_.checkout();
+    linsol_.reset(kkt_, m->mem_linsol);
+    m->iter = 0;
+    m->return_status = 0;
+  }
+
+  void Ipqp::free_memory(void *mem) const {
+    auto m = static_cast<IpqpMemory*>(mem);
+    linsol_.release(m->mem_linsol);
+    delete m;
+  }
+
+  Dict Ipqp::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<IpqpMemory*>(mem);
+    stats["iter_count"] = m->iter;
+    if (m->return_status) stats["return_status"] = string(m->return_status);
+    stats["success"] = m->return_status!=0 && string(m->return_status)=="success";
+    return stats;
+  }
+
+  void Ipqp::print_header() const {
+    userOut() << setw(5) << "iter" << setw(14) << "objective" << setw(10) << "inf_pr"
+              << setw(10) << "inf_du" << setw(10) << "mu" << setw(10) << "alpha_pr"
+              << setw(10) << "alpha_du" << endl;
+  }
+
+  void Ipqp::print_iteration(int iter, double obj, double pr, double du, double mu,
+                             double alpha_pr, double alpha_du) const {
+    userOut() << setw(5) << iter << setw(14) << scientific << setprecision(6) << obj
+              << setprecision(2) << setw(10) << pr << setw(10) << du << setw(10) << mu
+              << setw(10) << alpha_pr << setw(10) << alpha_du << endl;
+    userOut().unsetf(std::ios::floatfield);
+  }
+
+  void Ipqp::kkt_factorize(IpqpMemory* m, const double* kkt) const {
+    linsol_.factorize(kkt, m->mem_linsol);
+  }
+
+  void Ipqp::kkt_solve(IpqpMemory* m, double* d) const {
+    linsol_.solve(d, 1, false, m->mem_linsol);
+  }
+
+  double Ipqp::compl_measure(IpqpMemory* m, double alpha_pr, double alpha_du) const {
+    int n = nx_ + na_, nb = 0;
+    double r = 0;
+    for (int i=0; i<n; ++i) {
+      double zi = m->z[i] + alpha_pr*m->dz[i];
+      if (m->type[i] & IPQP_LB) {
+        r += (zi-m->lb[i])*(m->ul[i] + alpha_du*m->dul[i]);
+        nb++;
+      }
+      if (m->type[i] & IPQP_UB) {
+        r += (m->ub[i]-zi)*(m->uu[i] + alpha_du*m->duu[i]);
+        nb++;
+      }
+    }
+    return nb==0 ? 0 : r/nb;
+  }
+
+  void Ipqp::direction(IpqpMemory* m, const double* a) const {
+    int n = nx_ + na_;
+    const int* type = m->type;
+    double *z = m->z, *lb = m->lb, *ub = m->ub, *ul = m->ul, *uu = m->uu;
+    double *d = m->d, *dz = m->dz;
+
+    // Right-hand side of the reduced KKT system
+    for (int i=0; i<n; ++i) {
+      double q = 0, sigma = 0;
+      if (type[i] & IPQP_LB) {
+        q += m->cl[i]/(z[i]-lb[i]);
+        sigma += ul[i]/(z[i]-lb[i]);
+      }
+      if (type[i] & IPQP_UB) {
+        q -= m->cu[i]/(ub[i]-z[i]);
+        sigma += uu[i]/(ub[i]-z[i]);
+      }
+      if (i<nx_) {
+        d[i] = type[i] & IPQP_FIXED ? 0 : -m->rz[i]-q;
+      } else if (type[i] & IPQP_FIXED) {
+        d[i] = -m->re[i-nx_];
+      } else if (type[i] & IPQP_FREE) {
+        d[i] = -m->y[i-nx_];
+      } else {
+        d[i] = -m->re[i-nx_] - (m->rz[i]+q)/sigma;
+      }
+    }
+
+    // Solve with the existing factorization
+    kkt_solve(m, d);
+
+    // Recover the step in z, ds = A*dx + re
+    casadi_copy(d, nx_, dz);
+    casadi_copy(m->re, na_, dz+nx_);
+    casadi_mv(a, A_, dz, dz+nx_, false);
+    for (int i=0; i<n; ++i) if (type[i] & IPQP_FIXED) dz[i] = 0;
+
+    // Step in the bound multipliers
+    for (int i=0; i<n; ++i) {
+      m->dul[i] = type[i] & IPQP_LB ? -(m->cl[i] + ul[i]*dz[i])/(z[i]-lb[i]) : 0;
+      m->duu[i] = type[i] & IPQP_UB ? -(m->cu[i] - uu[i]*dz[i])/(ub[i]-z[i]) : 0;
+    }
+  }
+
+  void Ipqp::step_length(IpqpMemory* m, double tau, double& alpha_pr, double& alpha_du) const {
+    int n = nx_ + na_;
+    alpha_pr = alpha_du = 1;
+    for (int i=0; i<n; ++i) {
+      if (m->type[i] & IPQP_LB) {
+        if (m->dz[i]<0) alpha_pr = min(alpha_pr, -tau*(m->z[i]-m->lb[i])/m->dz[i]);
+        if (m->dul[i]<0) alpha_du = min(alpha_du, -tau*m->ul[i]/m->dul[i]);
+      }
+      if (m->type[i] & IPQP_UB) {
+        if (m->dz[i]>0) alpha_pr = min(alpha_pr, tau*(m->ub[i]-m->z[i])/m->dz[i]);
+        if (m->duu[i]<0) alpha_du = min(alpha_du, -tau*m->uu[i]/m->duu[i]);
+      }
+    }
+  }
+
+  void Ipqp::
+  eval(void* mem, const double** arg, double** res, int* iw, double* w) const {
+    auto m = static_cast<IpqpMemory*>(mem);
+
+    if (inputs_check_) {
+      checkInputs(arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
+    }
+
+    // Number of primal variables, z = [x; s] with s = A*x
+    int n = nx_ + na_;
+
+    // Problem data, missing entries are zero
+    const int *sp_h = H_, *sp_a = A_;
+    double *h = w; w += H_.nnz();
+    double *g = w; w += nx_;
+    double *a = w; w += A_.nnz();
+    casadi_copy(arg[CONIC_H], H_.nnz(), h);
+    casadi_copy(arg[CONIC_G], nx_, g);
+    casadi_copy(arg[CONIC_A], A_.nnz(), a);
+
+    // Work vectors
+    int* type = m->type = iw;
+    double *z = m->z = w; w += n;
+    double *lb = m->lb = w; w += n;
+    double *ub = m->ub = w; w += n;
+    double *ul = m->ul = w; w += n;
+    double *uu = m->uu = w; w += n;
+    double *rz = m->rz = w; w += n;
+    double *cl = m->cl = w; w += n;
+    double *cu = m->cu = w; w += n;
+    double *d = m->d = w; w += n;
+    double *dz = m->dz = w; w += n;
+    m->dul = w; w += n;
+    m->duu = w; w += n;
+    double *y = m->y = w; w += na_;
+    double *re = m->re = w; w += na_;
+    double *kkt = w; w += kkt_.nnz();
+
+    // Bounds on z
+    casadi_copy(arg[CONIC_LBX], nx_, lb);
+    casadi_copy(arg[CONIC_LBA], na_, lb+nx_);
+    casadi_copy(arg[CONIC_UBX], nx_, ub);
+    casadi_copy(arg[CONIC_UBA], na_, ub+nx_);
+    if (!arg[CONIC_LBX]) casadi_fill(lb, nx_, -inf);
+    if (!arg[CONIC_LBA]) casadi_fill(lb+nx_, na_, -inf);
+    if (!arg[CONIC_UBX]) casadi_fill(ub, nx_, inf);
+    if (!arg[CONIC_UBA]) casadi_fill(ub+nx_, na_, inf);
+
+    // Classify the bounds. Fixed components are kept at their value,
+    // constraints without bounds get a zero multiplier
+    for (int i=0; i<n; ++i) {
+      if (lb[i]==ub[i]) {
+        type[i] = IPQP_FIXED;
+      } else {
+        type[i] = 0;
+        if (lb[i]!=-inf) type[i] |= IPQP_LB;
+        if (ub[i]!=inf) type[i] |= IPQP_UB;
+        if (type[i]==0) type[i] = IPQP_FREE;
+      }
+    }
+
+    // Initial guess for x and s, strictly inside the bounds
+    casadi_copy(arg[CONIC_X0], nx_, z);
+    casadi_fill(z+nx_, na_, 0.);
+    casadi_mv(a, sp_a, z, z+nx_, false);
+    for (int i=0; i<n; ++i) {
+      if (type[i] & IPQP_FIXED) {
+        z[i] = lb[i];
+      } else if ((type[i] & IPQP_LB) && (type[i] & IPQP_UB)) {
+        double margin = min(1., 0.25*(ub[i]-lb[i]));
+        z[i] = min(max(z[i], lb[i]+margin), ub[i]-margin);
+      } else if (type[i] & IPQP_LB) {
+        z[i] = max(z[i], lb[i]+1.);
+      } else if (type[i] & IPQP_UB) {
+        z[i] = min(z[i], ub[i]-1.);
+      }
+    }
+
+    // Initial guess for the multipliers
+    casadi_fill(y, na_, 0.);
+    for (int i=0; i<n; ++i) {
+      ul[i] = type[i] & IPQP_LB ? 1. : 0.;
+      uu[i] = type[i] & IPQP_UB ? 1. : 0.;
+    }
+
+    // Interior point iterations
+    double alpha_pr = 0, alpha_du = 0;
+    m->return_status = 0;
+    for (m->iter=0; ; ++m->iter) {
+      // Dual residual, H*x + g + A'*y + lam_x for x and lam_s - y for s
+      casadi_copy(g, nx_, rz);
+      casadi_mv(h, sp_h, z, rz, false);
+      casadi_mv(a, sp_a, y, rz, true);
+      for (int i=nx_; i<n; ++i) rz[i] = -y[i-nx_];
+      for (int i=0; i<n; ++i) {
+        rz[i] = type[i] & IPQP_FIXED ? 0 : rz[i] + uu[i] - ul[i];
+      }
+
+      // Primal residual, A*x - s
+      casadi_fill(re, na_, 0.);
+      casadi_mv(a, sp_a, z, re, false);
+      casadi_axpy(na_, -1., z+nx_, re);
+
+      // Check convergence
+      double pr = casadi_norm_inf(na_, re);
+      double du = casadi_norm_inf(n, rz);
+      double mu = compl_measure(m, 0, 0);
+      if (print_iter_) {
+        if (m->iter % 10 == 0) print_header();
+        double obj = 0.5*casadi_bilin(h, sp_h, z, z) + casadi_dot(nx_, g, z);
+        print_iteration(m->iter, obj, pr, du, mu, alpha_pr, alpha_du);
+      }
+      if (isnan(pr) || isnan(du) || isnan(mu)) {
+        m->return_status = "NaN detected";
+        casadi_error("Ipqp failed: " + string(m->return_status));
+      }
+      if (max(max(pr, du), mu) <= tol_) {
+        m->return_status = "success";
+        break;
+      }
+      if (m->iter>=max_iter_) {
+        m->return_status = "Maximum number of iterations reached";
+        casadi_error("Ipqp failed: " + string(m->return_status));
+      }
+
+      // Assemble the KKT matrix, rows and columns of fixed variables
+      // and of constraints without bounds are replaced by identity
+      casadi_fill(kkt, kkt_.nnz(), 0.);
+      const int *colind_h = sp_h+2, *row_h = sp_h+2+nx_+1;
+      for (int c=0; c<nx_; ++c) {
+        if (type[c] & IPQP_FIXED) continue;
+        for (int k=colind_h[c]; k<colind_h[c+1]; ++k) {
+          if (!(type[row_h[k]] & IPQP_FIXED)) kkt[kkt_h_[k]] += h[k];
+        }
+      }
+      const int *colind_a = sp_a+2, *row_a = sp_a+2+nx_+1;
+      for (int c=0; c<nx_; ++c) {
+        if (type[c] & IPQP_FIXED) continue;
+        for (int k=colind_a[c]; k<colind_a[c+1]; ++k) {
+          if (type[nx_+row_a[k]] & IPQP_FREE) continue;
+          kkt[kkt_a_[k]] = kkt[kkt_at_[k]] = a[k];
+        }
+      }
+      for (int i=0; i<n; ++i) {
+        double sigma = 0;
+        if (type[i] & IPQP_LB) sigma += ul[i]/(z[i]-lb[i]);
+        if (type[i] & IPQP_UB) sigma += uu[i]/(ub[i]-z[i]);
+        double& kkt_ii = kkt[kkt_diag_[i]];
+        if (i<nx_) {
+          kkt_ii = type[i] & IPQP_FIXED ? 1 : kkt_ii + sigma;
+        } else if (type[i] & IPQP_FIXED) {
+          kkt_ii = 0;
+        } else {
+          kkt_ii = type[i] & IPQP_FREE ? 1 : -1/sigma;
+        }
+      }
+
+      // Numeric factorization, the symbolic factorization is reused
+      kkt_factorize(m, kkt);
+
+      // Affine scaling (predictor) step
+      for (int i=0; i<n; ++i) {
+        cl[i] = type[i] & IPQP_LB ? (z[i]-lb[i])*ul[i] : 0;
+        cu[i] = type[i] & IPQP_UB ? (ub[i]-z[i])*uu[i] : 0;
+      }
+      direction(m, a);
+      step_length(m, 1., alpha_pr, alpha_du);
+
+      // Centering parameter
+      double sigma = mu==0 ? 0 : pow(compl_measure(m, alpha_pr, alpha_du)/mu, 3);
+
+      // Combined (corrector) step
+      for (int i=0; i<n; ++i) {
+        if (type[i] & IPQP_LB) cl[i] += dz[i]*m->dul[i] - sigma*mu;
+        if (type[i] & IPQP_UB) cu[i] -= dz[i]*m->duu[i] + sigma*mu;
+      }
+      direction(m, a);
+      step_length(m, tau_, alpha_pr, alpha_du);
+
+      // Take the step
+      casadi_axpy(n, alpha_pr, dz, z);
+      casadi_axpy(na_, alpha_du, d+nx_, y);
+      casadi_axpy(n, alpha_du, m->dul, ul);
+      casadi_axpy(n, alpha_du, m->duu, uu);
+    }
+
+    // Get the solution
+    casadi_copy(z, nx_, res[CONIC_X]);
+    casadi_copy(y, na_, res[CONIC_LAM_A]);
+    if (res[CONIC_COST]) {
+      *res[CONIC_COST] = 0.5*casadi_bilin(h, sp_h, z, z) + casadi_dot(nx_, g, z);
+    }
+    if (res[CONIC_LAM_X]) {
+      // Multipliers for fixed variables from stationarity
+      double* lam_x = res[CONIC_LAM_X];
+      casadi_copy(g, nx_, lam_x);
+      casadi_mv(h, sp_h, z, lam_x, false);
+      casadi_mv(a, sp_a, y, lam_x, true);
+      for (int i=0; i<nx_; ++i) {
+        lam_x[i] = type[i] & IPQP_FIXED ? -lam_x[i] : uu[i] - ul[i];
+      }
+    }
+  }
+
+} // namespace casadi
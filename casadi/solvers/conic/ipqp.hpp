@@ -0,0 +1,180 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_IPQP_HPP
+#define CASADI_IPQP_HPP
+
+#include "casadi/core/function/conic_impl.hpp"
+#include "casadi/core/function/linsol.hpp"
+#include <casadi/solvers/conic/casadi_conic_ipqp_export.h>
+
+
+/** \defgroup plugin_Conic_ipqp
+
+    Primal-dual interior point method for sparse convex QPs.
+    Mehrotra predictor-corrector steps are taken on the reduced KKT system,
+    which is factorized with a Linsol plugin. The symbolic factorization is
+    performed once and reused across iterations and calls.
+*/
+
+/** \pluginsection{Conic,ipqp} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  // Classification of the components of z = [x; A*x]
+  enum IpqpBound {IPQP_LB=1, IPQP_UB=2, IPQP_FIXED=4, IPQP_FREE=8};
+
+  struct CASADI_CONIC_IPQP_EXPORT IpqpMemory : public ConicMemory {
+    // Linear solver memory
+    int mem_linsol;
+
+    // Bound type of each component
+    int* type;
+
+    // Primal variables, bounds and bound multipliers
+    double *z, *lb, *ub, *ul, *uu;
+
+    // Residuals
+    double *rz, *re, *cl, *cu;
+
+    // Multipliers for A*x - s = 0
+    double* y;
+
+    // Search direction
+    double *d, *dz, *dul, *duu;
+
+    // Number of iterations
+    int iter;
+
+    // Return status
+    const char* return_status;
+  };
+
+  /** \brief \pluginbrief{Conic,ipqp}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_ipqp
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_CONIC_IPQP_EXPORT Ipqp : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Ipqp(const std::string& name,
+                  const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Ipqp(name, st);
+    }
+
+    /** \brief  Destructor */
+    virtual ~Ipqp();
+
+    // Get name of the plugin
+    virtual const char* plugin_name() const { return "ipqp";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    virtual void init(const Dict& opts);
+
+    /** \brief Create memory block */
+    virtual void* alloc_memory() const { return new IpqpMemory();}
+
+    /** \brief Free memory block */
+    virtual void free_memory(void *mem) const;
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
+
+    /** \brief  Evaluate numerically */
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Get all statistics */
+    virtual Dict get_stats(void* mem) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+    // Create the solver for the KKT system
+    virtual void init_linsol(const std::string& linear_solver, const Dict& linear_solver_options);
+
+    // Numeric factorization of the KKT matrix
+    virtual void kkt_factorize(IpqpMemory* m, const double* kkt) const;
+
+    // Solve the KKT system with the existing factorization, overwriting the right-hand side
+    virtual void kkt_solve(IpqpMemory* m, double* d) const;
+
+    // Newton direction for the complementarity residuals in m->cl, m->cu
+    void direction(IpqpMemory* m, const double* a) const;
+
+    // Largest steps keeping z inside its bounds and the multipliers positive
+    void step_length(IpqpMemory* m, double tau, double& alpha_pr, double& alpha_du) const;
+
+    // Average complementarity after a step
+    double compl_measure(IpqpMemory* m, double alpha_pr, double alpha_du) const;
+
+    // Print iteration header
+    void print_header() const;
+
+    // Print iteration
+    void print_iteration(int iter, double obj, double pr, double du, double mu,
+                         double alpha_pr, double alpha_du) const;
+
+    /// Solver for the KKT system
+    Linsol linsol_;
+
+    /// Sparsity pattern of the KKT matrix, [H+D_x, A'; A, -D_a]
+    Sparsity kkt_;
+
+    /// Locations of the nonzeros of H, A, A' and the diagonal in kkt_
+    std::vector<int> kkt_h_, kkt_a_, kkt_at_, kkt_diag_;
+
+    /// Maximum number of iterations
+    int max_iter_;
+
+    /// Stopping tolerance
+    double tol_;
+
+    /// Fraction to the boundary
+    double tau_;
+
+    /// Print iterations
+    bool print_iter_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_IPQP_HPP
@@ -0,0 +1,82 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "ipqp.hpp"
+      #include <string>
+
+      const std::string casadi::Ipqp::meta_doc=
+      "\n"
+"Primal-dual interior point method for sparse convex QPs. Mehrotra\n"
+"predictor-corrector steps are taken on the reduced KKT system, which is\n"
+"factorized with a Linsol plugin. The symbolic factorization is performed\n"
+"once and reused across iterations and calls.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"|          Id           |   Type    | Default |      Description       |\n"
+"+=======================+===========+=========+========================+\n"
+"| linear_solver         | OT_STRING | csparse | Linear solver for the  |\n"
+"|                       |           |         | KKT system             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| linear_solver_options | OT_DICT   |         | Options to be passed   |\n"
+"|                       |           |         | to the linear solver   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| max_iter              | OT_INT    | 100     | Maximum number of      |\n"
+"|                       |           |         | iterations             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| print_iter            | OT_BOOL   | false   | Print information      |\n"
+"|                       |           |         | about each iteration   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| tau                   | OT_DOUBLE | 0.995   | Fraction of the        |\n"
+"|                       |           |         | distance to the        |\n"
+"|                       |           |         | boundary taken in each |\n"
+"|                       |           |         | step                   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| tol                   | OT_DOUBLE | 1e-8    | Stopping tolerance on  |\n"
+"|                       |           |         | the primal and dual    |\n"
+"|                       |           |         | infeasibility and the  |\n"
+"|                       |           |         | complementarity        |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|      Id       |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"| success       |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
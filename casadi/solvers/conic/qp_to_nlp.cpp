@@ -179,8 +179,15 @@ namespace casadi {
     res1[NLPSOL_LAM_X] = lam_x_;
     res1[NLPSOL_LAM_G] = lam_a_;
 
-    // Solve the NLP
-    solver_(arg1, res1, iw, w, 0);
+    // Solve the NLP, with an own memory object since the QP may be solved concurrently
+    int m = solver_.checkout();
+    try {
+      solver_(arg1, res1, iw, w, m);
+    } catch(...) {
+      solver_.release(m);
+      throw;
+    }
+    solver_.release(m);
   }
 
 } // namespace casadi
@@ -0,0 +1,264 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "riccati.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_RICCATI_EXPORT
+  casadi_register_conic_riccati(Conic::Plugin* plugin) {
+    plugin->creator = Riccati::creator;
+    plugin->name = "riccati";
+    plugin->doc = Riccati::meta_doc.c_str();
+    plugin->version = 31;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_RICCATI_EXPORT casadi_load_conic_riccati() {
+    Conic::registerPlugin(casadi_register_conic_riccati);
+  }
+
+  // Dense LU factorization with partial pivoting, column major, in place
+  static void lu_factorize(int n, double* a, int* ipiv) {
+    for (int k=0; k<n; ++k) {
+      int p = k;
+      for (int i=k+1; i<n; ++i) if (fabs(a[i+k*n])>fabs(a[p+k*n])) p = i;
+      ipiv[k] = p;
+      if (p!=k) for (int j=0; j<n; ++j) swap(a[k+j*n], a[p+j*n]);
+      for (int i=k+1; i<n; ++i) a[i+k*n] /= a[k+k*n];
+      for (int j=k+1; j<n; ++j) {
+        for (int i=k+1; i<n; ++i) a[i+j*n] -= a[i+k*n]*a[k+j*n];
+      }
+    }
+  }
+
+  // Solve with a factorization from lu_factorize, nrhs right-hand sides
+  static void lu_solve(int n, const double* a, const int* ipiv, double* b, int nrhs) {
+    for (int r=0; r<nrhs; ++r, b+=n) {
+      for (int k=0; k<n; ++k) if (ipiv[k]!=k) swap(b[k], b[ipiv[k]]);
+      for (int k=0; k<n; ++k) {
+        for (int i=k+1; i<n; ++i) b[i] -= a[i+k*n]*b[k];
+      }
+      for (int k=n-1; k>=0; --k) {
+        b[k] /= a[k+k*n];
+        for (int i=0; i<k; ++i) b[i] -= a[i+k*n]*b[k];
+      }
+    }
+  }
+
+  Riccati::Riccati(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Ipqp(name, st) {
+  }
+
+  Riccati::~Riccati() {
+    clear_memory();
+  }
+
+  void Riccati::init(const Dict& opts) {
+    // Initialize the base classes
+    Ipqp::init(opts);
+
+    // Place each constraint directly after the last variable it depends on.
+    // The KKT system is then partitioned at variables only, so that each
+    // multiplier of a dynamic constraint ends up with the state it defines
+    int n = nx_ + na_;
+    vector<int> last(na_, -1);
+    const int *colind_a = A_.colind(), *row_a = A_.row();
+    for (int c=0; c<nx_; ++c) {
+      for (int k=colind_a[c]; k<colind_a[c+1]; ++k) last[row_a[k]] = c;
+    }
+    vector<vector<int> > after(nx_);
+    vector<int> start;
+    perm_.clear();
+    for (int i=0; i<na_; ++i) {
+      if (last[i]<0) {
+        start.push_back(perm_.size());
+        perm_.push_back(nx_+i);
+      } else {
+        after[last[i]].push_back(nx_+i);
+      }
+    }
+    for (int c=0; c<nx_; ++c) {
+      start.push_back(perm_.size());
+      perm_.push_back(c);
+      perm_.insert(perm_.end(), after[c].begin(), after[c].end());
+    }
+    vector<int> iperm(n);
+    for (int p=0; p<n; ++p) iperm[perm_[p]] = p;
+
+    // Smallest position coupled to any position from p onwards
+    vector<int> r, c;
+    kkt_.get_triplet(r, c);
+    vector<int> lo = range(n);
+    for (int k=0; k<r.size(); ++k) {
+      int pi = iperm[r[k]], pj = iperm[c[k]];
+      if (pi>pj) lo[pi] = min(lo[pi], pj);
+    }
+    for (int p=n-2; p>=0; --p) lo[p] = min(lo[p], lo[p+1]);
+
+    // Smallest blocks such that each block is only coupled to its neighbours
+    blk_ = {0};
+    for (int t : start) {
+      if (t>blk_.back() && lo[t]>=blk_.back()) blk_.push_back(t);
+    }
+    if (n>0) blk_.push_back(n);
+    int nb = blk_.size()-1;
+    vector<int> blk_of(n);
+    for (int b=0; b<nb; ++b) {
+      for (int p=blk_[b]; p<blk_[b+1]; ++p) blk_of[p] = b;
+    }
+
+    // Dense storage for the diagonal and the subdiagonal blocks
+    s_off_.resize(nb);
+    x_off_.resize(nb);
+    sz_blk_ = sz_tmp_ = 0;
+    int max_blk = 0;
+    for (int b=0; b<nb; ++b) {
+      int n_b = blk_[b+1]-blk_[b], n_next = b+1<nb ? blk_[b+2]-blk_[b+1] : 0;
+      max_blk = max(max_blk, n_b);
+      s_off_[b] = sz_blk_;
+      sz_blk_ += n_b*n_b;
+      x_off_[b] = sz_blk_;
+      sz_blk_ += n_next*n_b;
+      sz_tmp_ = max(sz_tmp_, n_next*n_b);
+    }
+
+    // Scatter pattern from the KKT nonzeros into the blocks
+    kkt_dest_.resize(r.size());
+    for (int k=0; k<r.size(); ++k) {
+      int pi = iperm[r[k]], pj = iperm[c[k]], bi = blk_of[pi], bj = blk_of[pj];
+      int n_bi = blk_[bi+1]-blk_[bi];
+      int ind = pi-blk_[bi] + (pj-blk_[bj])*n_bi;
+      if (bi==bj) {
+        kkt_dest_[k] = s_off_[bi] + ind;
+      } else if (bi==bj+1) {
+        kkt_dest_[k] = x_off_[bj] + ind;
+      } else {
+        casadi_assert(bj==bi+1);
+        kkt_dest_[k] = -1;
+      }
+    }
+
+    if (verbose()) {
+      vector<int> mapping;
+      stringstream ss;
+      ss << "Riccati: " << nb << " blocks, largest block " << max_blk
+         << ", lower bandwidth of the reordered KKT matrix "
+         << kkt_.sub(perm_, perm_, mapping).bw_lower() << ".";
+      log(ss.str());
+    }
+  }
+
+  void Riccati::init_memory(void* mem) const {
+    auto m = static_cast<RiccatiMemory*>(mem);
+
+    // The block storage is reused for all calls with this memory block
+    m->blk.resize(sz_blk_);
+    m->ipiv.resize(nx_+na_);
+    m->v.resize(nx_+na_);
+    m->tmp.resize(sz_tmp_);
+    m->iter = 0;
+    m->return_status = 0;
+  }
+
+  void Riccati::free_memory(void *mem) const {
+    delete static_cast<RiccatiMemory*>(mem);
+  }
+
+  Dict Riccati::get_stats(void* mem) const {
+    Dict stats = Ipqp::get_stats(mem);
+    int max_blk = 0;
+    for (int b=0; b+1<blk_.size(); ++b) max_blk = max(max_blk, blk_[b+1]-blk_[b]);
+    stats["n_block"] = static_cast<int>(blk_.size())-1;
+    stats["max_block"] = max_blk;
+    return stats;
+  }
+
+  void Riccati::kkt_factorize(IpqpMemory* mem, const double* kkt) const {
+    auto m = static_cast<RiccatiMemory*>(mem);
+    double *blk = get_ptr(m->blk), *f = get_ptr(m->tmp);
+    int *ipiv = get_ptr(m->ipiv);
+
+    // Scatter the lower triangular couplings and the diagonal blocks
+    casadi_fill(blk, sz_blk_, 0.);
+    for (int k=0; k<kkt_dest_.size(); ++k) {
+      if (kkt_dest_[k]>=0) blk[kkt_dest_[k]] = kkt[k];
+    }
+
+    // Backward recursion, S_k = K_k - F_k'*inv(S_{k+1})*F_k, keeping X_k = inv(S_{k+1})*F_k
+    int nb = blk_.size()-1;
+    for (int b=nb-1; b>=0; --b) {
+      int n_b = blk_[b+1]-blk_[b];
+      double *s = blk + s_off_[b];
+      if (b+1<nb) {
+        int n_next = blk_[b+2]-blk_[b+1];
+        double *x = blk + x_off_[b];
+        casadi_copy(x, n_next*n_b, f);
+        lu_solve(n_next, blk + s_off_[b+1], ipiv + blk_[b+1], x, n_b);
+        for (int j=0; j<n_b; ++j) {
+          for (int i=0; i<n_b; ++i) s[i+j*n_b] -= casadi_dot(n_next, f+i*n_next, x+j*n_next);
+        }
+      }
+      lu_factorize(n_b, s, ipiv + blk_[b]);
+    }
+  }
+
+  void Riccati::kkt_solve(IpqpMemory* mem, double* d) const {
+    auto m = static_cast<RiccatiMemory*>(mem);
+    const double *blk = get_ptr(m->blk);
+    const int *ipiv = get_ptr(m->ipiv);
+    double *v = get_ptr(m->v);
+    int nb = blk_.size()-1;
+    for (int p=0; p<perm_.size(); ++p) v[p] = d[perm_[p]];
+
+    // Eliminate the right-hand side backwards, v_k -= X_k'*v_{k+1}
+    for (int b=nb-2; b>=0; --b) {
+      int n_b = blk_[b+1]-blk_[b], n_next = blk_[b+2]-blk_[b+1];
+      const double *x = blk + x_off_[b];
+      for (int j=0; j<n_b; ++j) {
+        v[blk_[b]+j] -= casadi_dot(n_next, x+j*n_next, v+blk_[b+1]);
+      }
+    }
+
+    // Forward substitution, d_{k+1} = inv(S_{k+1})*v_{k+1} - X_k*d_k
+    for (int b=0; b<nb; ++b) {
+      int n_b = blk_[b+1]-blk_[b];
+      lu_solve(n_b, blk + s_off_[b], ipiv + blk_[b], v + blk_[b], 1);
+      if (b>0) {
+        int n_prev = blk_[b]-blk_[b-1];
+        const double *x = blk + x_off_[b-1];
+        for (int j=0; j<n_prev; ++j) {
+          casadi_axpy(n_b, -v[blk_[b-1]+j], x+j*n_b, v+blk_[b]);
+        }
+      }
+    }
+    for (int p=0; p<perm_.size(); ++p) d[perm_[p]] = v[p];
+  }
+
+} // namespace casadi
@@ -0,0 +1,142 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_RICCATI_HPP
+#define CASADI_RICCATI_HPP
+
+#include "ipqp.hpp"
+#include <casadi/solvers/conic/casadi_conic_riccati_export.h>
+
+
+/** \defgroup plugin_Conic_riccati
+
+    Interior point method for QPs arising from optimal control problems.
+    The iterations are those of ipqp, but the KKT system is solved with a
+    backward Riccati-type recursion instead of a general sparse linear solver.
+    The stage-wise structure is detected from the sparsity patterns of H and A:
+    each constraint is placed after the last variable it depends on, and the
+    resulting KKT matrix is partitioned into the smallest blocks such that it
+    is block tridiagonal. For an optimal control problem with N stages of size
+    n, this costs O(N*n^3) operations instead of O((N*n)^3). No stage
+    dimensions need to be given and the block storage is allocated once per
+    memory block. The options linear_solver and linear_solver_options are
+    not used. The detected structure is reported in the statistics n_block
+    and max_block.
+*/
+
+/** \pluginsection{Conic,riccati} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_CONIC_RICCATI_EXPORT RiccatiMemory : public IpqpMemory {
+    // Diagonal blocks, overwritten by their LU factors, and off-diagonal blocks
+    std::vector<double> blk;
+
+    // Row pivots of the LU factorizations
+    std::vector<int> ipiv;
+
+    // Right-hand side in block order
+    std::vector<double> v;
+
+    // Copy of an off-diagonal block
+    std::vector<double> tmp;
+  };
+
+  /** \brief \pluginbrief{Conic,riccati}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_riccati
+
+      \author Joel Andersson
+      \date 2016
+  */
+  class CASADI_CONIC_RICCATI_EXPORT Riccati : public Ipqp {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Riccati(const std::string& name,
+                     const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Riccati(name, st);
+    }
+
+    /** \brief  Destructor */
+    virtual ~Riccati();
+
+    // Get name of the plugin
+    virtual const char* plugin_name() const { return "riccati";}
+
+    /** \brief  Initialize */
+    virtual void init(const Dict& opts);
+
+    /** \brief Create memory block */
+    virtual void* alloc_memory() const { return new RiccatiMemory();}
+
+    /** \brief Free memory block */
+    virtual void free_memory(void *mem) const;
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
+
+    /// Get all statistics
+    virtual Dict get_stats(void* mem) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+    // No linear solver is needed for the KKT system
+    virtual void init_linsol(const std::string& linear_solver,
+                             const Dict& linear_solver_options) {}
+
+    // Block tridiagonal factorization of the KKT matrix
+    virtual void kkt_factorize(IpqpMemory* m, const double* kkt) const;
+
+    // Solve the KKT system with the block factorization
+    virtual void kkt_solve(IpqpMemory* m, double* d) const;
+
+    /// KKT row for each position in the block ordering
+    std::vector<int> perm_;
+
+    /// First position of each block, with the total size appended
+    std::vector<int> blk_;
+
+    /// Offsets of the diagonal blocks S_k and off-diagonal blocks X_k in the block storage
+    std::vector<int> s_off_, x_off_;
+
+    /// Location of each KKT nonzero in the block storage, -1 if in the upper triangle
+    std::vector<int> kkt_dest_;
+
+    /// Size of the block storage and of the largest off-diagonal block
+    int sz_blk_, sz_tmp_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_RICCATI_HPP
@@ -0,0 +1,89 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+
+      #include "riccati.hpp"
+      #include <string>
+
+      const std::string casadi::Riccati::meta_doc=
+      "\n"
+"The iterations are those of ipqp, but the KKT system is solved with a\n"
+"backward Riccati-type recursion instead of a general sparse linear solver.\n"
+"The stage-wise structure is detected from the sparsity patterns of H and A:\n"
+"each constraint is placed after the last variable it depends on, and the\n"
+"resulting KKT matrix is partitioned into the smallest blocks such that it\n"
+"is block tridiagonal. For an optimal control problem with N stages of size\n"
+"n, this costs O(N*n^3) operations instead of O((N*n)^3). No stage\n"
+"dimensions need to be given and the block storage is allocated once per\n"
+"memory block. The options linear_solver and linear_solver_options are not\n"
+"used.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"|          Id           |   Type    | Default |      Description       |\n"
+"+=======================+===========+=========+========================+\n"
+"| linear_solver         | OT_STRING | csparse | Linear solver for the  |\n"
+"|                       |           |         | KKT system             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| linear_solver_options | OT_DICT   |         | Options to be passed   |\n"
+"|                       |           |         | to the linear solver   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| max_iter              | OT_INT    | 100     | Maximum number of      |\n"
+"|                       |           |         | iterations             |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| print_iter            | OT_BOOL   | false   | Print information      |\n"
+"|                       |           |         | about each iteration   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| tau                   | OT_DOUBLE | 0.995   | Fraction of the        |\n"
+"|                       |           |         | distance to the        |\n"
+"|                       |           |         | boundary taken in each |\n"
+"|                       |           |         | step                   |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"| tol                   | OT_DOUBLE | 1e-8    | Stopping tolerance on  |\n"
+"|                       |           |         | the primal and dual    |\n"
+"|                       |           |         | infeasibility and the  |\n"
+"|                       |           |         | complementarity        |\n"
+"+-----------------------+-----------+---------+------------------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|      Id       |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"| success       |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
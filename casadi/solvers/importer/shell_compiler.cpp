@@ -27,9 +27,17 @@
 #include "casadi/core/std_vector_tools.hpp"
 #include "casadi/core/casadi_meta.hpp"
 #include <fstream>
+#include <iomanip>
 #include <dlfcn.h>
 #include <cstdlib>
+#include <cstdio>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <functional>
 
 using namespace std;
 namespace casadi {
@@ -49,16 +57,25 @@ namespace casadi {
     ImporterInternal::registerPlugin(casadi_register_importer_shell);
   }
 
+  std::atomic<int> ShellCompiler::cache_hits_(0);
+  std::atomic<int> ShellCompiler::cache_misses_(0);
+
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = 0;
+      cached_ = false;
+      cache_hit_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
     // Unload
     if (handle_) dlclose(handle_);
 
-    // Delete the temporary file
+    // Binaries in the compilation cache are kept
+    if (cached_ && bin_name_==cache_name_) return;
+
+    // Delete the temporary file, also if compilation failed
+    if (bin_name_.empty()) return;
     std::string rmcmd = "rm " + bin_name_;
     if (system(rmcmd.c_str())) {
       casadi_warning("Failed to delete temporary file:" + bin_name_);
@@ -77,10 +94,61 @@ namespace casadi {
         " custom flags."}},
       {"flags",
        {OT_STRINGVECTOR,
-      "Compile flags for the JIT compiler. Default: None"}}
+      "Compile flags for the JIT compiler. Default: None"}},
+      {"cache_dir",
+       {OT_STRING,
+        "Directory for caching compiled binaries. A binary is reused if the source code, "
+        "the compiler command and the location and version of the compiler match. "
+        "Default: None (no caching)"}},
+      {"sources",
+       {OT_STRINGVECTOR,
+        "Additional source files. All source files are compiled in parallel and "
+        "linked into one binary. Default: None"}},
+      {"num_threads",
+       {OT_INT,
+        "Maximum number of source files compiled in parallel. "
+        "Default: Number of hardware threads"}}
      }
   };
 
+  /// FNV-1a hash of a string, as a hexadecimal string
+  static std::string fnv1a_hash(const std::string& s) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+      h ^= c;
+      h *= 1099511628211ULL;
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+  }
+
+  /// Standard output of a shell command, empty if it cannot be run
+  static std::string shell_output(const std::string& cmd) {
+    FILE* p = popen(cmd.c_str(), "r");
+    if (!p) return std::string();
+    std::string ret;
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p))>0) ret.append(buf, n);
+    pclose(p);
+    return ret;
+  }
+
+  /// Create a directory and its parents, if they do not exist
+  static void make_dirs(const std::string& dir) {
+    for (string::size_type pos = dir.find('/', 1); ; pos = dir.find('/', pos+1)) {
+      string d = dir.substr(0, pos);
+      if (mkdir(d.c_str(), 0755) && errno!=EEXIST) {
+        casadi_error("Failed to create directory \"" + d + "\": " + strerror(errno));
+      }
+      if (pos==string::npos) break;
+    }
+    struct stat st;
+    casadi_assert_message(stat(dir.c_str(), &st)==0 && S_ISDIR(st.st_mode),
+                          "\"" + dir + "\" is not a directory");
+  }
+
   void ShellCompiler::init(const Dict& opts) {
     // Base class
     ImporterInternal::init(opts);
@@ -89,6 +157,9 @@ namespace casadi {
     string compiler = "gcc";
     string compiler_setup = "-fPIC -shared";
     vector<string> flags;
+    string cache_dir;
+    vector<string> sources;
+    int num_threads = thread::hardware_concurrency();
 
     // Read options
     for (auto&& op : opts) {
@@ -98,6 +169,12 @@ namespace casadi {
         compiler_setup = op.second.to_string();
       } else if (op.first=="flags") {
         flags = op.second;
+      } else if (op.first=="cache_dir") {
+        cache_dir = op.second.to_string();
+      } else if (op.first=="sources") {
+        sources = op.second;
+      } else if (op.first=="num_threads") {
+        num_threads = op.second;
       }
     }
 
@@ -108,35 +185,80 @@ namespace casadi {
       cmd << " " << *i;
     }
 
-    // C/C++ source file
-    cmd << " " << name_;
+    // Look up the binary in the compilation cache
+    if (!cache_dir.empty()) {
+      // Key: The location and version of the compiler, the compiler command
+      // and the source code
+      stringstream key;
+      key << shell_output("command -v " + compiler + " 2>/dev/null")
+          << shell_output(compiler + " --version 2>/dev/null")
+          << cmd.str() << endl;
+      sources.insert(sources.begin(), name_);
+      for (auto&& f : sources) {
+        ifstream src(f.c_str());
+        casadi_assert_message(src.good(), "Cannot open source file \"" + f + "\"");
+        key << src.rdbuf();
+      }
+      sources.erase(sources.begin());
+      cache_name_ = cache_dir + "/casadi_jit_" + fnv1a_hash(key.str()) + ".so";
 
-    // Name of temporary file
-#ifdef HAVE_MKSTEMPS
-    // Preferred solution
-    char bin_name[] = "tmp_casadi_compiler_shell_XXXXXX.so";
-    if (mkstemps(bin_name, 3) == -1) {
-      casadi_error("Failed to create a temporary file name");
+      // Have relative paths start with ./
+      if (cache_name_.at(0)!='/') cache_name_ = "./" + cache_name_;
+
+      // Reuse if available
+      cached_ = true;
+      cache_hit_ = access(cache_name_.c_str(), R_OK)==0;
+      if (cache_hit_) {
+        cache_hits_++;
+        bin_name_ = cache_name_;
+      } else {
+        cache_misses_++;
+        // Create the cache directory, if needed
+        make_dirs(cache_dir);
+      }
     }
-    bin_name_ = bin_name;
+
+    if (!cache_hit_) {
+      // Name of temporary file, in the cache directory when caching
+#ifdef HAVE_MKSTEMPS
+      // Preferred solution
+      string bin_template = "tmp_casadi_compiler_shell_XXXXXX.so";
+      if (cached_) bin_template = cache_dir + "/" + bin_template;
+      vector<char> bin_name(bin_template.begin(), bin_template.end());
+      bin_name.push_back('\0');
+      if (mkstemps(&bin_name.front(), 3) == -1) {
+        casadi_error("Failed to create a temporary file name");
+      }
+      bin_name_ = &bin_name.front();
 #else
-    // Fallback, may result in deprecation warnings
-    char* bin_name = tempnam(0, "ca.so");
-    bin_name_ = bin_name;
-    free(bin_name);
+      // Fallback, may result in deprecation warnings
+      char* bin_name = tempnam(cached_ ? cache_dir.c_str() : 0, "ca.so");
+      bin_name_ = bin_name;
+      free(bin_name);
 #endif
 
-    // Have relative paths start with ./
-    if (bin_name_.at(0)!='/') {
-      bin_name_ = "./" + bin_name_;
-    }
+      // Have relative paths start with ./
+      if (bin_name_.at(0)!='/') {
+        bin_name_ = "./" + bin_name_;
+      }
 
-    // Temporary file
-    cmd << " -o " << bin_name_;
+      if (sources.empty()) {
+        // Compile into a shared library
+        cmd << " " << name_ << " -o " << bin_name_;
+        if (system(cmd.str().c_str())) {
+          casadi_error("Compilation failed. Tried \"" + cmd.str() + "\"");
+        }
+      } else {
+        compile_parallel(cmd.str(), sources, num_threads);
+      }
 
-    // Compile into a shared library
-    if (system(cmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cmd.str() + "\"");
+      // Move into the cache, atomically in case other processes use the same cache
+      if (cached_) {
+        if (rename(bin_name_.c_str(), cache_name_.c_str())) {
+          casadi_error("Failed to move \"" + bin_name_ + "\" to \"" + cache_name_ + "\"");
+        }
+        bin_name_ = cache_name_;
+      }
     }
 
     // Load shared library
@@ -147,6 +269,58 @@ namespace casadi {
     dlerror();
   }
 
+  /// Run compilation commands until there are none left, record any failure
+  static void compile_worker(const vector<string>& obj_cmd, atomic<int>& next,
+                             atomic<int>& failed) {
+    for (int k=next++; k<obj_cmd.size(); k=next++) {
+      if (system(obj_cmd[k].c_str())) failed = k;
+    }
+  }
+
+  void ShellCompiler::compile_parallel(const std::string& cmd,
+                                       const std::vector<std::string>& sources,
+                                       int num_threads) const {
+    // Compile each source file into an object file
+    vector<string> src(1, name_), obj, obj_cmd;
+    src.insert(src.end(), sources.begin(), sources.end());
+    for (int k=0; k<src.size(); ++k) {
+      obj.push_back(bin_name_ + "_" + to_string(k) + ".o");
+      obj_cmd.push_back(cmd + " -c " + src[k] + " -o " + obj[k]);
+    }
+
+    // Worker threads take the next file until all have been compiled
+    atomic<int> next(0), failed(-1);
+    vector<thread> threads;
+    for (int t=0; t<max(1, min<int>(num_threads, src.size())); ++t) {
+      threads.push_back(thread(compile_worker, cref(obj_cmd), ref(next), ref(failed)));
+    }
+    for (auto&& t : threads) t.join();
+
+    // Link into a shared library
+    stringstream link_cmd;
+    link_cmd << cmd;
+    for (auto&& f : obj) link_cmd << " " << f;
+    link_cmd << " -o " << bin_name_;
+    bool link_failed = failed<0 && system(link_cmd.str().c_str());
+
+    // Object files are no longer needed
+    for (auto&& f : obj) remove(f.c_str());
+    if (failed>=0) {
+      casadi_error("Compilation failed. Tried \"" + obj_cmd[failed] + "\"");
+    }
+    casadi_assert_message(!link_failed, "Linking failed. Tried \"" + link_cmd.str() + "\"");
+  }
+
+  Dict ShellCompiler::get_stats() const {
+    Dict stats;
+    stats["cached"] = cached_;
+    stats["cache_hit"] = cache_hit_;
+    stats["cache_hits"] = cache_hits_.load();
+    stats["cache_misses"] = cache_misses_.load();
+    stats["bin_name"] = bin_name_;
+    return stats;
+  }
+
   signal_t ShellCompiler::get_function(const std::string& symname) {
     signal_t ret;
     ret = reinterpret_cast<signal_t>(dlsym(handle_, symname.c_str()));
@@ -28,6 +28,7 @@
 
 #include "casadi/core/function/importer_internal.hpp"
 #include <casadi/solvers/importer/casadi_importer_shell_export.h>
+#include <atomic>
 
 /** \defgroup plugin_Importer_shell
       Interface to the JIT compiler SHELL
@@ -77,10 +78,29 @@ namespace casadi {
 
     /// Get a function pointer for numerical evaluation
     virtual signal_t get_function(const std::string& symname);
+
+    /// Get statistics
+    virtual Dict get_stats() const;
+
+    /// Compile several source files in parallel and link them into bin_name_
+    void compile_parallel(const std::string& cmd, const std::vector<std::string>& sources,
+                          int num_threads) const;
   protected:
     /// Temporary file
     std::string bin_name_;
 
+    /// Name of the binary in the compilation cache
+    std::string cache_name_;
+
+    /// Is the binary stored in the compilation cache
+    bool cached_;
+
+    /// Was the binary found in the compilation cache
+    bool cache_hit_;
+
+    /// Compilation cache hits and misses in this process
+    static std::atomic<int> cache_hits_, cache_misses_;
+
     // Shared library handle
     typedef void* handle_t;
     handle_t handle_;
@@ -333,4 +333,25 @@ namespace casadi {
     }
   }
 
+  void Collocation::generateReset(CodeGenerator& g, const std::string& Z,
+                                  const std::string& x, const std::string& z) const {
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    for (int d=0; d<deg_; ++d) {
+      g.body << "  copy(" << x << ", " << nx_ << ", " << Z << "+" << d*(nx_+nz_) << ");" << endl
+             << "  copy(" << z << ", " << nz_ << ", " << Z << "+" << d*(nx_+nz_)+nx_ << ");"
+             << endl;
+    }
+  }
+
+  void Collocation::generateResetB(CodeGenerator& g, const std::string& RZ,
+                                   const std::string& rx, const std::string& rz) const {
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    for (int d=0; d<deg_; ++d) {
+      g.body << "  copy(" << rx << ", " << nrx_ << ", " << RZ << "+" << d*(nrx_+nrz_) << ");"
+             << endl
+             << "  copy(" << rz << ", " << nrz_ << ", " << RZ << "+" << d*(nrx_+nrz_)+nrx_
+             << ");" << endl;
+    }
+  }
+
 } // namespace casadi
@@ -94,6 +94,14 @@ namespace casadi {
     virtual void resetB(IntegratorMemory* mem, double t, const double* rx,
                         const double* rz, const double* rp) const;
 
+    /// Generate code for the initial guess of Z
+    virtual void generateReset(CodeGenerator& g, const std::string& Z,
+                               const std::string& x, const std::string& z) const;
+
+    /// Generate code for the initial guess of RZ
+    virtual void generateResetB(CodeGenerator& g, const std::string& RZ,
+                                const std::string& rx, const std::string& rz) const;
+
     // Interpolation order
     int deg_;
 
@@ -0,0 +1,266 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bspline_interpolant.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTERPOLANT_BSPLINE_EXPORT
+  casadi_register_interpolant_bspline(Interpolant::Plugin* plugin) {
+    plugin->creator = BSplineInterpolant::creator;
+    plugin->name = "bspline";
+    plugin->doc = BSplineInterpolant::meta_doc.c_str();
+    plugin->version = 31;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTERPOLANT_BSPLINE_EXPORT casadi_load_interpolant_bspline() {
+    Interpolant::registerPlugin(casadi_register_interpolant_bspline);
+  }
+
+  BSplineInterpolant::
+  BSplineInterpolant(const string& name,
+                     const std::vector<double>& grid,
+                     const std::vector<int>& offset,
+                     const vector<double>& values)
+                     : Interpolant(name, grid, offset, values) {
+  }
+
+  BSplineInterpolant::~BSplineInterpolant() {
+  }
+
+  void BSplineInterpolant::init(const Dict& opts) {
+    // Call the base class initializer
+    Interpolant::init(opts);
+
+    // Knots with not-a-knot end conditions: the second and second to last
+    // grid points are not knots for a cubic spline
+    knots_.clear();
+    koffset_.resize(ndim_+1);
+    koffset_[0] = 0;
+    for (int i=0; i<ndim_; ++i) {
+      const double* g = get_ptr(grid_) + offset_[i];
+      int ng = offset_[i+1]-offset_[i];
+      int k = std::min(3, ng-1);
+      knots_.insert(knots_.end(), k+1, g[0]);
+      if (k==3) knots_.insert(knots_.end(), g+2, g+ng-2);
+      knots_.insert(knots_.end(), k+1, g[ng-1]);
+      koffset_[i+1] = knots_.size();
+    }
+
+    // Interpolation conditions, one dimension at a time
+    coeff_ = values_;
+    int ld = 1;
+    for (int i=0; i<ndim_; ++i) {
+      const double* g = get_ptr(grid_) + offset_[i];
+      const double* t = get_ptr(knots_) + koffset_[i];
+      int ng = offset_[i+1]-offset_[i];
+      int k = koffset_[i+1]-koffset_[i]-ng-1;
+
+      // Collocation matrix, banded with bandwidth k, row-major
+      int nb = 2*k+1;
+      vector<double> a(ng*nb, 0), b(k+1);
+      for (int r=0; r<ng; ++r) {
+        int s = casadi_low(g[r], g, ng, 2) + 2;
+        s = std::max(k, std::min(s, ng-1));
+        casadi_bspline_basis(g[r], t, s, k, 0, get_ptr(b));
+        for (int j=0; j<=k; ++j) a[r*nb + s-k+j-r+k] = b[j];
+      }
+
+      // LU factorization without pivoting, stable since the collocation
+      // matrix of a B-spline basis is totally positive
+      for (int c=0; c<ng; ++c) {
+        double p = a[c*nb + k];
+        casadi_assert_message(p!=0, "BSplineInterpolant: Singular collocation matrix");
+        for (int r=c+1; r<=std::min(c+k, ng-1); ++r) {
+          double l = a[r*nb + c-r+k] /= p;
+          if (l==0) continue;
+          for (int j=c+1; j<=std::min(c+k, ng-1); ++j) a[r*nb + j-r+k] -= l*a[c*nb + j-c+k];
+        }
+      }
+
+      // Solve for every fiber of the coefficient tensor in this dimension
+      int nfiber = coeff_.size()/ng;
+      for (int f=0; f<nfiber; ++f) {
+        double* x = get_ptr(coeff_) + (f%ld) + (f/ld)*ld*ng;
+        for (int r=1; r<ng; ++r) {
+          for (int c=std::max(0, r-k); c<r; ++c) x[r*ld] -= a[r*nb + c-r+k]*x[c*ld];
+        }
+        for (int r=ng-1; r>=0; --r) {
+          for (int c=r+1; c<=std::min(r+k, ng-1); ++c) x[r*ld] -= a[r*nb + c-r+k]*x[c*ld];
+          x[r*ld] /= a[r*nb + k];
+        }
+      }
+      ld *= ng;
+    }
+
+    // Needed by casadi_bspline
+    alloc_w(12*ndim_, true);
+    alloc_iw(3*ndim_, true);
+  }
+
+  void BSplineInterpolant::eval_nder(const double* x, double* r, int nder,
+                                     int* iw, double* w) const {
+    if (!r) return;
+    int nr = nder==0 ? 1 : nder==1 ? ndim_ : ndim_*ndim_;
+    for (int i=0; i<batch_x_; ++i) {
+      casadi_bspline(ndim_, get_ptr(grid_), get_ptr(offset_), get_ptr(knots_),
+                     get_ptr(koffset_), get_ptr(coeff_), x ? x+i*ndim_ : 0,
+                     get_ptr(lookup_mode_), nder, r+i*nr, iw, w);
+    }
+  }
+
+  void BSplineInterpolant::generate_nder(CodeGenerator& g, int nder) const {
+    int nr = nder==0 ? 1 : nder==1 ? ndim_ : ndim_*ndim_;
+    g.addAuxiliary(CodeGenerator::AUX_BSPLINE);
+    g.body << "  int i;" << endl
+           << "  if (res[0]) {" << endl
+           << "    for (i=0; i<" << batch_x_ << "; ++i) {" << endl
+           << "      bspline(" << ndim_ << ", "
+           << "c" << g.getConstant(grid_, true) << ", "
+           << "s" << g.getConstant(offset_, true) << ", "
+           << "c" << g.getConstant(knots_, true) << ", "
+           << "s" << g.getConstant(koffset_, true) << ", "
+           << "c" << g.getConstant(coeff_, true) << ", "
+           << "arg[0] ? arg[0]+i*" << ndim_ << " : 0, "
+           << "s" << g.getConstant(lookup_mode_, true) << ", "
+           << nder << ", res[0]+i*" << nr << ", iw, w);" << endl
+           << "    }" << endl
+           << "  }" << endl;
+  }
+
+  void BSplineInterpolant::eval(void* mem, const double** arg, double** res,
+                                int* iw, double* w) const {
+    eval_nder(arg[0], res[0], 0, iw, w);
+  }
+
+  void BSplineInterpolant::generateBody(CodeGenerator& g) const {
+    generate_nder(g, 0);
+  }
+
+  Function BSplineInterpolant::
+  getFullJacobian(const std::string& name, const Dict& opts) {
+    Function ret;
+    ret.assignNode(new BSplineInterpolantJac(name));
+    ret->construct(opts);
+    return ret;
+  }
+
+  void BSplineInterpolantJac::init(const Dict& opts) {
+    // Call the base class initializer
+    FunctionInternal::init(opts);
+
+    // Needed by casadi_bspline
+    auto m = derivative_of_.get<BSplineInterpolant>();
+    alloc_w(12*m->ndim_, true);
+    alloc_iw(3*m->ndim_, true);
+  }
+
+  Sparsity BSplineInterpolantJac::get_sparsity_out(int i) {
+    auto m = derivative_of_.get<BSplineInterpolant>();
+    return Sparsity::kron(Sparsity::diag(m->batch_x_), Sparsity::dense(1, m->ndim_));
+  }
+
+  void BSplineInterpolantJac::
+  sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = derivative_of_.get<BSplineInterpolant>();
+    Interpolant::sp_fwd_batch(m->batch_x_, m->ndim_, m->ndim_, arg[0], res[0]);
+  }
+
+  void BSplineInterpolantJac::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = derivative_of_.get<BSplineInterpolant>();
+    Interpolant::sp_rev_batch(m->batch_x_, m->ndim_, m->ndim_, arg[0], res[0]);
+  }
+
+  void BSplineInterpolantJac::eval(void* mem, const double** arg, double** res,
+                                   int* iw, double* w) const {
+    derivative_of_.get<BSplineInterpolant>()->eval_nder(arg[0], res[0], 1, iw, w);
+  }
+
+  void BSplineInterpolantJac::generateBody(CodeGenerator& g) const {
+    derivative_of_.get<BSplineInterpolant>()->generate_nder(g, 1);
+  }
+
+  Function BSplineInterpolantJac::
+  getFullJacobian(const std::string& name, const Dict& opts) {
+    Function ret;
+    ret.assignNode(new BSplineInterpolantHess(name));
+    ret->construct(opts);
+    return ret;
+  }
+
+  const BSplineInterpolant* BSplineInterpolantHess::interpolant() const {
+    return derivative_of_.get<BSplineInterpolantJac>()->derivative_of_.get<BSplineInterpolant>();
+  }
+
+  void BSplineInterpolantHess::init(const Dict& opts) {
+    // Call the base class initializer
+    FunctionInternal::init(opts);
+
+    // Needed by casadi_bspline
+    alloc_w(12*interpolant()->ndim_, true);
+    alloc_iw(3*interpolant()->ndim_, true);
+  }
+
+  Sparsity BSplineInterpolantHess::get_sparsity_out(int i) {
+    // Rows correspond to all entries of the (sparse) first order Jacobian
+    auto m = interpolant();
+    int nb = m->batch_x_, nd = m->ndim_;
+    vector<int> row, col;
+    for (int j=0; j<nb; ++j) {
+      for (int e=0; e<nd; ++e) {
+        for (int d=0; d<nd; ++d) {
+          row.push_back((j*nd+d)*nb + j);
+          col.push_back(j*nd+e);
+        }
+      }
+    }
+    return Sparsity::triplet(nb*nb*nd, nb*nd, row, col);
+  }
+
+  void BSplineInterpolantHess::
+  sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = interpolant();
+    Interpolant::sp_fwd_batch(m->batch_x_, m->ndim_, m->ndim_*m->ndim_, arg[0], res[0]);
+  }
+
+  void BSplineInterpolantHess::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = interpolant();
+    Interpolant::sp_rev_batch(m->batch_x_, m->ndim_, m->ndim_*m->ndim_, arg[0], res[0]);
+  }
+
+  void BSplineInterpolantHess::eval(void* mem, const double** arg, double** res,
+                                    int* iw, double* w) const {
+    interpolant()->eval_nder(arg[0], res[0], 2, iw, w);
+  }
+
+  void BSplineInterpolantHess::generateBody(CodeGenerator& g) const {
+    interpolant()->generate_nder(g, 2);
+  }
+
+} // namespace casadi
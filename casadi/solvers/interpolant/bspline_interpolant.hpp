@@ -0,0 +1,187 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef CASADI_BSPLINE_INTERPOLANT_HPP
+#define CASADI_BSPLINE_INTERPOLANT_HPP
+
+#include "casadi/core/function/interpolant_impl.hpp"
+#include <casadi/solvers/interpolant/casadi_interpolant_bspline_export.h>
+
+/** \defgroup plugin_Interpolant_bspline
+*/
+
+/** \pluginsection{Interpolant,bspline} */
+
+/// \cond INTERNAL
+
+namespace casadi {
+  /** \brief \pluginbrief{Interpolant,bspline}
+    Implements a tensor product cubic B-spline interpolant with not-a-knot end
+    conditions. The spline passes through the values at the grid points and is
+    twice continuously differentiable. Dimensions with fewer than four grid
+    points use the highest degree the grid permits.
+
+    @copydoc Interpolant_doc
+    @copydoc plugin_Interpolant_bspline
+    \author Joel Andersson
+    \date 2016
+  */
+  class CASADI_INTERPOLANT_BSPLINE_EXPORT BSplineInterpolant : public Interpolant {
+  public:
+    // Constructor
+    BSplineInterpolant(const std::string& name,
+                       const std::vector<double>& grid,
+                       const std::vector<int>& offset,
+                       const std::vector<double>& values);
+
+    // Destructor
+    virtual ~BSplineInterpolant();
+
+    // Get name of the plugin
+    virtual const char* plugin_name() const { return "bspline";}
+
+    /** \brief  Create a new Interpolant */
+    static Interpolant* creator(const std::string& name,
+                                const std::vector<double>& grid,
+                                const std::vector<int>& offset,
+                                const std::vector<double>& values) {
+      return new BSplineInterpolant(name, grid, offset, values);
+    }
+
+    // Initialize
+    virtual void init(const Dict& opts);
+
+    /// Evaluate numerically
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
+    ///@{
+    /** \brief Full Jacobian */
+    virtual bool hasFullJacobian() const { return true;}
+    virtual Function getFullJacobian(const std::string& name, const Dict& opts);
+    ///@}
+
+    /// Value (nder=0), gradient (nder=1) or Hessian (nder=2) at each point
+    void eval_nder(const double* x, double* r, int nder, int* iw, double* w) const;
+
+    /// Generate code for eval_nder
+    void generate_nder(CodeGenerator& g, int nder) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Knots for each dimension
+    std::vector<double> knots_;
+
+    // Offset for the knots of each dimension
+    std::vector<int> koffset_;
+
+    // B-spline coefficients, same layout as the values
+    std::vector<double> coeff_;
+  };
+
+  /** First order derivatives */
+  class CASADI_INTERPOLANT_BSPLINE_EXPORT BSplineInterpolantJac : public FunctionInternal {
+  public:
+    /// Constructor
+    BSplineInterpolantJac(const std::string& name) : FunctionInternal(name) {}
+
+    /// Destructor
+    virtual ~BSplineInterpolantJac() {}
+
+    // Initialize
+    virtual void init(const Dict& opts);
+
+    /// Block diagonal Jacobian when several points are evaluated per call
+    virtual Sparsity get_sparsity_out(int i);
+
+    ///@{
+    /** \brief Sparsity propagation */
+    virtual bool has_spfwd() const { return true;}
+    virtual bool has_sprev() const { return true;}
+    virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    virtual void sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    ///@}
+
+    /// Evaluate numerically
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
+    ///@{
+    /** \brief Full Jacobian */
+    virtual bool hasFullJacobian() const { return true;}
+    virtual Function getFullJacobian(const std::string& name, const Dict& opts);
+    ///@}
+  };
+
+  /** Second order derivatives */
+  class CASADI_INTERPOLANT_BSPLINE_EXPORT BSplineInterpolantHess : public FunctionInternal {
+  public:
+    /// Constructor
+    BSplineInterpolantHess(const std::string& name) : FunctionInternal(name) {}
+
+    /// Destructor
+    virtual ~BSplineInterpolantHess() {}
+
+    // Initialize
+    virtual void init(const Dict& opts);
+
+    /// Hessian blocks for each point evaluated per call
+    virtual Sparsity get_sparsity_out(int i);
+
+    ///@{
+    /** \brief Sparsity propagation */
+    virtual bool has_spfwd() const { return true;}
+    virtual bool has_sprev() const { return true;}
+    virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    virtual void sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    ///@}
+
+    /// Evaluate numerically
+    virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
+    /// The interpolant being differentiated
+    const BSplineInterpolant* interpolant() const;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_BSPLINE_INTERPOLANT_HPP
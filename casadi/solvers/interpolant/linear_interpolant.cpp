@@ -66,11 +66,29 @@ namespace casadi {
   void LinearInterpolant::eval(void* mem, const double** arg, double** res,
                                int* iw, double* w) const {
     if (res[0]) {
-      res[0][0] = casadi_interpn(ndim_, get_ptr(grid_), get_ptr(offset_),
-                                 get_ptr(values_), arg[0], iw, w);
+      for (int i=0; i<batch_x_; ++i) {
+        res[0][i] = casadi_interpn(ndim_, get_ptr(grid_), get_ptr(offset_),
+                                   get_ptr(values_), arg[0] ? arg[0]+i*ndim_ : 0,
+                                   get_ptr(lookup_mode_), iw, w);
+      }
     }
   }
 
+  void LinearInterpolant::generateBody(CodeGenerator& g) const {
+    g.addAuxiliary(CodeGenerator::AUX_INTERPN);
+    g.body << "  int i;" << endl
+           << "  if (res[0]) {" << endl
+           << "    for (i=0; i<" << batch_x_ << "; ++i) {" << endl
+           << "      res[0][i] = interpn(" << ndim_ << ", "
+           << "c" << g.getConstant(grid_, true) << ", "
+           << "s" << g.getConstant(offset_, true) << ", "
+           << "c" << g.getConstant(values_, true) << ", "
+           << "arg[0] ? arg[0]+i*" << ndim_ << " : 0, "
+           << "s" << g.getConstant(lookup_mode_, true) << ", iw, w);" << endl
+           << "    }" << endl
+           << "  }" << endl;
+  }
+
   Function LinearInterpolant::
   getFullJacobian(const std::string& name, const Dict& opts) {
     Function ret;
@@ -89,11 +107,47 @@ namespace casadi {
     alloc_iw(2*m->ndim_, true);
   }
 
+  Sparsity LinearInterpolantJac::get_sparsity_out(int i) {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    return Sparsity::kron(Sparsity::diag(m->batch_x_), Sparsity::dense(1, m->ndim_));
+  }
+
+  void LinearInterpolantJac::sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    Interpolant::sp_fwd_batch(m->batch_x_, m->ndim_, m->ndim_, arg[0], res[0]);
+  }
+
+  void LinearInterpolantJac::sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    Interpolant::sp_rev_batch(m->batch_x_, m->ndim_, m->ndim_, arg[0], res[0]);
+  }
+
   void LinearInterpolantJac::eval(void* mem, const double** arg, double** res,
                                int* iw, double* w) const {
     auto m = derivative_of_.get<LinearInterpolant>();
-    casadi_interpn_grad(res[0], m->ndim_, get_ptr(m->grid_), get_ptr(m->offset_),
-                        get_ptr(m->values_), arg[0], iw, w);
+    if (res[0]) {
+      for (int i=0; i<m->batch_x_; ++i) {
+        casadi_interpn_grad(res[0]+i*m->ndim_, m->ndim_, get_ptr(m->grid_), get_ptr(m->offset_),
+                            get_ptr(m->values_), arg[0] ? arg[0]+i*m->ndim_ : 0,
+                            get_ptr(m->lookup_mode_), iw, w);
+      }
+    }
+  }
+
+  void LinearInterpolantJac::generateBody(CodeGenerator& g) const {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    g.addAuxiliary(CodeGenerator::AUX_INTERPN_GRAD);
+    g.body << "  int i;" << endl
+           << "  if (res[0]) {" << endl
+           << "    for (i=0; i<" << m->batch_x_ << "; ++i) {" << endl
+           << "      interpn_grad(res[0]+i*" << m->ndim_ << ", " << m->ndim_ << ", "
+           << "c" << g.getConstant(m->grid_, true) << ", "
+           << "s" << g.getConstant(m->offset_, true) << ", "
+           << "c" << g.getConstant(m->values_, true) << ", "
+           << "arg[0] ? arg[0]+i*" << m->ndim_ << " : 0, "
+           << "s" << g.getConstant(m->lookup_mode_, true) << ", iw, w);" << endl
+           << "    }" << endl
+           << "  }" << endl;
   }
 
 } // namespace casadi
@@ -74,6 +74,12 @@ namespace casadi {
     /// Evaluate numerically
     virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
 
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
     ///@{
     /** \brief Full Jacobian */
     virtual bool hasFullJacobian() const { return true;}
@@ -96,8 +102,25 @@ namespace casadi {
     // Initialize
     virtual void init(const Dict& opts);
 
+    /// Block diagonal Jacobian when several points are evaluated per call
+    virtual Sparsity get_sparsity_out(int i);
+
+    ///@{
+    /** \brief Sparsity propagation */
+    virtual bool has_spfwd() const { return true;}
+    virtual bool has_sprev() const { return true;}
+    virtual void sp_fwd(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    virtual void sp_rev(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem);
+    ///@}
+
     /// Evaluate numerically
     virtual void eval(void* mem, const double** arg, double** res, int* iw, double* w) const;
+
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
   };
 
 } // namespace casadi
@@ -0,0 +1,410 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "ldl.hpp"
+#include "casadi/core/sparsity_internal.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_LINSOL_LDL_EXPORT
+  casadi_register_linsol_ldl(LinsolInternal::Plugin* plugin) {
+    plugin->creator = Ldl::creator;
+    plugin->name = "ldl";
+    plugin->doc = Ldl::meta_doc.c_str();
+    plugin->version = 31;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_LINSOL_LDL_EXPORT casadi_load_linsol_ldl() {
+    LinsolInternal::registerPlugin(casadi_register_linsol_ldl);
+  }
+
+  Ldl::Ldl(const std::string& name) :
+    LinsolInternal(name) {
+  }
+
+  Ldl::~Ldl() {
+    clear_memory();
+  }
+
+  Options Ldl::options_
+  = {{&FunctionInternal::options_},
+     {{"amd",
+       {OT_BOOL,
+        "Use an approximate minimum degree ordering [true]"}},
+      {"max_supernode",
+       {OT_INT,
+        "Maximum number of columns in a supernode [128]"}}
+     }
+  };
+
+  void Ldl::init(const Dict& opts) {
+    // Call the base class initializer
+    LinsolInternal::init(opts);
+
+    // Default options
+    amd_ = true;
+    max_supernode_ = 128;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="amd") {
+        amd_ = op.second;
+      } else if (op.first=="max_supernode") {
+        max_supernode_ = op.second;
+      }
+    }
+
+    casadi_assert_message(max_supernode_>=1, "Option \"max_supernode\" must be positive");
+  }
+
+  void Ldl::init_memory(void* mem) const {
+    LinsolInternal::init_memory(mem);
+  }
+
+  void Ldl::reset(void* mem, const int* sp) const {
+    LinsolInternal::reset(mem, sp);
+    auto m = static_cast<LdlMemory*>(mem);
+    casadi_assert_message(m->nrow()==m->ncol(), "Ldl: Matrix must be square");
+    casadi_assert_message(Sparsity::compressed(m->sparsity).is_symmetric(),
+                          "Ldl: Sparsity pattern must be symmetric");
+
+    // Reuse the symbolic analysis if another memory block uses the same pattern
+    m->sym.reset();
+    {
+      std::lock_guard<std::mutex> lock(sym_mtx_);
+      for (auto&& s : sym_cache_) {
+        auto sym = s.lock();
+        if (sym && sym->sparsity==m->sparsity) {
+          m->sym = sym;
+          break;
+        }
+      }
+    }
+
+    // Otherwise analyze and store, dropping analyses no longer in use
+    if (!m->sym) {
+      m->sym = analyze(m);
+      std::lock_guard<std::mutex> lock(sym_mtx_);
+      sym_cache_.erase(remove_if(sym_cache_.begin(), sym_cache_.end(),
+                                 [](const std::weak_ptr<const LdlSymbolic>& s) {
+                                   return s.expired();}),
+                       sym_cache_.end());
+      sym_cache_.push_back(m->sym);
+    }
+
+    // Allocate numeric work
+    const LdlSymbolic& s = *m->sym;
+    int n = m->ncol();
+    int nsn = s.sn_col.size()-1;
+    m->lx.resize(s.sn_off.back());
+    m->d.resize(n);
+    m->iw.resize(3*nsn + n);
+    m->w.resize(s.max_row*s.max_col + s.max_col*s.max_col + n);
+  }
+
+  std::shared_ptr<const LdlSymbolic> Ldl::analyze(const LdlMemory* m) const {
+    auto ret = std::make_shared<LdlSymbolic>();
+    LdlSymbolic& s = *ret;
+    s.sparsity = m->sparsity;
+    int n = m->ncol();
+    const int* colind = m->colind();
+    const int* row = m->row();
+    int nnz = m->nnz();
+
+    // Fill-reducing ordering and pattern of L', shared with the generated code
+    Sparsity lt = Sparsity::compressed(m->sparsity).ldl(s.perm, amd_);
+    s.iperm.resize(n);
+    for (int k=0; k<n; ++k) s.iperm[s.perm[k]] = k;
+
+    // Row patterns of the factor are the columns of L'
+    const int* l_rowind = lt.colind();
+    const int* l_col = lt.row();
+
+    // Elimination tree and column counts, including the diagonal
+    vector<int> parent(n, -1), cnt(n, 1);
+    for (int k=0; k<n; ++k) {
+      for (int p=l_rowind[k]; p<l_rowind[k+1]; ++p) {
+        int i = l_col[p];
+        if (parent[i]==-1) parent[i] = k;
+        cnt[i]++;
+      }
+    }
+
+    // Fundamental supernodes: a column joins its child if their patterns are nested
+    s.col2sn.resize(n);
+    s.sn_col.clear();
+    for (int j=0; j<n; ++j) {
+      if (j==0 || parent[j-1]!=j || cnt[j-1]!=cnt[j]+1 || j-s.sn_col.back()>=max_supernode_) {
+        s.sn_col.push_back(j);
+      }
+      s.col2sn[j] = s.sn_col.size()-1;
+    }
+    s.sn_col.push_back(n);
+    int nsn = s.sn_col.size()-1;
+
+    // Rows of each supernode, given by the pattern of its first column
+    s.sn_rowind.resize(nsn+1);
+    s.sn_off.resize(nsn+1);
+    s.sn_rowind[0] = s.sn_off[0] = 0;
+    s.max_row = s.max_col = 0;
+    for (int sn=0; sn<nsn; ++sn) {
+      int nr = cnt[s.sn_col[sn]], nc = s.sn_col[sn+1]-s.sn_col[sn];
+      s.sn_rowind[sn+1] = s.sn_rowind[sn] + nr;
+      s.sn_off[sn+1] = s.sn_off[sn] + nr*nc;
+      s.max_row = max(s.max_row, nr);
+      s.max_col = max(s.max_col, nc);
+    }
+    s.sn_row.resize(s.sn_rowind.back());
+    vector<int> sn_next(s.sn_rowind.begin(), s.sn_rowind.end()-1);
+    for (int k=0; k<n; ++k) {
+      // Row k appears in the columns of the row pattern and in column k itself
+      for (int p=l_rowind[k]; p<l_rowind[k+1]; ++p) {
+        int i = l_col[p];
+        if (s.sn_col[s.col2sn[i]]==i) s.sn_row[sn_next[s.col2sn[i]]++] = k;
+      }
+      if (s.sn_col[s.col2sn[k]]==k) s.sn_row[sn_next[s.col2sn[k]]++] = k;
+    }
+
+    // Location of the entries of A in the factor, the lower triangle of A takes precedence
+    s.a2l.resize(nnz);
+    vector<bool> used(s.sn_off.back(), false);
+    for (int pass=0; pass<2; ++pass) {
+      for (int c=0; c<n; ++c) {
+        for (int k=colind[c]; k<colind[c+1]; ++k) {
+          if ((row[k]>=c) != (pass==0)) continue;
+          int i = s.iperm[row[k]], j = s.iperm[c];
+          if (i<j) swap(i, j);
+          int sn = s.col2sn[j];
+          const int* r_begin = get_ptr(s.sn_row) + s.sn_rowind[sn];
+          const int* r_end = get_ptr(s.sn_row) + s.sn_rowind[sn+1];
+          int nr = r_end - r_begin;
+          int loc = s.sn_off[sn] + (j-s.sn_col[sn])*nr + (lower_bound(r_begin, r_end, i)-r_begin);
+          if (used[loc]) {
+            s.a2l[k] = -1;
+          } else {
+            s.a2l[k] = loc;
+            used[loc] = true;
+          }
+        }
+      }
+    }
+
+    casadi_msg("Ldl: " << nsn << " supernodes for " << n << " columns, "
+               << s.sn_off.back() << " nonzeros in factor");
+    return ret;
+  }
+
+  void Ldl::factorize(void* mem, const double* A) const {
+    auto m = static_cast<LdlMemory*>(mem);
+    casadi_assert(m->sym!=0);
+    const LdlSymbolic& s = *m->sym;
+    int n = m->ncol();
+    int nsn = s.sn_col.size()-1;
+    double* lx = get_ptr(m->lx);
+    double* d = get_ptr(m->d);
+
+    // Scatter the nonzeros of A
+    fill(m->lx.begin(), m->lx.end(), 0);
+    for (int k=0; k<s.a2l.size(); ++k) {
+      if (s.a2l[k]>=0) lx[s.a2l[k]] = A[k];
+    }
+
+    // Supernodes waiting to update a supernode, as linked lists
+    int* head = get_ptr(m->iw);
+    int* next = head + nsn;
+    int* nextpos = next + nsn;
+    int* map = nextpos + nsn;
+    fill(head, head+nsn, -1);
+
+    // Update block and scaled descendant rows
+    double* upd = get_ptr(m->w);
+    double* ld = upd + s.max_row*s.max_col;
+
+    // Left-looking supernodal factorization
+    for (int sn=0; sn<nsn; ++sn) {
+      int f = s.sn_col[sn], nc = s.sn_col[sn+1]-f;
+      const int* rows = get_ptr(s.sn_row) + s.sn_rowind[sn];
+      int nr = s.sn_rowind[sn+1]-s.sn_rowind[sn];
+      double* L = lx + s.sn_off[sn];
+
+      // Local row indices
+      for (int q=0; q<nr; ++q) map[rows[q]] = q;
+
+      // Apply the updates from all descendants with a row in this supernode
+      for (int dsn=head[sn], dnext; dsn!=-1; dsn=dnext) {
+        dnext = next[dsn];
+        int df = s.sn_col[dsn], dnc = s.sn_col[dsn+1]-df;
+        const int* drows = get_ptr(s.sn_row) + s.sn_rowind[dsn];
+        int dnr = s.sn_rowind[dsn+1]-s.sn_rowind[dsn];
+        const double* dL = lx + s.sn_off[dsn];
+
+        // Descendant rows in [f, f+nc) and in [f, n)
+        int p0 = nextpos[dsn], p1 = p0;
+        while (p1<dnr && drows[p1]<f+nc) p1++;
+        int m1 = p1-p0, m2 = dnr-p0;
+
+        // Update = L_d(p0:, :) * D_d * L_d(p0:p1, :)^T, lower part only
+        for (int c=0; c<dnc; ++c) {
+          for (int jj=0; jj<m1; ++jj) ld[jj+c*m1] = dL[p0+jj+c*dnr]*d[df+c];
+        }
+        gemm_nt(m2, m1, dnc, dL+p0, dnr, ld, m1, upd, m2);
+
+        // Scatter into the supernode
+        for (int jj=0; jj<m1; ++jj) {
+          double* Lc = L + (drows[p0+jj]-f)*nr;
+          for (int i=jj; i<m2; ++i) Lc[map[drows[p0+i]]] -= upd[i+jj*m2];
+        }
+
+        // Move on to the next supernode that the descendant updates
+        if (p1<dnr) {
+          int t = s.col2sn[drows[p1]];
+          nextpos[dsn] = p1;
+          next[dsn] = head[t];
+          head[t] = dsn;
+        }
+      }
+
+      // Dense LDL^T factorization of the supernode
+      for (int j=0; j<nc; ++j) {
+        double* Lj = L + j*nr;
+        for (int c=0; c<j; ++c) {
+          const double* Lc = L + c*nr;
+          double t = Lc[j]*d[f+c];
+          for (int q=j; q<nr; ++q) Lj[q] -= Lc[q]*t;
+        }
+        double dj = Lj[j];
+        casadi_assert_message(dj!=0, "Ldl: Zero pivot encountered in column " << s.perm[f+j]
+                              << ", matrix is singular or requires pivoting");
+        d[f+j] = dj;
+        Lj[j] = 1;
+        for (int q=j+1; q<nr; ++q) Lj[q] /= dj;
+      }
+
+      // Register for the first supernode outside of the diagonal block
+      if (nc<nr) {
+        int t = s.col2sn[rows[nc]];
+        nextpos[sn] = nc;
+        next[sn] = head[t];
+        head[t] = sn;
+      }
+    }
+  }
+
+  void Ldl::gemm_nt(int m, int n, int k, const double* A, int lda,
+                    const double* B, int ldb, double* C, int ldc) {
+    // Block size, chosen so that a block of C stays in cache
+    const int bs = 64;
+    for (int j=0; j<n; ++j) fill_n(C+j*ldc, m, 0);
+
+    // C = A*B^T, lower triangular part, blocked over rows and the inner dimension
+    for (int i0=0; i0<m; i0+=bs) {
+      int i1 = min(i0+bs, m);
+      for (int c0=0; c0<k; c0+=bs) {
+        int c1 = min(c0+bs, k);
+        for (int j=0; j<n && j<i1; ++j) {
+          double* Cj = C + j*ldc;
+          for (int c=c0; c<c1; ++c) {
+            double b = B[j+c*ldb];
+            if (b==0) continue;
+            const double* Ac = A + c*lda;
+            for (int i=max(i0, j); i<i1; ++i) Cj[i] += Ac[i]*b;
+          }
+        }
+      }
+    }
+  }
+
+  void Ldl::solve(void* mem, double* x, int nrhs, bool tr) const {
+    auto m = static_cast<LdlMemory*>(mem);
+    casadi_assert(m->sym!=0);
+    const LdlSymbolic& s = *m->sym;
+    int n = m->ncol();
+    int nsn = s.sn_col.size()-1;
+    const double* lx = get_ptr(m->lx);
+    const double* d = get_ptr(m->d);
+    double* t = get_ptr(m->w) + s.max_row*s.max_col + s.max_col*s.max_col;
+
+    // Only the lower triangle of A is used, so A is symmetric and tr has no effect
+    for (int r=0; r<nrhs; ++r) {
+      // Permute the right hand side
+      for (int i=0; i<n; ++i) t[i] = x[s.perm[i]];
+
+      // Solve L*y = b
+      for (int sn=0; sn<nsn; ++sn) {
+        int f = s.sn_col[sn], nc = s.sn_col[sn+1]-f;
+        const int* rows = get_ptr(s.sn_row) + s.sn_rowind[sn];
+        int nr = s.sn_rowind[sn+1]-s.sn_rowind[sn];
+        const double* L = lx + s.sn_off[sn];
+        for (int j=0; j<nc; ++j) {
+          double tj = t[f+j];
+          if (tj==0) continue;
+          const double* Lj = L + j*nr;
+          for (int q=j+1; q<nr; ++q) t[rows[q]] -= Lj[q]*tj;
+        }
+      }
+
+      // Solve D*z = y
+      for (int i=0; i<n; ++i) t[i] /= d[i];
+
+      // Solve L^T*x = z
+      for (int sn=nsn-1; sn>=0; --sn) {
+        int f = s.sn_col[sn], nc = s.sn_col[sn+1]-f;
+        const int* rows = get_ptr(s.sn_row) + s.sn_rowind[sn];
+        int nr = s.sn_rowind[sn+1]-s.sn_rowind[sn];
+        const double* L = lx + s.sn_off[sn];
+        for (int j=nc-1; j>=0; --j) {
+          const double* Lj = L + j*nr;
+          double tj = t[f+j];
+          for (int q=j+1; q<nr; ++q) tj -= Lj[q]*t[rows[q]];
+          t[f+j] = tj;
+        }
+      }
+
+      // Permute back
+      for (int i=0; i<n; ++i) x[s.perm[i]] = t[i];
+      x += n;
+    }
+  }
+
+  int Ldl::neig(void* mem) const {
+    auto m = static_cast<LdlMemory*>(mem);
+    int ret = 0;
+    for (double di : m->d) if (di<0) ret++;
+    return ret;
+  }
+
+  int Ldl::rank(void* mem) const {
+    auto m = static_cast<LdlMemory*>(mem);
+    int ret = 0;
+    for (double di : m->d) if (di!=0) ret++;
+    return ret;
+  }
+
+} // namespace casadi
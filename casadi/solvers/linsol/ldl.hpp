@@ -0,0 +1,174 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_LDL_HPP
+#define CASADI_LDL_HPP
+
+#include "casadi/core/function/linsol_internal.hpp"
+#include <casadi/solvers/linsol/casadi_linsol_ldl_export.h>
+#include <memory>
+#include <mutex>
+
+/** \defgroup plugin_Linsol_ldl
+
+       Linsol based on a supernodal LDL^T factorization _without_ pivoting,
+       with a fill-reducing approximate minimum degree ordering. The symbolic
+       analysis is reused as long as the sparsity pattern does not change.
+       Suitable for symmetric positive definite and quasi-definite systems,
+       e.g. regularized KKT systems. The sparsity pattern must be symmetric.
+       Only the lower triangular entries are used, so transposed solves are
+       the same as regular solves.
+*/
+
+/** \pluginsection{Linsol,ldl} */
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Symbolic analysis for Ldl, shared between memory blocks  */
+  struct CASADI_LINSOL_LDL_EXPORT LdlSymbolic {
+    // Sparsity pattern the analysis was made for
+    std::vector<int> sparsity;
+
+    // Fill-reducing permutation and its inverse
+    std::vector<int> perm, iperm;
+
+    // First column of each supernode (plus end)
+    std::vector<int> sn_col;
+
+    // Offsets into sn_row and the rows of each supernode, sorted
+    std::vector<int> sn_rowind, sn_row;
+
+    // Offsets into the factor nonzeros (column-major dense blocks)
+    std::vector<int> sn_off;
+
+    // Supernode containing each column
+    std::vector<int> col2sn;
+
+    // Position in the factor for each nonzero of A, -1 if not used
+    std::vector<int> a2l;
+
+    // Largest number of rows and columns in a supernode
+    int max_row, max_col;
+  };
+
+  /** \brief Memory for Ldl  */
+  struct CASADI_LINSOL_LDL_EXPORT LdlMemory : public LinsolMemory {
+    // Symbolic analysis for the current sparsity pattern
+    std::shared_ptr<const LdlSymbolic> sym;
+
+    // Nonzeros of the unit lower triangular factor
+    std::vector<double> lx;
+
+    // Diagonal D
+    std::vector<double> d;
+
+    // Work vectors
+    std::vector<int> iw;
+    std::vector<double> w;
+  };
+
+  /** \brief \pluginbrief{Linsol,ldl}
+
+      @copydoc Linsol_doc
+      @copydoc plugin_Linsol_ldl
+      \date 2016
+  */
+  class CASADI_LINSOL_LDL_EXPORT Ldl : public LinsolInternal {
+  public:
+    // Constructor
+    Ldl(const std::string& name);
+
+    // Destructor
+    virtual ~Ldl();
+
+    // Get name of the plugin
+    virtual const char* plugin_name() const { return "ldl";}
+
+    /** \brief  Create a new Linsol */
+    static LinsolInternal* creator(const std::string& name) {
+      return new Ldl(name);
+    }
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    virtual const Options& get_options() const { return options_;}
+    ///@}
+
+    // Initialize
+    virtual void init(const Dict& opts);
+
+    /** \brief Create memory block */
+    virtual void* alloc_memory() const { return new LdlMemory();}
+
+    /** \brief Free memory block */
+    virtual void free_memory(void *mem) const { delete static_cast<LdlMemory*>(mem);}
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
+
+    // Set sparsity pattern, symbolic analysis
+    virtual void reset(void* mem, const int* sp) const;
+
+    // Symbolic analysis: ordering, elimination tree and supernodes
+    std::shared_ptr<const LdlSymbolic> analyze(const LdlMemory* m) const;
+
+    // Factorize the linear system
+    virtual void factorize(void* mem, const double* A) const;
+
+    // Solve the linear system
+    virtual void solve(void* mem, double* x, int nrhs, bool tr) const;
+
+    /// Number of negative eigenvalues
+    virtual int neig(void* mem) const;
+
+    /// Matrix rank
+    virtual int rank(void* mem) const;
+
+    /// Blocked dense kernel: lower triangular part of C = A*B^T, C is m-by-n
+    static void gemm_nt(int m, int n, int k, const double* A, int lda,
+                        const double* B, int ldb, double* C, int ldc);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Use a fill-reducing ordering
+    bool amd_;
+
+    // Maximum number of columns in a supernode
+    int max_supernode_;
+
+    // Symbolic analyses of the memory blocks, shared if the patterns match
+    mutable std::vector<std::weak_ptr<const LdlSymbolic> > sym_cache_;
+    mutable std::mutex sym_mtx_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_LDL_HPP
@@ -0,0 +1,54 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "ldl.hpp"
+      #include <string>
+
+      const std::string casadi::Ldl::meta_doc=
+      "\n"
+"Linsol based on a supernodal LDL^T factorization without pivoting,\n"
+"with a fill-reducing approximate minimum degree ordering. The symbolic\n"
+"analysis is reused as long as the sparsity pattern does not change.\n"
+"Suitable for symmetric positive definite and quasi-definite systems,\n"
+"e.g. regularized KKT systems.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------+-----------------------------------------+\n"
+"|       Id        |   Type    |               Description               |\n"
+"+=================+===========+=========================================+\n"
+"| amd             | OT_BOOL   | Use an approximate minimum degree       |\n"
+"|                 |           | ordering [true]                         |\n"
+"+-----------------+-----------+-----------------------------------------+\n"
+"| max_supernode   | OT_INT    | Maximum number of columns in a          |\n"
+"|                 |           | supernode [128]                         |\n"
+"+-----------------+-----------+-----------------------------------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
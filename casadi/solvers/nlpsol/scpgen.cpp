@@ -715,6 +715,15 @@ namespace casadi {
 
     // Line-search memory
     m->merit_mem.resize(merit_memsize_);
+
+    // QP solver memory, not shared with other memory blocks
+    m->mem_qp = qpsol_.checkout();
+  }
+
+  void Scpgen::free_memory(void *mem) const {
+    auto m = static_cast<ScpgenMemory*>(mem);
+    qpsol_.release(m->mem_qp);
+    delete m;
   }
 
   void Scpgen::set_work(void* mem, const double**& arg, double**& res,
@@ -1196,7 +1205,7 @@ namespace casadi {
     m->res[CONIC_LAM_A] = m->dlam_gk; // Multipliers (linear bounds)
 
     // Solve the QP
-    qpsol_(m->arg, m->res, m->iw, m->w, 0);
+    qpsol_(m->arg, m->res, m->iw, m->w, m->mem_qp);
 
     // Calculate penalty parameter of merit function
     m->sigma = merit_start_;
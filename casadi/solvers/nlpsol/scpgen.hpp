@@ -78,6 +78,9 @@ namespace casadi {
     // QP solver
     double *qp_lbx, *qp_ubx, *qp_lba, *qp_uba;
 
+    // Memory object of the QP solver
+    int mem_qp;
+
     // Linesearch parameters
     std::vector<double> merit_mem;
     int merit_ind;
@@ -123,7 +126,7 @@ namespace casadi {
     virtual void* alloc_memory() const { return new ScpgenMemory();}
 
     /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<ScpgenMemory*>(mem);}
+    virtual void free_memory(void *mem) const;
 
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
@@ -279,6 +279,20 @@ namespace casadi {
     alloc_w(Asp_.nnz(), true); // Jk_
   }
 
+  void Sqpmethod::init_memory(void* mem) const {
+    Nlpsol::init_memory(mem);
+    auto m = static_cast<SqpmethodMemory*>(mem);
+
+    // QP solver memory, not shared with other memory blocks
+    m->mem_qp = qpsol_.checkout();
+  }
+
+  void Sqpmethod::free_memory(void *mem) const {
+    auto m = static_cast<SqpmethodMemory*>(mem);
+    qpsol_.release(m->mem_qp);
+    delete m;
+  }
+
   void Sqpmethod::set_work(void* mem, const double**& arg, double**& res,
                                 int*& iw, double*& w) const {
     auto m = static_cast<SqpmethodMemory*>(mem);
@@ -808,7 +822,281 @@ namespace casadi {
     m->res[CONIC_LAM_A] = lambda_A_opt;
 
     // Solve the QP
-    qpsol_(m->arg, m->res, m->iw, m->w, 0);
+    qpsol_(m->arg, m->res, m->iw, m->w, m->mem_qp);
+  }
+
+  // Indent a block of generated code by one more level
+  static string indent(const string& s) {
+    stringstream ss(s), ret;
+    string line;
+    while (getline(ss, line)) ret << "  " << line << endl;
+    return ret.str();
+  }
+
+  bool Sqpmethod::has_codegen() const {
+    if (!fcallback_.is_null() || !qpsol_->has_codegen()) return false;
+    if (!f_fcn_->has_codegen() || !grad_f_fcn_->has_codegen()) return false;
+    if (ng_>0 && (!g_fcn_->has_codegen() || !jac_g_fcn_->has_codegen())) return false;
+    return exact_hessian_ ? hess_l_fcn_->has_codegen() : bfgs_->has_codegen();
+  }
+
+  void Sqpmethod::generateDeclarations(CodeGenerator& g) const {
+    f_fcn_->addDependency(g);
+    grad_f_fcn_->addDependency(g);
+    if (ng_>0) {
+      g_fcn_->addDependency(g);
+      jac_g_fcn_->addDependency(g);
+    }
+    if (exact_hessian_) {
+      hess_l_fcn_->addDependency(g);
+    } else {
+      bfgs_->addDependency(g);
+    }
+    qpsol_->addDependency(g);
+  }
+
+  void Sqpmethod::generateBody(CodeGenerator& g) const {
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    g.addAuxiliary(CodeGenerator::AUX_FILL);
+    g.addAuxiliary(CodeGenerator::AUX_AXPY);
+    g.addAuxiliary(CodeGenerator::AUX_DOT);
+    g.addAuxiliary(CodeGenerator::AUX_MV);
+    g.addAuxiliary(CodeGenerator::AUX_NORM_INF);
+    g.addAuxiliary(CodeGenerator::AUX_MAX_VIOL);
+    string sp_h = g.sparsity(Hsp_), sp_a = g.sparsity(Asp_);
+    string p = "arg[" + to_string(NLPSOL_P) + "]";
+
+    // Bounds and merit function history are static work vectors,
+    // the rest of the work vector has the same layout as in set_work
+    string sw = g.static_work(2*nx_ + 2*ng_ + merit_memsize_);
+    g.body << "  int i, cc, el, iter, ls_iter, merit_n, merit_ind;" << endl
+           << "  real_t fk, fk_cand, sigma, t, pr_inf, du_inf, dx_norminf, l1_infeas, L1dir, "
+           << "L1merit, L1merit_cand, meritmax, reg, mineig, one=1.;" << endl
+           << "  const int *h_colind=" << sp_h << "+2, *h_row=" << sp_h << "+"
+           << 3+Hsp_.size2() << ";" << endl
+           << "  const real_t** arg1 = arg+" << n_in() << ";" << endl
+           << "  real_t** res1 = res+" << n_out() << ";" << endl
+           << "  real_t *mu=w, *mu_x=mu+" << ng_ << ", *xk=mu_x+" << nx_
+           << ", *x_cand=xk+" << nx_ << ", *x_old=x_cand+" << nx_ << ";" << endl
+           << "  real_t *gLag=x_old+" << nx_ << ", *gLag_old=gLag+" << nx_
+           << ", *gk=gLag_old+" << nx_ << ", *gk_cand=gk+" << ng_
+           << ", *gf=gk_cand+" << ng_ << ";" << endl
+           << "  real_t *qp_lba=gf+" << nx_ << ", *qp_uba=qp_lba+" << ng_
+           << ", *qp_lbx=qp_uba+" << ng_ << ", *qp_ubx=qp_lbx+" << nx_ << ";" << endl
+           << "  real_t *dx=qp_ubx+" << nx_ << ", *qp_dual_x=dx+" << nx_
+           << ", *qp_dual_a=qp_dual_x+" << nx_ << ", *Bk=qp_dual_a+" << ng_
+           << ", *Jk=Bk+" << Hsp_.nnz() << ", *w1=Jk+" << Asp_.nnz() << ";" << endl
+           << "  real_t *lbx=" << sw << ", *ubx=lbx+" << nx_
+           << ", *lbg=ubx+" << nx_ << ", *ubg=lbg+" << ng_
+           << ", *merit_mem=ubg+" << ng_ << ";" << endl;
+
+    // Code for evaluating the constraints and their Jacobian in xk
+    stringstream jac_g;
+    if (ng_>0) {
+      jac_g << "  arg1[0] = xk;" << endl
+            << "  arg1[1] = " << p << ";" << endl
+            << "  res1[0] = gk;" << endl
+            << "  res1[1] = Jk;" << endl
+            << "  if (" << g(jac_g_fcn_, "arg1", "res1", "iw", "w1") << ") return 1;" << endl;
+    }
+
+    // Code for evaluating the objective and its gradient in xk
+    stringstream grad_f;
+    grad_f << "  arg1[0] = xk;" << endl
+           << "  arg1[1] = " << p << ";" << endl
+           << "  res1[0] = &fk;" << endl
+           << "  res1[1] = gf;" << endl
+           << "  if (" << g(grad_f_fcn_, "arg1", "res1", "iw", "w1") << ") return 1;" << endl;
+
+    // Code for evaluating the exact Hessian in xk, regularized with the Gershgorin theorem
+    stringstream hess_l;
+    if (exact_hessian_) {
+      hess_l << "  arg1[0] = xk;" << endl
+             << "  arg1[1] = " << p << ";" << endl
+             << "  arg1[2] = &one;" << endl
+             << "  arg1[3] = mu;" << endl
+             << "  res1[0] = Bk;" << endl
+             << "  if (" << g(hess_l_fcn_, "arg1", "res1", "iw", "w1") << ") return 1;" << endl;
+      if (regularize_) {
+        hess_l << "  reg = 0;" << endl
+               << "  for (cc=0; cc<" << nx_ << "; ++cc) {" << endl
+               << "    mineig = 0;" << endl
+               << "    for (el=h_colind[cc]; el<h_colind[cc+1]; ++el) {" << endl
+               << "      mineig += h_row[el]==cc ? Bk[el] : -fabs(Bk[el]);" << endl
+               << "    }" << endl
+               << "    reg = fmin(reg, mineig);" << endl
+               << "  }" << endl
+               << "  if (reg<0) {" << endl
+               << "    for (cc=0; cc<" << nx_ << "; ++cc) {" << endl
+               << "      for (el=h_colind[cc]; el<h_colind[cc+1]; ++el) {" << endl
+               << "        if (h_row[el]==cc) Bk[el] -= reg;" << endl
+               << "      }" << endl
+               << "    }" << endl
+               << "  }" << endl;
+      }
+    }
+
+    // Code for evaluating the gradient of the Lagrangian, with the new and the old x
+    string grad_lag[2];
+    for (int k=0; k<2; ++k) {
+      string v = k==0 ? "gLag" : "gLag_old";
+      stringstream ss;
+      ss << "  copy(gf, " << nx_ << ", " << v << ");" << endl;
+      if (ng_>0) ss << "  mv(Jk, " << sp_a << ", mu, " << v << ", 1);" << endl;
+      ss << "  axpy(" << nx_ << ", 1., mu_x, " << v << ");" << endl;
+      grad_lag[k] = ss.str();
+    }
+
+    // Code for calculating the primal infeasibility, in the iterate and in the candidate
+    string pr_inf_code[2];
+    for (int k=0; k<2; ++k) {
+      string v = k==0 ? "xk" : "x_cand", gv = k==0 ? "gk" : "gk_cand";
+      pr_inf_code[k] = "fmax(max_viol(" + to_string(nx_) + ", " + v + ", lbx, ubx), max_viol("
+        + to_string(ng_) + ", " + gv + ", lbg, ubg))";
+    }
+
+    // Initial guess, multipliers and bounds
+    g.body << "  copy(arg[" << NLPSOL_X0 << "], " << nx_ << ", xk);" << endl
+           << "  copy(arg[" << NLPSOL_LAM_G0 << "], " << ng_ << ", mu);" << endl
+           << "  copy(arg[" << NLPSOL_LAM_X0 << "], " << nx_ << ", mu_x);" << endl
+           << "  copy(arg[" << NLPSOL_LBX << "], " << nx_ << ", lbx);" << endl
+           << "  copy(arg[" << NLPSOL_UBX << "], " << nx_ << ", ubx);" << endl
+           << "  copy(arg[" << NLPSOL_LBG << "], " << ng_ << ", lbg);" << endl
+           << "  copy(arg[" << NLPSOL_UBG << "], " << ng_ << ", ubg);" << endl
+           << "  fill(dx, " << nx_ << ", 0.);" << endl;
+
+    // Initial function evaluations and Hessian (approximation)
+    g.body << jac_g.str();
+    g.body << grad_f.str();
+    if (exact_hessian_) {
+      g.body << hess_l.str();
+    } else {
+      g.body << "  for (cc=0; cc<" << nx_ << "; ++cc) {" << endl
+             << "    for (el=h_colind[cc]; el<h_colind[cc+1]; ++el) Bk[el] = h_row[el]==cc;"
+             << endl
+             << "  }" << endl;
+    }
+    g.body << grad_lag[0];
+
+    // Main optimization loop
+    g.body << "  sigma = 0;" << endl
+           << "  merit_n = merit_ind = 0;" << endl
+           << "  for (iter=0; ; ++iter) {" << endl
+           << "    pr_inf = " << pr_inf_code[0] << ";" << endl
+           << "    du_inf = norm_inf(" << nx_ << ", gLag);" << endl
+           << "    dx_norminf = norm_inf(" << nx_ << ", dx);" << endl
+           << "    if (pr_inf < " << CodeGenerator::constant(tol_pr_) << " && du_inf < "
+           << CodeGenerator::constant(tol_du_) << ") break;" << endl
+           << "    if (iter >= " << max_iter_ << ") break;" << endl
+           << "    if (iter > 0 && dx_norminf <= " << CodeGenerator::constant(min_step_size_)
+           << ") break;" << endl;
+
+    // Formulate and solve the QP
+    g.body << "    for (i=0; i<" << nx_ << "; ++i) qp_lbx[i] = lbx[i] - xk[i];" << endl
+           << "    for (i=0; i<" << nx_ << "; ++i) qp_ubx[i] = ubx[i] - xk[i];" << endl
+           << "    for (i=0; i<" << ng_ << "; ++i) qp_lba[i] = lbg[i] - gk[i];" << endl
+           << "    for (i=0; i<" << ng_ << "; ++i) qp_uba[i] = ubg[i] - gk[i];" << endl
+           << "    for (i=0; i<" << qpsol_.n_in() << "; ++i) arg1[i]=0;" << endl
+           << "    arg1[" << CONIC_H << "] = Bk;" << endl
+           << "    arg1[" << CONIC_G << "] = gf;" << endl
+           << "    arg1[" << CONIC_X0 << "] = dx;" << endl
+           << "    arg1[" << CONIC_LBX << "] = qp_lbx;" << endl
+           << "    arg1[" << CONIC_UBX << "] = qp_ubx;" << endl
+           << "    arg1[" << CONIC_A << "] = Jk;" << endl
+           << "    arg1[" << CONIC_LBA << "] = qp_lba;" << endl
+           << "    arg1[" << CONIC_UBA << "] = qp_uba;" << endl
+           << "    for (i=0; i<" << qpsol_.n_out() << "; ++i) res1[i]=0;" << endl
+           << "    res1[" << CONIC_X << "] = dx;" << endl
+           << "    res1[" << CONIC_LAM_X << "] = qp_dual_x;" << endl
+           << "    res1[" << CONIC_LAM_A << "] = qp_dual_a;" << endl
+           << "    if (" << g(qpsol_, "arg1", "res1", "iw", "w1") << ") return 1;" << endl;
+
+    // Penalty parameter and L1 merit function in the actual iterate
+    g.body << "    sigma = fmax(sigma, 1.01*norm_inf(" << nx_ << ", qp_dual_x));" << endl
+           << "    sigma = fmax(sigma, 1.01*norm_inf(" << ng_ << ", qp_dual_a));" << endl
+           << "    L1dir = dot(" << nx_ << ", dx, gf) - sigma*pr_inf;" << endl
+           << "    L1merit = fk + sigma*pr_inf;" << endl
+           << "    merit_mem[merit_ind] = L1merit;" << endl
+           << "    merit_ind = (merit_ind+1) % " << merit_memsize_ << ";" << endl
+           << "    if (merit_n<" << merit_memsize_ << ") merit_n++;" << endl
+           << "    t = 1.;" << endl;
+
+    // Line-search
+    if (max_iter_ls_>0) {
+      g.body << "    for (ls_iter=1; ; ++ls_iter) {" << endl
+             << "      for (i=0; i<" << nx_ << "; ++i) x_cand[i] = xk[i] + t*dx[i];" << endl
+             << "      arg1[0] = x_cand;" << endl
+             << "      arg1[1] = " << p << ";" << endl
+             << "      res1[0] = &fk_cand;" << endl
+             << "      if (" << g(f_fcn_, "arg1", "res1", "iw", "w1") << ") {" << endl
+             << "        t = " << CodeGenerator::constant(beta_) << "*t;" << endl
+             << "        continue;" << endl
+             << "      }" << endl;
+      if (ng_>0) {
+        g.body << "      res1[0] = gk_cand;" << endl
+               << "      if (" << g(g_fcn_, "arg1", "res1", "iw", "w1") << ") {" << endl
+               << "        t = " << CodeGenerator::constant(beta_) << "*t;" << endl
+               << "        continue;" << endl
+               << "      }" << endl;
+      }
+      g.body << "      l1_infeas = " << pr_inf_code[1] << ";" << endl
+             << "      L1merit_cand = fk_cand + sigma*l1_infeas;" << endl
+             << "      meritmax = merit_mem[0];" << endl
+             << "      for (i=1; i<merit_n; ++i) meritmax = fmax(meritmax, merit_mem[i]);" << endl
+             << "      if (L1merit_cand <= meritmax + t*" << CodeGenerator::constant(c1_)
+             << "*L1dir) break;" << endl
+             << "      if (ls_iter == " << max_iter_ls_ << ") break;" << endl
+             << "      t = " << CodeGenerator::constant(beta_) << "*t;" << endl
+             << "    }" << endl
+             << "    for (i=0; i<" << ng_ << "; ++i) mu[i] = t*qp_dual_a[i] + (1-t)*mu[i];"
+             << endl
+             << "    for (i=0; i<" << nx_ << "; ++i) mu_x[i] = t*qp_dual_x[i] + (1-t)*mu_x[i];"
+             << endl
+             << "    copy(xk, " << nx_ << ", x_old);" << endl
+             << "    copy(x_cand, " << nx_ << ", xk);" << endl;
+    } else {
+      g.body << "    copy(qp_dual_a, " << ng_ << ", mu);" << endl
+             << "    copy(qp_dual_x, " << nx_ << ", mu_x);" << endl
+             << "    copy(xk, " << nx_ << ", x_old);" << endl
+             << "    axpy(" << nx_ << ", 1., dx, xk);" << endl;
+    }
+
+    // Gradient of the Lagrangian with the old x but new mu, for BFGS
+    if (!exact_hessian_) g.body << indent(grad_lag[1]);
+
+    // Function evaluations in the new iterate
+    g.body << indent(jac_g.str());
+    g.body << indent(grad_f.str())
+           << indent(grad_lag[0]);
+
+    // Update the Hessian (approximation)
+    if (exact_hessian_) {
+      g.body << indent(hess_l.str());
+    } else {
+      g.body << "    if ((iter+1) % " << lbfgs_memory_ << " == 0) {" << endl
+             << "      for (cc=0; cc<" << nx_ << "; ++cc) {" << endl
+             << "        for (el=h_colind[cc]; el<h_colind[cc+1]; ++el) {" << endl
+             << "          if (h_row[el]!=cc) Bk[el] = 0;" << endl
+             << "        }" << endl
+             << "      }" << endl
+             << "    }" << endl
+             << "    for (i=0; i<" << bfgs_.n_in() << "; ++i) arg1[i]=0;" << endl
+             << "    arg1[" << BFGS_BK << "] = Bk;" << endl
+             << "    arg1[" << BFGS_X << "] = xk;" << endl
+             << "    arg1[" << BFGS_X_OLD << "] = x_old;" << endl
+             << "    arg1[" << BFGS_GLAG << "] = gLag;" << endl
+             << "    arg1[" << BFGS_GLAG_OLD << "] = gLag_old;" << endl
+             << "    res1[0] = Bk;" << endl
+             << "    if (" << g(bfgs_, "arg1", "res1", "iw", "w1") << ") return 1;" << endl;
+    }
+    g.body << "  }" << endl;
+
+    // Save results to outputs
+    g.body << "  if (res[" << NLPSOL_F << "]) *res[" << NLPSOL_F << "] = fk;" << endl
+           << "  copy(xk, " << nx_ << ", res[" << NLPSOL_X << "]);" << endl
+           << "  copy(mu, " << ng_ << ", res[" << NLPSOL_LAM_G << "]);" << endl
+           << "  copy(mu_x, " << nx_ << ", res[" << NLPSOL_LAM_X << "]);" << endl
+           << "  copy(gk, " << ng_ << ", res[" << NLPSOL_G << "]);" << endl;
   }
 
   double Sqpmethod::
@@ -33,6 +33,10 @@
 
 /** \defgroup plugin_Nlpsol_sqpmethod
  A textbook SQPMethod
+
+ Supports code generation if the QP solver does, e.g. with the 'admm' plugin.
+ The generated solver does not print any output and does not call the
+ iteration callback.
 */
 
 /** \pluginsection{Nlpsol,sqpmethod} */
@@ -83,6 +87,8 @@ namespace casadi {
     /// Last return status
     const char* return_status;
 
+    /// Memory object of the QP solver
+    int mem_qp;
   };
 
   /** \brief  \pluginbrief{Nlpsol,sqpmethod}
@@ -122,7 +128,10 @@ namespace casadi {
     virtual void* alloc_memory() const { return new SqpmethodMemory();}
 
     /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<SqpmethodMemory*>(mem);}
+    virtual void free_memory(void *mem) const;
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
 
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
@@ -131,6 +140,15 @@ namespace casadi {
     // Solve the NLP
     virtual void solve(void* mem) const;
 
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const;
+
+    /** \brief Generate code for the declarations of the C function */
+    virtual void generateDeclarations(CodeGenerator& g) const;
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
     /// QP solver for the subproblems
     Function qpsol_;
 
@@ -30,6 +30,10 @@
       "\n"
 "A textbook SQPMethod\n"
 "\n"
+"Supports code generation if the QP solver does, e.g. with the 'admm'\n"
+"plugin. The generated solver does not print any output and does not call\n"
+"the iteration callback.\n"
+"\n"
 "\n"
 ">List of available options\n"
 "\n"
@@ -123,6 +123,20 @@ namespace casadi {
     alloc_w(n_, true);
   }
 
+  void ImplicitToNlp::init_memory(void* mem) const {
+    Rootfinder::init_memory(mem);
+    auto m = static_cast<ImplicitToNlpMemory*>(mem);
+
+    // NLP solver memory, not shared with other memory blocks
+    m->mem_nlp = solver_.checkout();
+  }
+
+  void ImplicitToNlp::free_memory(void *mem) const {
+    auto m = static_cast<ImplicitToNlpMemory*>(mem);
+    solver_.release(m->mem_nlp);
+    Rootfinder::free_memory(mem);
+  }
+
   void ImplicitToNlp::set_work(void* mem, const double**& arg, double**& res,
                         int*& iw, double*& w) const {
       Rootfinder::set_work(mem, arg, res, iw, w);
@@ -172,8 +186,8 @@ namespace casadi {
     m->res[NLPSOL_X] = m->x;
 
     // Solve the NLP
-    solver_(m->arg, m->res, m->iw, m->w, 0);
-    m->solver_stats = solver_.stats();
+    solver_(m->arg, m->res, m->iw, m->w, m->mem_nlp);
+    m->solver_stats = solver_.stats(m->mem_nlp);
 
     // Get the implicit variable
     casadi_copy(m->x, n_, m->ires[iout_]);
@@ -48,6 +48,9 @@ namespace casadi {
     double *p;
     // solution
     double *x;
+
+    // Memory object of the NLP solver
+    int mem_nlp;
   };
 
   /** \brief  \pluginbrief{Rootfinder,nlp}
@@ -87,7 +90,10 @@ namespace casadi {
     virtual void* alloc_memory() const { return new ImplicitToNlpMemory();}
 
     /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<ImplicitToNlpMemory*>(mem);}
+    virtual void free_memory(void *mem) const;
+
+    /** \brief Initalize memory block */
+    virtual void init_memory(void* mem) const;
 
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
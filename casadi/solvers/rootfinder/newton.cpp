@@ -155,8 +155,8 @@ namespace casadi {
       }
 
       // Factorize the linear solver with J
-      linsol_.factorize(m->jac);
-      linsol_.solve(m->f, 1, false);
+      linsol_.factorize(m->jac, m->mem_linsol);
+      linsol_.solve(m->f, 1, false, m->mem_linsol);
 
       // Check convergence again
       double abstolStep=0;
@@ -212,6 +212,75 @@ namespace casadi {
     stream.unsetf(std::ios::floatfield);
   }
 
+  void Newton::generateDeclarations(CodeGenerator& g) const {
+    get_function("jac_f_z")->addDependency(g);
+  }
+
+  void Newton::generateBody(CodeGenerator& g) const {
+    g.addAuxiliary(CodeGenerator::AUX_COPY);
+    g.addAuxiliary(CodeGenerator::AUX_AXPY);
+    g.addAuxiliary(CodeGenerator::AUX_NORM_INF);
+    g.addAuxiliary(CodeGenerator::AUX_QR);
+    int n_in = this->n_in(), n_out = this->n_out();
+
+    // Symbolic QR factorization of the Jacobian, not needed for evaluation
+    Sparsity sp_v, sp_r;
+    vector<int> pc;
+    sp_jac_.qr_sparse(sp_v, sp_r, pc);
+    string sp_jac_s = g.sparsity(sp_jac_), sp_v_s = g.sparsity(sp_v), sp_r_s = g.sparsity(sp_r);
+    string pc_s = "s" + to_string(g.getConstant(pc, true));
+
+    // The factors are static work vectors since their size is only known here.
+    // The Jacobian evaluation and the factorization share the work after the iterates
+    string v = g.static_work(sp_v.nnz()), r = g.static_work(sp_r.nnz());
+    string beta = g.static_work(n_);
+    g.body << "  int i, iter;" << endl
+           << "  const real_t** arg1 = arg+" << n_in << ";" << endl
+           << "  real_t** res1 = res+" << n_out << ";" << endl
+           << "  real_t *x=w, *f=x+" << n_ << ", *jac=f+" << n_ << ", *w1=jac+"
+           << sp_jac_.nnz() << ";" << endl;
+
+    // Initial guess
+    g.body << "  copy(arg[" << iin_ << "], " << n_ << ", x);" << endl;
+
+    // Newton iterations
+    g.body << "  for (iter=0; iter<" << max_iter_ << "; ++iter) {" << endl;
+
+    // Evaluate the residual and its Jacobian, as well as the auxiliary outputs
+    g.body << "    for (i=0; i<" << n_in << "; ++i) arg1[i]=arg[i];" << endl
+           << "    arg1[" << iin_ << "] = x;" << endl
+           << "    res1[0] = jac;" << endl
+           << "    for (i=0; i<" << n_out << "; ++i) res1[i+1]=res[i];" << endl
+           << "    res1[" << 1+iout_ << "] = f;" << endl
+           << "    if (" << g(get_function("jac_f_z"), "arg1", "res1", "iw", "w1")
+           << ") return 1;" << endl;
+
+    // Check convergence
+    if (abstol_ != numeric_limits<double>::infinity()) {
+      g.body << "    if (norm_inf(" << n_ << ", f) <= " << CodeGenerator::constant(abstol_)
+             << ") break;" << endl;
+    }
+
+    // Newton step
+    g.body << "    qr(" << sp_jac_s << ", jac, w1, " << sp_v_s << ", " << v << ", " << sp_r_s
+           << ", " << r << ", " << beta << ", " << pc_s << ");" << endl
+           << "    qr_solve(f, 1, 0, " << sp_v_s << ", " << v << ", " << sp_r_s << ", " << r << ", "
+           << beta << ", " << pc_s << ", w1);" << endl;
+
+    // Check convergence again
+    if (abstolStep_ != numeric_limits<double>::infinity()) {
+      g.body << "    if (norm_inf(" << n_ << ", f) <= " << CodeGenerator::constant(abstolStep_)
+             << ") break;" << endl;
+    }
+
+    // Update the iterate
+    g.body << "    axpy(" << n_ << ", -1., f, x);" << endl
+           << "  }" << endl;
+
+    // Get the solution
+    g.body << "  copy(x, " << n_ << ", res[" << iout_ << "]);" << endl;
+  }
+
   void Newton::init_memory(void* mem) const {
     Rootfinder::init_memory(mem);
     auto m = static_cast<NewtonMemory*>(mem);
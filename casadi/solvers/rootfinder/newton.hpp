@@ -31,6 +31,11 @@
 
 /** \defgroup plugin_Rootfinder_newton
      Implements simple newton iterations to solve an implicit function.
+
+     In generated C code, the Jacobian is factorized with an embedded sparse
+     Householder QR, independent of the linear solver used for evaluation.
+     Its symbolic factorization is only computed when generating code, and
+     the factors are local arrays of the generated function.
 */
 
 /** \pluginsection{Rootfinder,newton} */
@@ -92,9 +97,6 @@ namespace casadi {
     /** \brief Initalize memory block */
     virtual void init_memory(void* mem) const;
 
-    /** \brief Free memory block */
-    virtual void free_memory(void *mem) const { delete static_cast<NewtonMemory*>(mem);}
-
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
                           int*& iw, double*& w) const;
@@ -102,6 +104,15 @@ namespace casadi {
     /// Solve the system of equations and calculate derivatives
     virtual void solve(void* mem) const;
 
+    /** \brief Is codegen supported? */
+    virtual bool has_codegen() const { return true;}
+
+    /** \brief Generate code for the declarations of the C function */
+    virtual void generateDeclarations(CodeGenerator& g) const;
+
+    /** \brief Generate code for the body of the C function */
+    virtual void generateBody(CodeGenerator& g) const;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -0,0 +1,154 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark for sparse kernels specialized at code generation time
+ *
+ * MX expression graphs dominated by matrix multiplications are generated,
+ * compiled and evaluated twice: once calling the runtime kernels, which
+ * interpret the sparsity patterns at run time, and once with the code
+ * generation option "unroll_size", which replaces small kernels by
+ * straight-line code and dense multiplications by vectorizable loops.
+ * Requires gcc in the path.
+ *
+ * Usage: codegen_sparse_kernels [n_eval] [unroll_size]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace casadi;
+using namespace std;
+
+// Covariance propagation P <- A*P*A' + Q with a sparse system matrix
+Function covariance(int n, int nsteps) {
+  // Chain of double integrators
+  Sparsity sp_A = Sparsity::band(n, 0) + Sparsity::band(n, 1);
+  MX A = MX::sym("A", sp_A), P = MX::sym("P", n, n), Q = MX::sym("Q", Sparsity::diag(n));
+  MX Pk = P;
+  for (int k=0; k<nsteps; ++k) Pk = mtimes(mtimes(A, Pk), A.T()) + Q;
+  return Function("covariance", {A, P, Q}, {Pk});
+}
+
+// Product of irregular sparse matrices with a vector
+Function sparse_chain(int n, int nmat) {
+  vector<MX> M;
+  MX x = MX::sym("x", n), y = x;
+  for (int k=0; k<nmat; ++k) {
+    vector<int> row, col;
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<n; ++i) {
+        if (i==j || (3*i+7*j+k)%4==0) {
+          row.push_back(i);
+          col.push_back(j);
+        }
+      }
+    }
+    M.push_back(MX::sym("M" + to_string(k), Sparsity::triplet(n, n, row, col)));
+    y = mtimes(M.back(), y);
+  }
+  M.push_back(x);
+  return Function("sparse_chain", M, {y});
+}
+
+// Products of small dense matrices
+Function dense_chain(int n, int nmat) {
+  vector<MX> M;
+  MX X = MX::sym("X", n, n), Y = X;
+  for (int k=0; k<nmat; ++k) {
+    M.push_back(MX::sym("M" + to_string(k), n, n));
+    Y = mtimes(M.back(), Y);
+  }
+  M.push_back(X);
+  return Function("dense_chain", M, {Y});
+}
+
+double since(chrono::steady_clock::time_point t0) {
+  return chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+}
+
+// Generate, compile and load
+Function compile(Function f, const Dict& opts, const string& name) {
+  f.generate(name, opts);
+  string cmd = "gcc -fPIC -shared -O3 " + name + ".c -o " + name + ".so";
+  casadi_assert_message(system(cmd.c_str())==0, "Compilation failed. Tried \"" << cmd << "\"");
+  remove((name + ".c").c_str());
+  return external(f.name(), "./" + name + ".so");
+}
+
+// Time an evaluation with the low-level interface
+double timing(const Function& f, const vector<vector<double> >& arg, vector<double>& r,
+              int n_eval) {
+  vector<const double*> argp(f.sz_arg());
+  for (int i=0; i<arg.size(); ++i) argp[i] = get_ptr(arg[i]);
+  r.resize(f.nnz_out(0));
+  vector<double*> resp(f.sz_res());
+  resp[0] = get_ptr(r);
+  vector<int> iw(f.sz_iw());
+  vector<double> w(f.sz_w());
+  auto t0 = chrono::steady_clock::now();
+  for (int k=0; k<n_eval; ++k) f(get_ptr(argp), get_ptr(resp), get_ptr(iw), get_ptr(w));
+  return since(t0)/n_eval;
+}
+
+int main(int argc, char* argv[]) {
+  int n_eval = argc>1 ? atoi(argv[1]) : 100000;
+  int unroll_size = argc>2 ? atoi(argv[2]) : 1000;
+
+  vector<Function> fcn = {covariance(6, 10), sparse_chain(10, 10), dense_chain(4, 10),
+                          dense_chain(12, 10)};
+  for (auto&& f : fcn) {
+    // Inputs
+    vector<vector<double> > arg(f.n_in());
+    for (int i=0; i<arg.size(); ++i) {
+      arg[i].resize(f.nnz_in(i));
+      for (int k=0; k<arg[i].size(); ++k) arg[i][k] = 0.5*sin(k+i+1.);
+    }
+
+    // Runtime kernels and specialized kernels
+    vector<double> r_ref, r_runtime, r_unrolled;
+    timing(f, arg, r_ref, 1);
+    Function f_runtime = compile(f, Dict{{"unroll_size", 0}}, "kernels_runtime");
+    Function f_unrolled = compile(f, Dict{{"unroll_size", unroll_size}}, "kernels_unrolled");
+    double t_runtime = timing(f_runtime, arg, r_runtime, n_eval);
+    double t_unrolled = timing(f_unrolled, arg, r_unrolled, n_eval);
+
+    // Compare
+    double err = 0;
+    for (int k=0; k<r_ref.size(); ++k) {
+      err = max(err, fabs(r_runtime[k]-r_ref[k]));
+      err = max(err, fabs(r_unrolled[k]-r_ref[k]));
+    }
+    casadi_assert_message(err<1e-10, "Mismatch for " << f.name() << ": " << err);
+    cout << f.name() << " (" << f.nnz_out(0) << " nonzeros): "
+         << "runtime " << 1e6*t_runtime << " us, "
+         << "unrolled " << 1e6*t_unrolled << " us "
+         << "(speedup " << t_runtime/t_unrolled << ")" << endl;
+  }
+  remove("kernels_runtime.so");
+  remove("kernels_unrolled.so");
+  return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Startup benchmark for Function::save and Function::load
+ *
+ * An optimal control problem (multiple shooting discretization of a
+ * pendulum, with the integrator unrolled in SX and the shooting in MX) is
+ * formulated together with the derivatives needed by an NLP solver. The
+ * time to build it symbolically is compared with the time to load it from
+ * a file. If Ipopt is available, the same is done for an NLP solver, which
+ * includes the derivative functions generated by the solver.
+ *
+ * Usage: function_save_load [N] [n_rk4_steps]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace casadi;
+using namespace std;
+
+// Problem size
+int N, nj;
+
+// Formulate the problem
+MXDict formulate() {
+  // Dynamics of a damped pendulum
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  SX ode = vertcat(x(1), -9.81*sin(x(0)) - 0.1*x(1) + u);
+
+  // Runge-Kutta 4 integrator, unrolled
+  double h = 0.05;
+  SX xk = x;
+  for (int j=0; j<nj; ++j) {
+    SX k1 = substitute(ode, x, xk);
+    SX k2 = substitute(ode, x, xk + h/2*k1);
+    SX k3 = substitute(ode, x, xk + h/2*k2);
+    SX k4 = substitute(ode, x, xk + h*k3);
+    xk = xk + h/6*(k1 + 2*k2 + 2*k3 + k4);
+  }
+  Function F("F", {x, u}, {xk}, {"x", "u"}, {"xf"});
+
+  // Multiple shooting
+  MX w = MX::sym("w", 3*N+2);
+  vector<MX> g;
+  MX J = 0;
+  for (int k=0; k<N; ++k) {
+    MX xk = w(Slice(3*k, 3*k+2)), uk = w(3*k+2), xn = w(Slice(3*k+3, 3*k+5));
+    g.push_back(F(vector<MX>{xk, uk}).at(0) - xn);
+    J += dot(xk, xk) + uk*uk;
+  }
+  return {{"x", w}, {"f", J}, {"g", vertcat(g)}};
+}
+
+// Build the functions symbolically
+Function build() {
+  MXDict nlp = formulate();
+  MX w = nlp["x"], J = nlp["f"], G = nlp["g"];
+  MX lam = MX::sym("lam", G.size1());
+  MX L = J + dot(lam, G);
+  return Function("nlp", {w, lam}, {J, G, jacobian(G, w), hessian(L, w)},
+                  {"w", "lam"}, {"f", "g", "jac_g", "hess_l"});
+}
+
+double since(chrono::steady_clock::time_point t0) {
+  return chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+}
+
+int main(int argc, char* argv[]) {
+  N = argc>1 ? atoi(argv[1]) : 100;
+  nj = argc>2 ? atoi(argv[2]) : 20;
+  string fname = "function_save_load.casadi";
+
+  // Symbolic construction
+  auto t0 = chrono::steady_clock::now();
+  Function f = build().expand();
+  double t_build = since(t0);
+
+  // Save, then load
+  t0 = chrono::steady_clock::now();
+  f.save(fname);
+  double t_save = since(t0);
+  t0 = chrono::steady_clock::now();
+  Function f2 = Function::load(fname);
+  double t_load = since(t0);
+
+  // Compare
+  vector<DM> arg = {DM::ones(f.sparsity_in(0))*0.1, DM::ones(f.sparsity_in(1))};
+  vector<DM> r = f(arg), r2 = f2(arg);
+  for (int i=0; i<r.size(); ++i) {
+    casadi_assert_message(r[i].sparsity()==r2[i].sparsity()
+                          && r[i].nonzeros()==r2[i].nonzeros(), "Mismatch for output " << i);
+  }
+  cout << f.n_nodes() << " nodes" << endl;
+  cout << "build: " << t_build << " s" << endl;
+  cout << "save:  " << t_save << " s" << endl;
+  cout << "load:  " << t_load << " s (speedup " << t_build/t_load << ")" << endl;
+
+  // NLP solver with its derivative functions
+  if (has_nlpsol("ipopt")) {
+    Dict opts = {{"expand", true}, {"ipopt.print_level", 0}, {"print_time", false}};
+    t0 = chrono::steady_clock::now();
+    Function solver = nlpsol("solver", "ipopt", formulate(), opts);
+    double t_build = since(t0);
+    solver.save(fname);
+    t0 = chrono::steady_clock::now();
+    Function solver2 = Function::load(fname);
+    double t_load = since(t0);
+
+    DMDict sol = solver(DMDict{{"x0", 0.1}, {"lbg", 0}, {"ubg", 0}});
+    DMDict sol2 = solver2(DMDict{{"x0", 0.1}, {"lbg", 0}, {"ubg", 0}});
+    casadi_assert_message(sol["x"].nonzeros()==sol2["x"].nonzeros(), "Mismatch for solver");
+    cout << "nlpsol build: " << t_build << " s" << endl;
+    cout << "nlpsol load:  " << t_load << " s (speedup " << t_build/t_load << ")" << endl;
+  }
+
+  remove(fname.c_str());
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Stress test and benchmark for constructing expressions concurrently
+ * Requires CasADi to be built with WITH_THREADSAFE_SYMBOLICS.
+ *
+ * A number of scenario problems (multiple shooting discretizations of a small
+ * optimal control problem with scenario-dependent parameters) are formulated,
+ * differentiated and evaluated, first serially and then by a number of threads
+ * working on different scenarios. All symbols are created by the thread
+ * formulating the scenario.
+ *
+ * Usage: parallel_construction [n_scenarios] [n_threads]
+ *
+ * \author Joel Andersson
+ * \date 2016
+ */
+
+#include "casadi/casadi.hpp"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+using namespace std;
+
+// Formulate, differentiate and evaluate the problem for one scenario
+double scenario(int s) {
+  // Dynamics of a damped pendulum
+  SX x = SX::sym("x", 2), u = SX::sym("u"), p = SX::sym("p");
+  SX ode = vertcat(x(1), -p*sin(x(0)) - 0.1*x(1) + u);
+
+  // Runge-Kutta 4 integrator, unrolled
+  int N = 40, nj = 4;
+  double h = 0.05;
+  SX xk = x;
+  for (int j=0; j<nj; ++j) {
+    SX k1 = substitute(ode, x, xk);
+    SX k2 = substitute(ode, x, xk + h/2*k1);
+    SX k3 = substitute(ode, x, xk + h/2*k2);
+    SX k4 = substitute(ode, x, xk + h*k3);
+    xk = xk + h/6*(k1 + 2*k2 + 2*k3 + k4);
+  }
+  Function F("F", {x, u, p}, {xk});
+
+  // Multiple shooting
+  SX w = SX::sym("w", 3*N+2);
+  SX pk = 9.81 + 0.01*s;
+  vector<SX> g;
+  SX J = 0;
+  for (int k=0; k<N; ++k) {
+    SX xk = w(Slice(3*k, 3*k+2)), uk = w(3*k+2), xn = w(Slice(3*k+3, 3*k+5));
+    g.push_back(F(vector<SX>{xk, uk, pk}).at(0) - xn);
+    J += dot(xk, xk) + uk*uk;
+  }
+  SX G = vertcat(g);
+
+  // Derivatives as needed by an NLP solver
+  SX lam = SX::sym("lam", G.size1());
+  SX L = J + dot(lam, G);
+  Function nlp("nlp", {w, lam}, {J, G, jacobian(G, w), hessian(L, w)});
+
+  // Evaluate
+  vector<DM> r = nlp(vector<DM>{DM::ones(w.size1()), DM::ones(lam.size1())});
+  return double(r.at(0));
+}
+
+int main(int argc, char* argv[]) {
+  int n_scenarios = argc>1 ? atoi(argv[1]) : 64;
+  int n_threads = argc>2 ? atoi(argv[2]) : thread::hardware_concurrency();
+  if (n_threads<1) n_threads = 1;
+
+  // Reference, serial
+  vector<double> ref(n_scenarios);
+  auto t0 = chrono::steady_clock::now();
+  for (int s=0; s<n_scenarios; ++s) ref[s] = scenario(s);
+  auto t1 = chrono::steady_clock::now();
+
+  // Threads claiming scenarios from a shared counter
+  vector<double> res(n_scenarios);
+  atomic<int> next(0);
+  vector<thread> workers;
+  for (int t=0; t<n_threads; ++t) {
+    workers.emplace_back([&]() {
+      for (int s=next++; s<n_scenarios; s=next++) res[s] = scenario(s);
+    });
+  }
+  for (auto&& w : workers) w.join();
+  auto t2 = chrono::steady_clock::now();
+
+  // Compare
+  for (int s=0; s<n_scenarios; ++s) {
+    casadi_assert_message(res[s]==ref[s], "Mismatch for scenario " << s);
+  }
+
+  double t_serial = chrono::duration<double>(t1-t0).count();
+  double t_parallel = chrono::duration<double>(t2-t1).count();
+  cout << n_scenarios << " scenarios" << endl;
+  cout << "serial:   " << t_serial << " s" << endl;
+  cout << "threads:  " << t_parallel << " s (" << n_threads << " threads)" << endl;
+  cout << "speedup:  " << t_serial/t_parallel << endl;
+  return 0;
+}
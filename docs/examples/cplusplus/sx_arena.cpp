@@ -0,0 +1,129 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Checks and benchmark for SXArena
+ *
+ * Checks that arenas in the same thread behave like a stack also when they
+ * go out of scope in a different order than they were created, that
+ * expressions may outlive their arena and that freed nodes are recycled.
+ * Then times the construction and destruction of a large expression graph
+ * with the nodes on the heap and in an arena.
+ * Requires CasADi to be built with WITH_SX_ARENA.
+ *
+ * Usage: sx_arena [n_nodes]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+using namespace std;
+
+// Expression graph with about 4*n nodes
+SX build(const SX& x, const SX& y, int n) {
+  SX e = x;
+  for (int k=0; k<n; ++k) e = sin(e)*y + e;
+  return e;
+}
+
+double since(chrono::steady_clock::time_point t0) {
+  return chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+}
+
+// Time the construction and destruction of a graph
+void timing(const string& name, int n, bool use_arena) {
+  SX x = SX::sym("x"), y = SX::sym("y");
+  SXArena* arena = use_arena ? new SXArena() : 0;
+  auto t0 = chrono::steady_clock::now();
+  SX* e = new SX(build(x, y, n));
+  double t_build = since(t0);
+  t0 = chrono::steady_clock::now();
+  delete e;
+  double t_free = since(t0);
+  delete arena;
+  cout << name << ": construction " << t_build << " s, destruction " << t_free << " s" << endl;
+}
+
+int main(int argc, char* argv[]) {
+  int n = argc>1 ? atoi(argv[1]) : 1000000;
+  casadi_assert_message(SXArena::enabled(), "CasADi was built without WITH_SX_ARENA");
+  SX x = SX::sym("x"), y = SX::sym("y");
+
+  // Nested arenas
+  casadi_assert(SXArena::depth()==0);
+  {
+    SXArena a;
+    SX e = sin(x)*y;
+    casadi_assert(a.n_nodes()==2);
+    {
+      SXArena b;
+      SX f = cos(x);
+      casadi_assert(SXArena::depth()==2);
+      casadi_assert(a.n_nodes()==2 && b.n_nodes()==1);
+    }
+    SX g = tan(x);
+    casadi_assert(a.n_nodes()==3);
+  }
+  casadi_assert(SXArena::depth()==0);
+
+  // Arenas going out of scope in a different order than they were created
+  SXArena *a = new SXArena(), *b = new SXArena();
+  delete a;
+  casadi_assert(SXArena::depth()==1);
+  SX e = sin(x);
+  casadi_assert(b->n_nodes()==1);
+  delete b;
+  casadi_assert(SXArena::depth()==0);
+  SXArena c;
+  SX f = cos(x);
+  casadi_assert(c.n_nodes()==1);
+
+  // Expressions outliving the arena
+  SX g;
+  {
+    SXArena d;
+    g = build(x, y, 100);
+  }
+  Function F("F", {x, y}, {g});
+  Function F_ref("F_ref", {x, y}, {build(x, y, 100)});
+  vector<DM> arg = {0.3, 1.2};
+  casadi_assert(static_cast<double>(F(arg).at(0))==static_cast<double>(F_ref(arg).at(0)));
+
+  // Freed nodes are recycled while the arena is active
+  {
+    SXArena d(1<<16);
+    build(x, y, 1000);
+    size_t n_bytes = d.n_bytes();
+    for (int k=0; k<100; ++k) build(x, y, 1000);
+    casadi_assert(d.n_nodes()==0);
+    casadi_assert(d.n_bytes()==n_bytes);
+  }
+
+  // Benchmark
+  timing("heap ", n, false);
+  timing("arena", n, true);
+  return 0;
+}
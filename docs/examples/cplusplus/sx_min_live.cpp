@@ -0,0 +1,88 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Benchmark for the "min_live" option of SX functions
+ *
+ * Builds a reduction tree over 2^depth leaves. The default depth-first
+ * sorting keeps the leaves alive until they are combined, while the
+ * greedy list scheduling of "min_live" combines them as soon as possible.
+ * Prints the size of the work vector and the evaluation time with and
+ * without the option and checks that the results are identical.
+ *
+ * Usage: sx_min_live [depth] [n_eval]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+using namespace std;
+
+// Reduction tree with 2^depth leaves
+SX build(const SX& x, int depth) {
+  int n = x.nnz();
+  vector<SX> l;
+  for (int i=0; i<n; ++i) l.push_back(sin(x(i))*cos(x(n-1-i)));
+  for (int d=0; d<depth; ++d) {
+    vector<SX> next;
+    for (int i=0; i<l.size(); i+=2) next.push_back(l[i]*l[i+1] + l[i]);
+    l = next;
+  }
+  return l.at(0);
+}
+
+// Evaluate a function n_eval times and return the time per call
+double timing(const Function& f, const vector<double>& x, double& r, int n_eval) {
+  const double* arg[1] = {get_ptr(x)};
+  double* res[1] = {&r};
+  vector<int> iw(f.sz_iw());
+  vector<double> w(f.sz_w());
+  auto t0 = chrono::steady_clock::now();
+  for (int k=0; k<n_eval; ++k) f(arg, res, get_ptr(iw), get_ptr(w), 0);
+  return chrono::duration<double>(chrono::steady_clock::now()-t0).count()/n_eval;
+}
+
+int main(int argc, char* argv[]) {
+  int depth = argc>1 ? atoi(argv[1]) : 10;
+  int n_eval = argc>2 ? atoi(argv[2]) : 1000;
+  int n = 1 << depth;
+  SX x = SX::sym("x", n);
+  SX e = build(x, depth);
+
+  Function f("f", {x}, {e});
+  Function f_ml("f_ml", {x}, {e}, Dict{{"min_live", true}});
+
+  vector<double> x0(n);
+  for (int i=0; i<n; ++i) x0[i] = 0.5 + 0.01*i/n;
+  double r, r_ml;
+  double t = timing(f, x0, r, n_eval), t_ml = timing(f_ml, x0, r_ml, n_eval);
+
+  cout << "depth-first: sz_w = " << f.sz_w() << ", " << t << " s per call" << endl;
+  cout << "min_live   : sz_w = " << f_ml.sz_w() << ", " << t_ml << " s per call" << endl;
+  casadi_assert_message(r==r_ml, "Results differ");
+  casadi_assert_message(f_ml.sz_w()<f.sz_w(), "The work vector did not shrink");
+  return 0;
+}
@@ -379,6 +379,7 @@ void CVodeAdjFree(void *cvode_mem)
 #define IMstoreSensi  (ca_mem->ca_IMstoreSensi)
 #define IMinterpSensi (ca_mem->ca_IMinterpSensi)
 #define IMnewData     (ca_mem->ca_IMnewData)
+#define IMilast       (ca_mem->ca_IMilast)
 
 #define uround     (cv_mem->cv_uround)
 #define zn         (cv_mem->cv_zn)
@@ -2188,7 +2189,6 @@ static int CVAfindIndex(CVodeMem cv_mem, realtype t,
                         long int *indx, booleantype *newpoint)
 {
   CVadjMem ca_mem;
-  static long int ilast;
   DtpntMem *dt_mem;
   int sign;
   booleantype to_left, to_right;
@@ -2203,21 +2203,21 @@ static int CVAfindIndex(CVodeMem cv_mem, realtype t,
 
   /* If this is the first time we use new data */
   if (IMnewData) {
-    ilast     = np-1;
+    IMilast     = np-1;
     *newpoint = TRUE;
     IMnewData   = FALSE;
   }
 
-  /* Search for indx starting from ilast */
-  to_left  = ( sign*(t - dt_mem[ilast-1]->t) < ZERO);
-  to_right = ( sign*(t - dt_mem[ilast]->t)   > ZERO);
+  /* Search for indx starting from IMilast */
+  to_left  = ( sign*(t - dt_mem[IMilast-1]->t) < ZERO);
+  to_right = ( sign*(t - dt_mem[IMilast]->t)   > ZERO);
 
   if ( to_left ) {
     /* look for a new indx to the left */
 
     *newpoint = TRUE;
     
-    *indx = ilast;
+    *indx = IMilast;
     loop {
       if ( *indx == 0 ) break;
       if ( sign*(t - dt_mem[*indx-1]->t) <= ZERO ) (*indx)--;
@@ -2225,9 +2225,9 @@ static int CVAfindIndex(CVodeMem cv_mem, realtype t,
     }
 
     if ( *indx == 0 )
-      ilast = 1;
+      IMilast = 1;
     else
-      ilast = *indx;
+      IMilast = *indx;
 
     if ( *indx == 0 ) {
       /* t is beyond leftmost limit. Is it too far? */  
@@ -2241,19 +2241,19 @@ static int CVAfindIndex(CVodeMem cv_mem, realtype t,
 
     *newpoint = TRUE;
 
-    *indx = ilast;
+    *indx = IMilast;
     loop {
       if ( sign*(t - dt_mem[*indx]->t) > ZERO) (*indx)++;
       else                                     break;
     }
 
-    ilast = *indx;
+    IMilast = *indx;
 
 
   } else {
-    /* ilast is still OK */
+    /* IMilast is still OK */
 
-    *indx = ilast;
+    *indx = IMilast;
 
   }
 
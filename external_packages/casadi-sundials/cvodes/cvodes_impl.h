@@ -721,6 +721,7 @@ struct CVadjMemRec {
   /* Flags controlling the interpolation module */
   booleantype ca_IMmallocDone;   /* IM initialized? */
   booleantype ca_IMnewData;      /* new data available in dt_mem?*/
+  long int ca_IMilast;           /* last index found in dt_mem */
   booleantype ca_IMstoreSensi;   /* store sensitivities? */
   booleantype ca_IMinterpSensi;  /* interpolate sensitivities? */
 
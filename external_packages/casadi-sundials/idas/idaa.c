@@ -107,6 +107,7 @@ extern int IDAGetSolution(void *ida_mem, realtype t, N_Vector yret, N_Vector ypr
 #define ckpntData    (IDAADJ_mem->ia_ckpntData)
 #define newData      (IDAADJ_mem->ia_newData)
 #define np           (IDAADJ_mem->ia_np)
+#define ilast        (IDAADJ_mem->ia_ilast)
 #define dt           (IDAADJ_mem->ia_dt)
 #define yyTmp        (IDAADJ_mem->ia_yyTmp)
 #define ypTmp        (IDAADJ_mem->ia_ypTmp)
@@ -3113,7 +3114,6 @@ static int IDAAfindIndex(IDAMem ida_mem, realtype t,
 {
   IDAadjMem IDAADJ_mem;
   IDAMem IDA_mem;
-  static long int ilast;
   DtpntMem *dt_mem;
   int sign;
   booleantype to_left, to_right;
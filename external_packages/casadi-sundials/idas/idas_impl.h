@@ -728,6 +728,7 @@ struct IDAadjMemRec {
   /* Flags controlling the interpolation module */
   booleantype ia_mallocDone;   /* IM initialized?                */
   booleantype ia_newData;      /* new data available in dt_mem?  */
+  long int ia_ilast;           /* last index found in dt_mem     */
   booleantype ia_storeSensi;   /* store sensitivities?           */
   booleantype ia_interpSensi;  /* interpolate sensitivities?     */
 
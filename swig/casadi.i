@@ -3085,6 +3085,14 @@ DECL std::vector< M > casadi_substitute(const std::vector< M >& ex,
   return substitute(ex, v, vdef);
 }
 
+DECL M casadi_cse(const M& e) {
+  return cse(e);
+}
+
+DECL std::vector< M > casadi_cse(const std::vector< M >& e) {
+  return cse(e);
+}
+
 DECL void casadi_substitute_inplace(const std::vector< M >& v,
                                       std::vector< M >& INOUT1,
                                       std::vector< M >& INOUT2,
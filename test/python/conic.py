@@ -43,6 +43,15 @@ if has_conic("ooqp"):
 if has_conic("qpoases"):
   conics.append(("qpoases",{},{}))
 
+if has_conic("ipqp"):
+  conics.append(("ipqp",{},{}))
+
+if has_conic("admm"):
+  conics.append(("admm",{},{"less_digits":2}))
+
+if has_conic("riccati"):
+  conics.append(("riccati",{},{}))
+
 if has_conic("cplex"):
   conics.append(("cplex",{},{}))
 
@@ -749,6 +758,104 @@ class ConicTests(casadiTestCase):
 
       self.assertAlmostEqual(solver_out["cost"][0],7,max(1,5-less_digits),str(conic))
 
+  @requires_conic("admm")
+  def test_admm_codegen(self):
+    H = DM([[4,1],[1,2]])
+    G = DM([1,1])
+    A = DM([[1,1],[1,0],[0,1]])
+    LBA = DM([1,0,0])
+    UBA = DM([1,0.7,0.7])
+    LBX = DM([-inf,-inf])
+    UBX = DM([inf,inf])
+
+    solver = casadi.conic("mysolver","admm",{'h':H.sparsity(),'a':A.sparsity()},{"warm_start":False})
+    solver_out = solver(h=H,g=G,a=A,lba=LBA,uba=UBA,lbx=LBX,ubx=UBX)
+    self.checkarray(solver_out["x"],DM([0.3,0.7]),digits=4)
+    self.checkarray(solver_out["lam_a"],DM([-2.9,0,0.2]),digits=4)
+
+    self.check_codegen(solver,inputs=[H,G,A,LBA,UBA,LBX,UBX,DM.zeros(2),DM.zeros(2),DM.zeros(3)])
+
+  @requires_conic("admm")
+  def test_admm_warm_start(self):
+    H = DM([[4,1],[1,2]])
+    A = DM([[1,1],[1,0],[0,1]])
+    LBA = DM([1,0,0])
+    UBA = DM([1,0.7,0.7])
+
+    cold = casadi.conic("cold","admm",{'h':H.sparsity(),'a':A.sparsity()},{"warm_start":False})
+    warm = casadi.conic("warm","admm",{'h':H.sparsity(),'a':A.sparsity()},{"warm_start":True})
+
+    # Sequence of slightly perturbed problems, as in model predictive control
+    for k in range(4):
+      G = DM([1+0.01*k,1])
+      cold_out = cold(h=H,g=G,a=A,lba=LBA,uba=UBA)
+      warm_out = warm(h=H,g=G,a=A,lba=LBA,uba=UBA)
+      self.checkarray(warm_out["x"],cold_out["x"],digits=4)
+      self.checkarray(warm_out["lam_a"],cold_out["lam_a"],digits=4)
+      self.assertTrue(warm.stats()["success"])
+      if k==0:
+        self.assertEqual(warm.stats()["iter_count"],cold.stats()["iter_count"])
+      else:
+        self.assertTrue(warm.stats()["iter_count"]<cold.stats()["iter_count"])
+
+  @requires_conic("admm")
+  def test_admm_max_iter(self):
+    H = DM([[4,1],[1,2]])
+    A = DM([[1,1],[1,0],[0,1]])
+    LBA = DM([1,0,0])
+    UBA = DM([1,0.7,0.7])
+
+    solver = casadi.conic("solver","admm",{'h':H.sparsity(),'a':A.sparsity()},{"max_iter":3})
+    with self.assertRaises(Exception):
+      solver(h=H,g=DM([1,1]),a=A,lba=LBA,uba=UBA)
+    self.assertFalse(solver.stats()["success"])
+
+  @requires_conic("riccati")
+  @requires_conic("ipqp")
+  def test_riccati_ocp(self):
+    # Linear-quadratic optimal control problem, variables ordered x0,u0,x1,u1,...,xN
+    N = 10
+    Ad = DM([[1,0.1],[0,1]])
+    Bd = DM([0,0.1])
+    x = MX.sym("x0",2)
+    w = [x]
+    g = []
+    J = 0
+    for k in range(N):
+      u = MX.sym("u")
+      xn = MX.sym("x%d" % (k+1),2)
+      w += [u,xn]
+      g.append(mtimes(Ad,x)+mtimes(Bd,u)-xn)
+      J += dot(x,x)+0.1*u**2
+      x = xn
+    J += dot(x,x)
+    W = vertcat(*w)
+    G = vertcat(*g)
+    H, Gc = hessian(J,W)
+    qp = Function("qp",[W],[H,Gc,jacobian(G,W)])
+    [H,Gc,A] = qp(DM.zeros(W.shape[0]))
+
+    lbx = -DM.inf(W.shape[0])
+    ubx = DM.inf(W.shape[0])
+    lbx[0] = ubx[0] = 1
+    lbx[1] = ubx[1] = 0
+    for k in range(N):
+      lbx[2+3*k] = -1
+      ubx[2+3*k] = 1
+    qp_in = dict(h=H,g=Gc,a=A,lba=DM.zeros(2*N),uba=DM.zeros(2*N),lbx=lbx,ubx=ubx)
+
+    riccati = casadi.conic("riccati","riccati",{'h':H.sparsity(),'a':A.sparsity()})
+    ipqp = casadi.conic("ipqp","ipqp",{'h':H.sparsity(),'a':A.sparsity()})
+    riccati_out = riccati(**qp_in)
+    ipqp_out = ipqp(**qp_in)
+    self.checkarray(riccati_out["x"],ipqp_out["x"],digits=8)
+    self.checkarray(riccati_out["lam_a"],ipqp_out["lam_a"],digits=8)
+
+    # One block per stage, each with a control, a state and its multipliers
+    stats = riccati.stats()
+    self.assertEqual(stats["n_block"],N+1)
+    self.assertEqual(stats["max_block"],6)
+
   @requires_conic("hpmpc")
   @requires_conic("qpoases")
   def test_hpmc(self):
@@ -25,6 +25,7 @@ from casadi import *
 import casadi as c
 import numpy
 import unittest
+import os
 from types import *
 from helpers import *
 
@@ -399,6 +400,125 @@ class Functiontests(casadiTestCase):
 
         assert f2.sparsity_jac().nnz()==162
 
+  def test_sparsity_num_threads(self):
+    N = 3000
+    x = MX.sym("x",N)
+    y = sin(x[1:])*x[:-1]
+    y = vertcat(y, x[0]*x[-1])
+    hier = GlobalOptions.getHierarchicalSparsity()
+    for h in [False, True]:
+      GlobalOptions.setHierarchicalSparsity(h)
+      for symm in [False, True]:
+        sp = []
+        for nt in [1, 4]:
+          GlobalOptions.setSparsityNumThreads(nt)
+          if symm:
+            f = Function("f",[x],[gradient(dot(y,y),x)],{"sparsity_stats":True})
+          else:
+            f = Function("f",[x],[y],{"sparsity_stats":True})
+          sp.append(f.sparsity_jac(0, 0, False, symm))
+          self.assertTrue(f.stats()["n_call_jac_sparsity"]==1)
+        self.assertFalse("n_call_jac_sparsity" in Function("f",[x],[y]).stats())
+        self.assertTrue(sp[0]==sp[1])
+    GlobalOptions.setSparsityNumThreads(1)
+    GlobalOptions.setHierarchicalSparsity(hier)
+
+  def test_mx_num_threads(self):
+    x = SX.sym("x",5)
+    g = Function("g",[x],[sin(x)*cos(x[0])+x**2])
+    X = MX.sym("X",5)
+    r = [g(X*(i+1)) for i in range(6)]
+    s = r[0]
+    for e in r[1:]:
+      s = s + e
+    y = r[1]
+    y[0] = s[2]
+    f1 = Function("f",[X],[s,y,dot(s,s)])
+    f4 = Function("f",[X],[s,y,dot(s,s)],{"num_threads":4})
+    v = DM([0.1,0.2,0.3,0.4,0.5])
+    for k in range(3):
+      self.checkarray(f1(v)[k],f4(v)[k])
+    self.checkfunction(f1,f4,inputs=[v])
+
+  def test_profile(self):
+    x = SX.sym("x",2)
+    f = Function("f",[x],[sin(x)*x[0]])
+    X = MX.sym("X",2)
+    F = f.map("fmap","serial",4,{})
+    g = Function("g",[X],[f(X)+sum2(F(repmat(X,1,4)))],{"profile":True})
+    for i in range(3):
+      g([1,2])
+    p = g.profile()
+    self.assertEqual(p["n_call"],3)
+    self.assertEqual(p["children"]["f"]["n_call"],3)
+    self.assertEqual(p["children"]["fmap"]["children"]["f"]["n_call"],12)
+    self.assertTrue(p["children"]["f"]["flops"]>0)
+    self.assertTrue("fmap" in g.profile_json())
+    g.reset_profile()
+    self.assertEqual(g.profile()["n_call"],0)
+
+  def test_profile_max_events(self):
+    import json
+    x = SX.sym("x",2)
+    f = Function("f",[x],[sin(x)*x[0]])
+    X = MX.sym("X",2)
+    F = f.map("fmap","serial",4,{})
+    g = Function("g",[X],[f(X)+sum2(F(repmat(X,1,4)))],{"profile":True,"profile_max_events":5})
+    for i in range(3):
+      g([1,2])
+    self.assertEqual(g.profile()["children"]["fmap"]["children"]["f"]["n_call"],12)
+    g.profile_trace("test_profile_max_events.json")
+    with open("test_profile_max_events.json") as t:
+      ev = json.load(t)["traceEvents"]
+    os.remove("test_profile_max_events.json")
+    self.assertEqual(len(ev),5)
+    # The most recent calls are kept, the last one being the outermost call
+    self.assertEqual(ev[-1]["name"],"g")
+
+  def test_save_load(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p")
+    f = Function("f",[x,p],[sin(x)*p+x[0]**2,dot(x,x),3],["x","p"],["r","s","c"])
+    g = Function("g",[x,p],[jacobian(sin(x)*p,x)])
+    X = MX.sym("X",3)
+    P = MX.sym("P")
+    r = f(X,P)
+    y = X*1
+    y[1] = P
+    h = Function("h",[X,P],[r[0]+mtimes(g(X,P),X),r[1]*2,X[[0,2]],horzcat(X,X).T,y,
+                            vertsplit(X,[0,1,3])[1]*X[0],fmin(X,P)],["X","P"],["a","b","c","d","e","f","g"])
+    v = [DM([0.1,0.2,0.3]),2]
+    for F in [f, h]:
+      F.save("save_load.casadi")
+      F2 = Function.load("save_load.casadi")
+      self.assertEqual(F2.name(),F.name())
+      self.assertEqual(F2.name_in(),F.name_in())
+      self.assertEqual(F2.name_out(),F.name_out())
+      self.checkfunction(F,F2,inputs=v)
+
+    # Free variables
+    q = SX.sym("q")
+    Function("fq",[x],[x*q]).save("save_load.casadi")
+    self.assertEqual(str(Function.load("save_load.casadi").free_sx()),"[SX(q)]")
+
+    # Not a saved function
+    with open("save_load.casadi","w") as out:
+      out.write("hello")
+    with self.assertRaises(Exception):
+      Function.load("save_load.casadi")
+
+    # Solver, including the derivative functions it has created
+    if has_nlpsol("sqpmethod") and has_conic("qpoases"):
+      z = SX.sym("z",2)
+      nlp = {"x":z,"p":p,"f":(z[0]-1)**2+(z[1]-2)**2+p*z[0],"g":z[0]*z[1]}
+      solver = nlpsol("solver","sqpmethod",nlp,{"qpsol":"qpoases","print_time":False,
+                                               "qpsol_options":{"printLevel":"none"}})
+      solver.save("save_load.casadi")
+      solver2 = Function.load("save_load.casadi")
+      arg = {"x0":0.5,"p":0.3,"lbg":-10,"ubg":1}
+      self.checkarray(solver(**arg)["x"],solver2(**arg)["x"])
+    os.remove("save_load.casadi")
+
   def test_callback(self):
     class mycallback(Callback):
       def __init__(self, name, opts={}):
@@ -485,7 +605,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll"] if args.run_slow else ["serial"]:
+    for parallelization in ["serial","openmp","thread","simd","unroll"] if args.run_slow else ["serial"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -528,7 +648,7 @@ class Functiontests(casadiTestCase):
     zi = 0
     for Z_alt in [Z,[MX()]*3]:
       zi+= 1
-      for parallelization in ["serial","openmp","unroll"]:
+      for parallelization in ["serial","openmp","thread","simd","unroll"]:
         res = fun.mapsum([horzcat(*x) for x in [X,Y,Z_alt,V]],parallelization) # Joris - clean alternative for this?
 
         for ad_weight_sp in [0,1]:
@@ -573,7 +693,7 @@ class Functiontests(casadiTestCase):
 
     for Z_alt in [Z]:
 
-      for parallelization in ["serial","openmp","unroll"]:
+      for parallelization in ["serial","openmp","thread","simd","unroll"]:
 
         for ad_weight_sp in [0,1]:
           for ad_weight in [0,1]:
@@ -848,6 +968,113 @@ class Functiontests(casadiTestCase):
   #   [v] = f([])
   #   self.checkarray(2.37683, v, digits=4)
 
+  def test_codegen_split(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    e = x
+    for i in range(10):
+      e = sin(e*y[0]+cos(e[::-1]))+y[1]*e
+    F = Function("f",[x,y],[e,dot(e,e)])
+    inputs = [DM([0.1,0.2,0.3]),DM([0.7,1.1])]
+
+    for opts in [{"split_size": 7}, {"split_size": 7, "split_files": 2}]:
+      self.check_codegen(F,inputs=inputs,opts=opts)
+
+  @requiresPlugin(Importer,"shell")
+  def test_jit_split(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    e = x
+    for i in range(10):
+      e = sin(e*y[0]+cos(e[::-1]))+y[1]*e
+    F = Function("f",[x,y],[e,dot(e,e)])
+    inputs = [DM([0.1,0.2,0.3]),DM([0.7,1.1])]
+
+    # The chunks are compiled in parallel by the shell importer
+    for opts in [{"split_size": 7}, {"split_size": 7, "split_files": 2}]:
+      Fj = Function("f",[x,y],[e,dot(e,e)],{"jit":True,"compiler":"shell",
+                                            "jit_codegen_options":opts,
+                                            "jit_options":{"num_threads":2}})
+      for r,rj in zip(F(*inputs),Fj(*inputs)):
+        self.checkarray(r,rj,digits=14)
+
+  def test_codegen_unroll(self):
+    A = MX.sym("A",Sparsity.lower(4))
+    B = MX.sym("B",4,4)
+    x = MX.sym("x",4)
+    y = mtimes(mtimes(A,B),A.T)
+    z = mtimes(B,mtimes(B,x))+project(A.T,Sparsity.band(4,1))[:,0]
+    F = Function("f",[A,B,x],[y,z,project(y,Sparsity.upper(4))])
+    inputs = [DM(Sparsity.lower(4),list(range(1,11))),DM(list(range(16))).reshape((4,4)),DM([3,1,4,1])]
+
+    for unroll_size in [0, 10, 1000]:
+      self.check_codegen(F,inputs=inputs,opts={"unroll_size": unroll_size})
+
+  @requiresPlugin(Importer,"shell")
+  def test_shell_cache(self):
+    import tempfile
+    import shutil
+    x = SX.sym("x")
+    F = Function("f",[x],[sin(x)])
+    F.generate("shell_cache")
+    cache_dir = tempfile.mkdtemp()
+    opts = {"cache_dir": cache_dir + "/a/b"}
+
+    # First compilation is a miss, second is a hit on the same binary
+    c1 = Importer("shell_cache.c", "shell", opts)
+    s1 = c1.stats()
+    self.assertFalse(s1["cache_hit"])
+    c2 = Importer("shell_cache.c", "shell", opts)
+    s2 = c2.stats()
+    self.assertTrue(s2["cache_hit"])
+    self.assertEqual(s2["bin_name"],s1["bin_name"])
+    self.assertEqual(s2["cache_hits"],s1["cache_hits"]+1)
+    self.checkarray(external("f",c2)(0.3),sin(0.3))
+
+    # No temporary files left behind by a failed compilation
+    with open("shell_cache_bad.c","w") as f:
+      f.write("this is not C\n")
+    with self.assertRaises(Exception):
+      Importer("shell_cache_bad.c", "shell", opts)
+    self.assertEqual(os.listdir(cache_dir + "/a/b"),[os.path.basename(s1["bin_name"])])
+    shutil.rmtree(cache_dir)
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("admm")
+  @requires_rootfinder("newton")
+  def test_concurrent_eval(self):
+    # An NLP solver with a stateful QP solver
+    x = SX.sym("x",3)
+    p = SX.sym("p")
+    nlp = {'x':x, 'p':p, 'f':(x[0]-1)**2+100*(x[1]-x[0]**2)**2+(x[2]-p)**2,
+           'g':vertcat(x[0]+x[1]+x[2], x[0]**2+x[2]**2)}
+    qpsol_options = {"warm_start": False, "eps_abs": 1e-12, "eps_rel": 1e-12, "max_iter": 20000}
+    solver = nlpsol("solver","sqpmethod",nlp,{"qpsol":"admm","qpsol_options":qpsol_options})
+
+    # A function calling a rootfinder, which has its own linear solver memory
+    z = SX.sym("z")
+    q = SX.sym("q")
+    rf = rootfinder("rf","newton",Function("g",[z,q],[z**3+z-q]))
+    Q = MX.sym("Q")
+    fr = Function("fr",[Q],[rf(0.5,Q)*Q])
+
+    # Evaluate each function from several threads at once
+    N = 8
+    P = DM([[0.1*k for k in range(N)]])
+    solver_arg = [[0.5,0.5,0.5],0.1,[-2,-2,-2],[2,2,2],[-1,0],[1.5,2],[0,0,0],[0,0]]
+    for f, arg in [(fr,[3*P]), (solver,solver_arg)]:
+      F = f.map(N,"thread")
+      arg_map = [repmat(DM(a),1,N) for a in arg]
+      if f is solver: arg_map[1] = P
+      for rep in range(5):
+        res_map = F(*arg_map)
+        if not isinstance(res_map,tuple): res_map = [res_map]
+        for k in range(N):
+          res_k = f(*[a[:,k] for a in arg_map])
+          if not isinstance(res_k,tuple): res_k = [res_k]
+          for r_map, r in zip(res_map,res_k):
+            self.checkarray(r_map[:,k],r)
+
   def test_depends_on(self):
     x = SX.sym("x")
     y = x**2
@@ -885,6 +1112,70 @@ class Functiontests(casadiTestCase):
     self.assertTrue(same(F([-.6, 2.5]), 24.4))
     self.assertTrue(same(F([-.6, 3.5]), 34.4))
 
+  def test_interpolant_lookup_mode(self):
+    grid = [list(np.linspace(0, 3, 31)), [0, 0.5, 2, 3]]
+    xx, yy = np.meshgrid(grid[0], grid[1], indexing='ij')
+    values = list(np.sin(xx+yy*yy).ravel(order='F'))
+    pts = [[0.13, 0.2], [1.71, 1.1], [2.95, 2.6], [-0.4, 3.3]]
+
+    ref = interpolant('F', 'linear', grid, values)
+    for mode in [["exact", "binary"], ["binary", "linear"], ["auto", "auto"]]:
+      F = interpolant('F', 'linear', grid, values, {"lookup_mode": mode})
+      for p in pts:
+        self.checkarray(F(p), ref(p), str(mode))
+
+    # Non-uniform grid cannot use exact lookup
+    with self.assertRaises(Exception):
+      interpolant('F', 'linear', grid, values, {"lookup_mode": ["exact", "exact"]})
+
+    # Several points per call
+    F = interpolant('F', 'linear', grid, values, {"batch_x": len(pts)})
+    self.assertEqual(F.size_in(0), (2, len(pts)))
+    X = DM(pts).T
+    self.checkarray(F(X), horzcat(*[ref(p) for p in pts]))
+
+    x = MX.sym("x", 2, len(pts))
+    J = Function('J', [x], [jacobian(F(x), x)])
+    x1 = MX.sym("x", 2)
+    J1 = Function('J1', [x1], [jacobian(ref(x1), x1)])
+    self.checkarray(J(X), diagcat(*[J1(p) for p in pts]))
+
+    self.check_codegen(F, inputs=[X])
+    self.check_codegen(J, inputs=[X])
+
+  def test_bspline_interpolant(self):
+    # Cubic polynomials are reproduced exactly, also when extrapolating
+    grid = [[0, 0.3, 1, 1.2, 2, 3.1], [-1, 0, 0.5, 2, 2.2]]
+    p = lambda x, y: x**3 - 2*x*y**2 + y**3 + 1
+    values = [p(x, y) for y in grid[1] for x in grid[0]]
+    F = interpolant('F', 'bspline', grid, values)
+    for x, y in [(0.77, 1.1), (-0.5, -1.3), (3.5, 2.5)]:
+      self.checkarray(F([x, y]), p(x, y), digits=10)
+
+    x = MX.sym("x", 2)
+    G = Function('G', [x], [gradient(F(x), x), hessian(F(x), x)])
+    g, H = G([0.77, 1.1])
+    self.checkarray(g, DM([3*0.77**2-2*1.1**2, -4*0.77*1.1+3*1.1**2]), digits=10)
+    self.checkarray(H, DM([[6*0.77, -4*1.1], [-4*1.1, -4*0.77+6*1.1]]), digits=10)
+    self.check_codegen(G, inputs=[[0.77, 1.1]])
+
+    # Interpolates nonlinear data, also for short grids
+    grid = [list(np.linspace(0, 3, 12)), [0, 1, 3]]
+    xx, yy = np.meshgrid(grid[0], grid[1], indexing='ij')
+    values = list((np.sin(xx)*np.cos(yy)).ravel(order='F'))
+    F = interpolant('F', 'bspline', grid, values)
+    for i in range(len(grid[0])):
+      for j in range(len(grid[1])):
+        self.checkarray(F([grid[0][i], grid[1][j]]), np.sin(grid[0][i])*np.cos(grid[1][j]))
+
+    # Several points per call
+    F = interpolant('F', 'bspline', grid, values, {"batch_x": 3})
+    x = MX.sym("x", 2, 3)
+    J = Function('J', [x], [jacobian(F(x), x)])
+    self.assertEqual(J.sparsity_out(0).nnz(), 6)
+    self.checkfunction(F, interpolant('F', 'bspline', grid, values).map(3),
+                       inputs=[DM([[0.4, 1.7, 2.9], [0.3, 1.2, 2.4]])])
+
 
   def test_Callback_Jacobian(self):
     x = MX.sym("x")
@@ -530,13 +530,15 @@ class casadiTestCase(unittest.TestCase):
               self.checkarray(a,b,("%s, output(%d)" % (order,k))+failmessage,digits=digits_sens)
 
 
-  def check_codegen(self,F,inputs=None):
+  def check_codegen(self,F,inputs=None,opts={}):
     if args.run_slow:
       import hashlib
+      import glob
       name = "codegen_%s" % (hashlib.md5(("%f" % np.random.random()+str(F)+str(time.time())).encode()).hexdigest())
-      F.generate(name)
+      F.generate(name,opts)
+      sources = " ".join([name + ".c"] + sorted(glob.glob(name + "_*.c")))
       import subprocess
-      p = subprocess.Popen("gcc -fPIC -shared -O3 %s.c -o %s.so" % (name,name) ,shell=True).wait()
+      p = subprocess.Popen("gcc -fPIC -shared -O3 %s -o %s.so" % (sources,name) ,shell=True).wait()
       F2 = external(F.name(), './' + name + '.so')
 
       Fout = F.call(inputs)
@@ -281,6 +281,18 @@ class ImplicitFunctiontests(casadiTestCase):
     a = SX.sym("a",2)
     f = Function("f", [x,a],[tan(x)-a,sqrt(a)*x**2 ])
 
+  def test_newton_codegen(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p",2)
+    f = Function("f", [x,p],[vertcat(3*x[0]+sin(x[1])-p[0], 2*x[1]+x[0]*x[2]-p[1], 4*x[2]+x[0]**2), dot(x,x)])
+    solver = rootfinder("solver", "newton", f, {"linear_solver": "csparse"})
+    self.check_codegen(solver,inputs=[[0,0,0],[0.3,0.5]])
+
+    P = MX.sym("p",2)
+    [X, n] = solver.call([DM.zeros(3),P])
+    F = Function("F", [P], [X, n+sin(X[0])])
+    self.check_codegen(F,inputs=[[0.3,0.5]])
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -998,6 +998,59 @@ class Integrationtests(casadiTestCase):
 
     integrator_out = integrator(**integrator_in)
 
+  def test_sens_num_threads(self):
+    self.message("sensitivity directions divided between threads")
+    x=SX.sym("x",3)
+    z=SX.sym("z")
+    p=SX.sym("p",4)
+    ode = vertcat(-p[0]*x[0], p[1]*x[0]-x[1], sin(x[2])*p[2])
+    for Integrator, features, options in integrators:
+      if "dae" in features:
+        dae = {'x': x, 'z': z, 'p': p, 'ode': ode+vertcat(z,0,0), 'alg': z-p[3]*x[1], 'quad': dot(x,x)}
+      else:
+        dae = {'x': x, 'p': p, 'ode': ode, 'quad': dot(x,x)}
+      X0=MX.sym("x0",3)
+      P=MX.sym("p",4)
+      J = []
+      for nt in [1, 2, 3]:
+        opts = dict(options)
+        opts["tf"] = 1.5
+        opts["sens_num_threads"] = nt
+        F = integrator("F", Integrator, dae, opts)
+        r = F(x0=X0, p=P)
+        J.append(Function("J", [X0, P], [jacobian(vertcat(r["xf"], r["qf"]), vertcat(X0, P)),
+                                         jacobian(dot(r["xf"], r["xf"])+r["qf"], vertcat(X0, P))]))
+      ref = J[0]([0.3,0.2,0.1],[0.5,0.6,0.7,0.8])
+      for j in J[1:]:
+        for i, e in enumerate(j([0.3,0.2,0.1],[0.5,0.6,0.7,0.8])):
+          self.checkarray(e,ref[i],Integrator,digits=4)
+
+  def test_codegen(self):
+    self.message("code generation of fixed-step integrators")
+    x=SX.sym("x",3)
+    z=SX.sym("z")
+    p=SX.sym("p",4)
+    rx=SX.sym("rx",3)
+    ode = vertcat(-p[0]*x[0], p[1]*x[0]-x[1], sin(x[2])*p[2])
+    for Integrator, features in [("rk", []), ("collocation", ["dae"])]:
+      if "dae" in features:
+        dae = {'x': x, 'z': z, 'p': p, 'ode': ode+vertcat(z,0,0), 'alg': z-p[3]*x[1], 'quad': dot(x,x)}
+      else:
+        dae = {'x': x, 'p': p, 'ode': ode, 'quad': dot(x,x)}
+      dae['rx'] = rx
+      dae['rode'] = vertcat(p[0]*rx[0]+x[1], rx[1]*x[0], cos(x[2])*rx[2])
+      dae['rquad'] = dot(rx, x)
+      opts = {"tf": 1.5, "number_of_finite_elements": 7}
+      F = integrator("F", Integrator, dae, opts)
+      X0=MX.sym("x0",3)
+      P=MX.sym("p",4)
+      RX0=MX.sym("rx0",3)
+      r = F(x0=X0, p=P, rx0=RX0)
+      J = Function("J", [X0, P, RX0], [r["xf"], r["qf"], r["rxf"], r["rqf"],
+                                       jacobian(vertcat(r["rxf"], r["rqf"]), vertcat(X0, P)),
+                                       gradient(dot(r["rxf"], r["rxf"])+r["rqf"], P)])
+      self.check_codegen(J, inputs=[[0.3,0.2,0.1],[0.5,0.6,0.7,0.8],[0.1,0.2,0.3]])
+
   def test_collocationPoints(self):
     self.message("collocation points")
     with self.assertRaises(Exception):
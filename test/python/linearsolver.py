@@ -63,6 +63,12 @@ try:
 except:
   pass
   
+try:
+  load_linsol("ldl")
+  lsolvers.append(("ldl",{},{"symmetry","nopivot"}))
+except:
+  pass
+
 try:
   load_linsol("ma27")
   lsolvers.append(("ma27",{},{"symmetry"}))
@@ -478,6 +484,7 @@ class LinearSolverTests(casadiTestCase):
       
       ref = np.linalg.solve(A,b)
       for Solver, options, req in lsolvers:
+        if "nopivot" in req: continue
         As = MX.sym("A",A.sparsity())
         bs = MX.sym("B",b.sparsity())
         C = solve(A,b,Solver,options)
@@ -510,6 +517,30 @@ class LinearSolverTests(casadiTestCase):
 
         self.checkarray(mtimes(A_,f_out),b)
 
+  @requires_linsol("ldl")
+  def test_ldl(self):
+    numpy.random.seed(1)
+    n = 30
+    H = DM(numpy.random.rand(n,n))
+    H = mtimes(H,H.T)+DM.eye(n)
+    J = sparsify(DM(numpy.random.rand(10,n)*(numpy.random.rand(10,n)>0.7)))
+    K = blockcat([[H,J.T],[J,-1e-3*DM.eye(10)]])
+    b = DM(numpy.random.rand(n+10,1))
+    for opts in [{}, {"amd":False}, {"max_supernode":1}]:
+      solver = casadi.Linsol("solver", "ldl", opts)
+      x = solver.solve(K, b)
+      self.checkarray(mtimes(K,x), b)
+      self.assertEqual(solver.neig(), 10)
+      # Same pattern, reusing the symbolic analysis
+      x = solver.solve(2*K, b)
+      self.checkarray(mtimes(K,x), b/2)
+      # Symmetric, so a transposed solve is the same
+      self.checkarray(solver.solve(2*K, b, True), x)
+
+    # The pattern must be symmetric
+    with self.assertRaises(Exception):
+      casadi.Linsol("solver", "ldl").solve(DM([[1,1],[0,1]]), DM([1,1]))
+
   def test_dimmismatch(self):
     A = DM.eye(5)
     b = DM.ones((4,1))
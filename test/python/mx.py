@@ -2425,5 +2425,31 @@ class MXtests(casadiTestCase):
 
         self.checkfunction(f,fr,inputs=[0])
 
+  def test_cse(self):
+    x = MX.sym("x",2)
+    y = MX.sym("y")
+    e = [sin(x*y)+cos(x*y), mtimes(x.T,x)*sin(x*y), 3+mtimes(x.T,x)]
+
+    self.assertTrue(n_nodes(vertcat(*cse(e)))<n_nodes(vertcat(*e)))
+
+    f = Function("f",[x,y],e)
+    fc = Function("f",[x,y],e,{"cse":True})
+    self.assertTrue(fc.n_nodes()<f.n_nodes())
+    self.checkfunction(fc,f,inputs=[[1.1,0.7],-0.3])
+
+  def test_cse_constants(self):
+    x = MX.sym("x",2)
+
+    # Equal constants are merged, even when created separately
+    e = [x*DM([1.5,2.5]) for i in range(20)]
+    self.assertTrue(n_nodes(vertcat(*cse(e)))<n_nodes(vertcat(*e)))
+
+    # Zero and negative zero are kept apart
+    e = cse([1/(x*DM([1.5,0.0])), 1/(x*DM([1.5,-0.0]))])
+    f = Function("f",[x],e)
+    r = f(DM([1,1]))
+    self.assertTrue(float(r[0][1])>0)
+    self.assertTrue(float(r[1][1])<0)
+
 if __name__ == '__main__':
     unittest.main()
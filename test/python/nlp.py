@@ -1236,6 +1236,23 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver_out["x"],DM([0]),digits=7)
       if "bonmin" not in str(Solver): self.checkarray(solver_out["lam_x"],DM([0]),digits=7)
 
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("admm")
+  def test_sqpmethod_codegen(self):
+    x=SX.sym("x",3)
+    p=SX.sym("p")
+    nlp={'x':x, 'p':p, 'f':(x[0]-1)**2+100*(x[1]-x[0]**2)**2+(x[2]-p)**2,
+         'g':vertcat(x[0]+x[1]+x[2], x[0]**2+x[2]**2)}
+    qpsol_options = {"warm_start": False, "eps_abs": 1e-12, "eps_rel": 1e-12, "max_iter": 20000}
+    for opts in [{}, {"regularize": True}, {"max_iter_ls": 0},
+                 {"hessian_approximation": "limited-memory", "lbfgs_memory": 4}]:
+      opts = dict(opts)
+      opts["qpsol"] = "admm"
+      opts["qpsol_options"] = qpsol_options
+      solver = nlpsol("solver", "sqpmethod", nlp, opts)
+      self.check_codegen(solver, inputs=[[0.5,0.5,0.5],0.3,[-2,-2,-2],[2,0.8,2],[-1,0],[1.5,2],
+                                           [0,0,0],[0,0]])
+
 if __name__ == '__main__':
     unittest.main()
     print(solvers)
@@ -1300,5 +1300,53 @@ class SXtests(casadiTestCase):
       self.checkfunction(f,fa,inputs=[3])
       self.checkfunction(f,fb,inputs=[-3],evals=1)
 
+  def test_bytecode(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p")
+    e = vertcat(x[0]*x[1]+x[2], 3*sin(x[0])-p, fmin(x[2],2)*x[1]+p, x[0]*p)
+
+    f = Function("f",[x,p],[e,dot(x,x)])
+    fb = Function("f",[x,p],[e,dot(x,x)],{"bytecode":True})
+
+    self.checkfunction(fb,f,inputs=[[1.1,-0.3,2.7],0.7])
+    self.assertTrue(fb.sparsity_jac(0,0)==f.sparsity_jac(0,0))
+    self.assertTrue(fb.sparsity_jac(1,0)==f.sparsity_jac(1,0))
+
+  def test_cse(self):
+    x = SX.sym("x")
+    y = SX.sym("y")
+    e = [sin(x*y)+cos(x*y), sin(y*x)*2, 3+sin(x*y)]
+
+    self.assertTrue(n_nodes(vertcat(*e))>n_nodes(vertcat(*cse(e))))
+    self.assertEqual(n_nodes(cse(sin(x*y)+sin(y*x))), 5)
+
+    f = Function("f",[x,y],e)
+    fc = Function("f",[x,y],e,{"cse":True})
+    self.assertTrue(fc.n_nodes()<f.n_nodes())
+    self.checkfunction(fc,f,inputs=[1.1,-0.3])
+
+  def test_min_live(self):
+    x = SX.sym("x",10)
+    e = x
+    for k in range(5):
+      e = sin(e+mtimes(DM.ones(10,10),cos(e)))
+    e = [jacobian(e,x), e[0]*e[1]]
+
+    f = Function("f",[x],e)
+    fm = Function("f",[x],e,{"min_live":True})
+    self.assertTrue(fm.sz_w()<=f.sz_w())
+    self.checkfunction(fm,f,inputs=[DM(range(10))*0.1])
+
+    # Reduction tree: depth-first sorting keeps all leaves alive
+    y = SX.sym("y",64)
+    l = [sin(y[i])*cos(y[63-i]) for i in range(64)]
+    while len(l)>1:
+      l = [l[i]*l[i+1]+l[i] for i in range(0,len(l),2)]
+    g = Function("g",[y],[l[0]])
+    gm = Function("g",[y],[l[0]],{"min_live":True})
+    self.assertTrue(gm.sz_w()<g.sz_w()/2)
+    y0 = DM([0.5+0.01*i for i in range(64)])
+    self.assertEqual(float(gm(y0)),float(g(y0)))
+
 if __name__ == '__main__':
     unittest.main()